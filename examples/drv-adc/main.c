@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Sample ADC0 and ADC1 in the background: timer0 compare match A triggers a
+ * conversion every 500us, 4 conversions of each channel are averaged per
+ * sample (250 frames per second) and the main thread processes blocks of
+ * 50 frames.
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/adc.h>
+#include <avrtos/drivers/timer.h>
+
+#define FRAMES_PER_BLOCK 50u
+
+static const uint8_t channels[] = {ADC_CHANNEL(0u), ADC_CHANNEL(1u)};
+
+#define CHANNELS_COUNT ARRAY_SIZE(channels)
+#define BLOCK_LEN	   (FRAMES_PER_BLOCK * CHANNELS_COUNT)
+
+static uint16_t samples[2u * BLOCK_LEN];
+
+static struct adc_sequence seq = {
+	.channels		= channels,
+	.channels_count = CHANNELS_COUNT,
+	.trigger		= ADC_TRIGGER_TIMER0_COMPA,
+	.oversampling	= 2u, /* 4 conversions */
+	.buf			= samples,
+	.block_len		= BLOCK_LEN,
+};
+
+int main(void)
+{
+	serial_init();
+
+	const struct adc_config adc_cfg = {
+		.reference = ADC_REFERENCE_AVCC,
+		.prescaler = ADC_PRESCALER_128,
+	};
+	adc_init(&adc_cfg);
+
+	adc_sequence_start(&seq);
+
+	/* 2kHz trigger, compare match interrupt disabled */
+	const struct timer_config timer_cfg = {
+		.mode	   = TIMER_MODE_CTC,
+		.prescaler = TIMER_PRESCALER_64,
+		.counter   = TIMER_CALC_COUNTER_VALUE(500u, 64u),
+		.timsk	   = 0u,
+	};
+	ll_timer8_init(TIMER0_DEVICE, TIMER0_INDEX, &timer_cfg);
+
+	for (;;) {
+		uint16_t *block;
+
+		if (adc_sequence_block_get(&seq, &block, K_SECONDS(1)) != 0) {
+			printf_P(PSTR("No samples\n"));
+			continue;
+		}
+
+		uint32_t sum[CHANNELS_COUNT] = {0u};
+		for (uint16_t i = 0u; i < BLOCK_LEN; i += CHANNELS_COUNT) {
+			for (uint8_t c = 0u; c < CHANNELS_COUNT; c++) {
+				sum[c] += block[i + c];
+			}
+		}
+
+		adc_sequence_block_release(&seq);
+
+		printf_P(PSTR("ADC0: %u ADC1: %u (overruns: %u)\n"),
+				 (uint16_t)(sum[0u] / FRAMES_PER_BLOCK),
+				 (uint16_t)(sum[1u] / FRAMES_PER_BLOCK), seq.overruns);
+	}
+}
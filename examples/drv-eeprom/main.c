@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Persist a boot counter and a minutes counter in wear leveled records, the
+ * saves are programmed from the EEPROM interrupt without blocking the thread.
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/eeprom.h>
+
+struct counters {
+	uint16_t boots;
+	uint32_t minutes;
+};
+
+static struct counters counters = {
+	.boots	 = 0u,
+	.minutes = 0u,
+};
+
+/* 16 slots of 8 bytes, the endurance of the record is 16 * 100000 saves */
+static struct eeprom_record rec = {
+	.addr  = 0x0000u,
+	.size  = sizeof(counters),
+	.depth = 16u,
+	.cache = &counters,
+};
+
+int main(void)
+{
+	serial_init();
+
+	if (eeprom_record_init(&rec) != 0) {
+		printf_P(PSTR("No counters stored\n"));
+	}
+
+	counters.boots++;
+	eeprom_record_save(&rec);
+
+	printf_P(PSTR("boots: %u minutes: %lu\n"), counters.boots, counters.minutes);
+
+	for (;;) {
+		k_sleep(K_SECONDS(60));
+
+		struct counters update = counters;
+		update.minutes++;
+
+		if (eeprom_record_set(&rec, &update) == 0) {
+			printf_P(PSTR("minutes: %lu\n"), counters.minutes);
+		}
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/devices/sensor.h>
+#include <avrtos/devices/tcn75.h>
+#include <avrtos/drivers/i2c.h>
+#include <avrtos/misc/serial.h>
+
+#define I2C_DEVICE I2C0_DEVICE
+
+/* Two TCN75A on the same bus, read at different rates */
+#define TCN75A_ADDR_LSb_0 0b001
+#define TCN75A_ADDR_LSb_1 0b010
+
+K_MSGQ_DEFINE(samples, sizeof(struct sensor_sample), 8u);
+
+static struct sensor_bus bus;
+static struct tcn75_device tcn75[2u];
+static struct sensor sensors[2u];
+
+int main(void)
+{
+	serial_init();
+
+	int8_t ret = i2c_init(I2C_DEVICE, I2C_CONF_400000);
+	printf("i2c_init: %d\n", ret);
+
+	ret = sensor_bus_init(&bus, I2C_DEVICE);
+	printf("sensor_bus_init: %d\n", ret);
+
+	tcn75_init_context(&tcn75[0u], TCN75A_ADDR_LSb_0, TCN75_DEFAULT_CONFIG, I2C_DEVICE);
+	tcn75_init_context(&tcn75[1u], TCN75A_ADDR_LSb_1, TCN75_DEFAULT_CONFIG, I2C_DEVICE);
+
+	for (uint8_t i = 0u; i < ARRAY_SIZE(tcn75); i++) {
+		ret = tcn75_configure(&tcn75[i]);
+		printf("tcn75_configure %u: %d\n", i, ret);
+	}
+
+	tcn75_sensor_init(&sensors[0u], &tcn75[0u], K_MSEC(500), &samples);
+	tcn75_sensor_init(&sensors[1u], &tcn75[1u], K_MSEC(2000), &samples);
+
+	/* Smooth the first sensor over ~4 samples */
+	sensors[0u].filter = 2u;
+
+	for (uint8_t i = 0u; i < ARRAY_SIZE(sensors); i++) {
+		ret = sensor_register(&bus, &sensors[i]);
+		printf("sensor_register %u: %d\n", i, ret);
+	}
+
+	struct sensor_sample sample;
+
+	for (;;) {
+		k_msgq_get(&samples, &sample, K_FOREVER);
+
+		printf("[%lu] sensor %u: %d (errors: %u overruns: %u)\n", sample.timestamp,
+			   (unsigned int)(sample.sensor - sensors), sample.value,
+			   sample.sensor->errors, sample.sensor->overruns);
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Two threads read the temperature and the configuration register of a TCN75A
+ * with queued I2C transactions (register pointer write, repeated start, read),
+ * each thread sleeps while its transaction is transferred.
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/i2c.h>
+
+#define TCN75A_ADDR 0x49u
+
+#define TCN75A_REG_TEMP	  0x00u
+#define TCN75A_REG_CONFIG 0x01u
+
+static int8_t read_reg(uint8_t reg, uint8_t *data, uint8_t len)
+{
+	struct i2c_msg msgs[2u] = {
+		{.buf = &reg, .len = 1u, .flags = I2C_MSG_WRITE},
+		{.buf = data, .len = len, .flags = I2C_MSG_READ},
+	};
+	struct i2c_transaction xfer = {
+		.addr	  = TCN75A_ADDR,
+		.msgs	  = msgs,
+		.num_msgs = ARRAY_SIZE(msgs),
+	};
+
+	return i2c_transaction_transceive(I2C0_DEVICE, &xfer);
+}
+
+static void temp_thread(void *arg)
+{
+	uint8_t temp[2u];
+
+	for (;;) {
+		const int8_t ret = read_reg(TCN75A_REG_TEMP, temp, sizeof(temp));
+		printf_P(PSTR("temp: %d raw: %02x%02x\n"), ret, temp[0u], temp[1u]);
+
+		k_sleep(K_MSEC(500u));
+	}
+}
+
+K_THREAD_DEFINE(temp, temp_thread, 0x100, K_PREEMPTIVE, NULL, 'T');
+
+int main(void)
+{
+	serial_init();
+
+	i2c_init(I2C0_DEVICE, I2C_CONF_100000);
+
+	uint8_t config;
+
+	for (;;) {
+		const int8_t ret = read_reg(TCN75A_REG_CONFIG, &config, sizeof(config));
+		printf_P(PSTR("config: %d raw: %02x\n"), ret, config);
+
+		k_sleep(K_MSEC(1000u));
+	}
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Three buttons on PB0, PB1 and PB2 (active low, internal pull-ups), handled
+ * by the PCINT dispatcher: each button is debounced and sets its own bit in
+ * the flags on press.
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/exti.h>
+#include <avrtos/drivers/gpio.h>
+#include <avrtos/misc/led.h>
+
+#define BUTTONS_COUNT 3u
+
+K_FLAGS_DEFINE(buttons_flags, 0u);
+
+static void button_cb(struct pcint_pin *pin, uint8_t level)
+{
+	ARG_UNUSED(pin);
+	ARG_UNUSED(level);
+
+	led_toggle();
+}
+
+static struct pcint_pin buttons[BUTTONS_COUNT];
+
+int main(void)
+{
+	serial_init();
+
+	led_init();
+	led_off();
+
+	for (uint8_t i = 0u; i < BUTTONS_COUNT; i++) {
+		gpiol_pin_init(GPIOB, PIN0 + i, GPIO_INPUT, GPIO_INPUT_PULLUP);
+
+		buttons[i] = (struct pcint_pin){
+			.pci		= i, /* PCINT0 to PCINT2 */
+			.edges		= PCINT_EDGE_FALLING,
+			.callback	= button_cb,
+			.flags		= &buttons_flags,
+			.flags_mask = BIT(i),
+			.debounce	= K_MSEC(20),
+		};
+		pcint_pin_register(&buttons[i]);
+	}
+
+	for (;;) {
+		k_flags_value_t mask = BIT(BUTTONS_COUNT) - 1u;
+		k_flags_poll(&buttons_flags, &mask, K_FLAGS_SET_ANY | K_FLAGS_CONSUME,
+					 K_FOREVER);
+
+		for (uint8_t i = 0u; i < BUTTONS_COUNT; i++) {
+			if (mask & BIT(i)) {
+				k_show_uptime();
+				printf_P(PSTR("Button %u pressed\n"), i);
+			}
+		}
+	}
+}
@@ -13,6 +13,14 @@
 
 static struct mcp2515_device mcp;
 
+#if CONFIG_MCP2515_INTERRUPT
+K_MSGQ_DEFINE(can_rx_msgq, sizeof(struct can_frame), 8u);
+
+ISR(INT0_vect)
+{
+	mcp2515_irq_handler(&mcp);
+}
+#else
 K_SEM_DEFINE(can_int_sem, 0u, 10u);
 
 ISR(INT0_vect)
@@ -20,6 +28,7 @@ ISR(INT0_vect)
 	serial_transmit('!');
 	k_yield_from_isr_cond(k_sem_give(&can_int_sem));
 }
+#endif
 
 static void print_can_frame(struct can_frame *frame)
 {
@@ -77,17 +86,30 @@ int main(void)
 
 	gpio_pin_init(GPIOD_DEVICE, 2u, GPIO_MODE_INPUT, GPIO_INPUT_PULLUP);
 
+#if CONFIG_MCP2515_INTERRUPT
+	mcp2515_irq_enable(&mcp, INT0, &can_rx_msgq);
+#else
 	exti_clear_flag(INT0);
 	exti_configure(INT0, ISC_FALLING);
 	exti_enable(INT0);
+#endif
 
 	for (;;) {
 		struct can_frame frame = {0};
 
+#if CONFIG_MCP2515_INTERRUPT
+		int8_t ret = k_msgq_get(&can_rx_msgq, &frame, K_FOREVER);
+
+		struct mcp2515_stats stats;
+		mcp2515_get_stats(&mcp, &stats, false);
+		printf("k_msgq_get: %d (frames: %u queue overruns: %u hw overruns: %u)\n",
+			   ret, stats.rx_frames, stats.rx_queue_overruns, stats.rx_hw_overruns);
+#else
 		k_sem_take(&can_int_sem, K_FOREVER);
 
 		int8_t ret = mcp2515_recv(&mcp, &frame);
 		printf("mcp2515_recv: %d\n", ret);
+#endif
 
 		if (ret == 0) {
 			print_can_frame(&frame);
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Read two channels of an MCP3008 (CS on PB0) with queued SPI transactions,
+ * the main thread sleeps while both conversions are transceived back to back.
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/gpio.h>
+#include <avrtos/drivers/spi.h>
+
+#define CHANNELS 2u
+
+K_SEM_DEFINE(done_sem, 0u, CHANNELS);
+
+int main(void)
+{
+	serial_init();
+
+	const struct spi_config cfg = {
+		.role		 = SPI_ROLE_MASTER,
+		.polarity	 = SPI_CLOCK_POLARITY_RISING,
+		.phase		 = SPI_CLOCK_PHASE_SAMPLE,
+		.prescaler	 = SPI_PRESCALER_X32,
+		.irq_enabled = 0u,
+	};
+	spi_init(cfg);
+
+	struct spi_regs regs = spi_config_into_regs(cfg);
+	struct spi_slave mcp3008;
+	spi_slave_init(&mcp3008, GPIOB, PIN0, GPIO_LOW, &regs);
+	spi_slave_ss_init(&mcp3008);
+
+	uint8_t bufs[CHANNELS][3u];
+	struct spi_transaction xfers[CHANNELS];
+
+	for (;;) {
+		for (uint8_t ch = 0u; ch < CHANNELS; ch++) {
+			/* start bit, single-ended, channel */
+			bufs[ch][0u] = 0x1u;
+			bufs[ch][1u] = BIT(7u) | (ch << 4u);
+			bufs[ch][2u] = 0x0u;
+
+			xfers[ch] = (struct spi_transaction){
+				.slave	= &mcp3008,
+				.tx_buf = bufs[ch],
+				.rx_buf = bufs[ch],
+				.len	= sizeof(bufs[ch]),
+				.sem	= &done_sem,
+			};
+			spi_transaction_submit(&xfers[ch]);
+		}
+
+		for (uint8_t ch = 0u; ch < CHANNELS; ch++) {
+			k_sem_take(&done_sem, K_FOREVER);
+		}
+
+		for (uint8_t ch = 0u; ch < CHANNELS; ch++) {
+			const uint16_t value = ((bufs[ch][1u] & 0x3u) << 8u) | bufs[ch][2u];
+			printf_P(PSTR("CH%u: %u\t"), ch, value);
+		}
+		printf_P(PSTR("\n"));
+
+		k_sleep(K_MSEC(100u));
+	}
+}
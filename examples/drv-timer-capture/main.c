@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the frequency and the duty cycle of a signal on ICP1 (PB0 on
+ * ATmega328P, PD4 on ATmega2560) with the input capture of timer1.
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/gpio.h>
+#include <avrtos/drivers/timer.h>
+
+#define CAPTURES_COUNT 8u
+
+static uint32_t captures_buf[CAPTURES_COUNT];
+
+static struct timer_capture capture = {
+	.buf	   = captures_buf,
+	.size	   = CAPTURES_COUNT,
+	.edge	   = TIMER_CAPTURE_EDGE_BOTH,
+	.prescaler = TIMER_PRESCALER_8,
+};
+
+int main(void)
+{
+	serial_init();
+
+#if defined(__AVR_ATmega2560__)
+	gpiol_pin_init(GPIOD, 4u, GPIO_INPUT, GPIO_INPUT_NO_PULLUP);
+#else
+	gpiol_pin_init(GPIOB, 0u, GPIO_INPUT, GPIO_INPUT_NO_PULLUP);
+#endif
+
+	timer_capture_start(TIMER1_INDEX, &capture);
+
+	for (;;) {
+		uint32_t freq_mhz;
+		uint16_t duty;
+
+		/* Two edges of the same kind and one of the other */
+		if (timer_capture_wait(&capture, 3u, K_SECONDS(1)) != 0) {
+			printf_P(PSTR("No signal\n"));
+			continue;
+		}
+
+		if ((timer_capture_frequency(&capture, &freq_mhz) == 0) &&
+			(timer_capture_duty_cycle(&capture, &duty) == 0)) {
+			printf_P(PSTR("freq: %lu.%03lu Hz duty: %u permille (overruns: %u)\n"),
+					 freq_mhz / 1000u, freq_mhz % 1000u, duty, capture.overruns);
+		}
+
+		timer_capture_flush(&capture);
+		k_sleep(K_MSEC(500));
+	}
+}
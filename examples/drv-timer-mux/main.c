@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/timer.h>
+#include <avrtos/misc/led.h>
+#include <avrtos/misc/serial.h>
+
+/* Timer 1 counts at 2MHz (prescaler 8) */
+#define MUX_TIMER	  1u
+#define MUX_PRESCALER 8u
+
+struct client {
+	struct timer_alarm alarm;
+	uint32_t period;
+	uint32_t count;
+};
+
+static struct timer_mux mux;
+
+static void alarm_handler(struct timer_alarm *alarm)
+{
+	struct client *const client = CONTAINER_OF(alarm, struct client, alarm);
+
+	client->count++;
+
+	/* Next expiration relative to the previous deadline, without drift */
+	timer_alarm_forward(&mux, alarm, client->period);
+}
+
+static void led_handler(struct timer_alarm *alarm)
+{
+	led_toggle();
+
+	timer_alarm_forward(&mux, alarm, TIMER_US_TO_COUNTS(250000u, MUX_PRESCALER));
+}
+
+static struct client clients[] = {
+	{.period = TIMER_US_TO_COUNTS(500u, MUX_PRESCALER)},
+	{.period = TIMER_US_TO_COUNTS(1500u, MUX_PRESCALER)},
+	{.period = TIMER_US_TO_COUNTS(20000u, MUX_PRESCALER)},
+};
+
+static struct timer_alarm led_alarm = TIMER_ALARM_INIT(led_handler);
+
+int main(void)
+{
+	serial_init();
+	led_init();
+
+	/* The sysclock timer is reserved by the kernel */
+	printf("sysclock res: %x\n", timer_alloc_get(CONFIG_KERNEL_SYSLOCK_HW_TIMER));
+
+	int8_t ret = timer_mux_start(MUX_TIMER, &mux, TIMER_PRESCALER_8);
+	printf("timer_mux_start: %d res: %x\n", ret, timer_alloc_get(MUX_TIMER));
+
+	/* Channel B of the multiplexed timer is still available */
+	ret = timer_alloc(MUX_TIMER, TIMER_RES_CHANNEL_B);
+	printf("timer_alloc B: %d res: %x\n", ret, timer_alloc_get(MUX_TIMER));
+
+	/* The counter is already owned by the multiplexer */
+	ret = timer_alloc(MUX_TIMER, TIMER_RES_COUNTER);
+	printf("timer_alloc counter: %d\n", ret);
+
+	for (uint8_t i = 0u; i < ARRAY_SIZE(clients); i++) {
+		timer_alarm_init(&clients[i].alarm, alarm_handler);
+		timer_alarm_start(&mux, &clients[i].alarm, clients[i].period);
+	}
+
+	timer_alarm_start(&mux, &led_alarm, 0u);
+
+	for (;;) {
+		k_sleep(K_SECONDS(1));
+
+		const uint8_t key = irq_lock();
+		const uint32_t c0 = clients[0u].count;
+		const uint32_t c1 = clients[1u].count;
+		const uint32_t c2 = clients[2u].count;
+		irq_unlock(key);
+
+		printf("now: %lu counts: %lu %lu %lu\n", timer_mux_now(&mux), c0, c1, c2);
+	}
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/gpio.h>
+#include <avrtos/drivers/timer.h>
+#include <avrtos/misc/serial.h>
+
+#define RAMP_STEPS 32u
+#define PWM_TOP	   0x3FFu
+
+#define TIMERS (BIT(1u) | BIT(3u))
+
+static struct timer_pwm pwm1;
+static struct timer_pwm pwm3;
+
+static uint16_t ramp[2u * RAMP_STEPS];
+
+/* OC1A fades in while OC1B fades out */
+static const struct timer_pwm_waveform fade = {
+	.table	  = ramp,
+	.steps	  = RAMP_STEPS,
+	.channels = BIT(TIMER_CHANNEL_A) | BIT(TIMER_CHANNEL_B),
+	.periods  = 8u,
+	.loop	  = 1u,
+};
+
+int main(void)
+{
+	serial_init();
+
+	for (uint8_t i = 0u; i < RAMP_STEPS; i++) {
+		const uint16_t v  = (PWM_TOP * i) / (RAMP_STEPS - 1u);
+		ramp[2u * i]	  = v;
+		ramp[2u * i + 1u] = PWM_TOP - v;
+	}
+
+	/* OC1A-C (PB5-7), OC3A-C (PE3-5) */
+	for (uint8_t pin = 5u; pin <= 7u; pin++) {
+		gpiol_pin_init(GPIOB, pin, GPIO_MODE_OUTPUT, GPIO_OUTPUT_DRIVEN_LOW);
+	}
+	for (uint8_t pin = 3u; pin <= 5u; pin++) {
+		gpiol_pin_init(GPIOE, pin, GPIO_MODE_OUTPUT, GPIO_OUTPUT_DRIVEN_LOW);
+	}
+
+	const struct timer_pwm_config config = {
+		.mode	   = TIMER_MODE_FAST_PWM_10bit,
+		.prescaler = TIMER_PRESCALER_64,
+		.com	   = {TIMER_CHANNEL_COMP_MODE_CLEAR, TIMER_CHANNEL_COMP_MODE_CLEAR,
+					  TIMER_CHANNEL_COMP_MODE_CLEAR},
+		.duty	   = {0u, 0u, 0u},
+	};
+
+	timer_pwm_start(1u, &pwm1, &config);
+	timer_pwm_start(3u, &pwm3, &config);
+
+	/* Both timers count in phase */
+	timer_pwm_sync(TIMERS);
+
+	/* Replayed by the timer 1 interrupt, without any thread */
+	timer_pwm_waveform_start(1u, &fade);
+
+	uint16_t duty = 0u;
+
+	for (;;) {
+		/* OC1C and OC3A-C change at the same PWM period */
+		timer_pwm_stage(1u, TIMER_CHANNEL_C, duty);
+		timer_pwm_stage(3u, TIMER_CHANNEL_A, duty);
+		timer_pwm_stage(3u, TIMER_CHANNEL_B, duty / 2u);
+		timer_pwm_stage(3u, TIMER_CHANNEL_C, PWM_TOP - duty);
+		timer_pwm_commit(TIMERS);
+
+		printf("duty: %u\n", duty);
+
+		duty = (duty + 0x80u) & PWM_TOP;
+
+		k_sleep(K_MSEC(500u));
+	}
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// For ATmega328PB or ATmega2560
+
+#include <ctype.h>
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/usart.h>
+#include <avrtos/misc/serial.h>
+
+#include <avr/pgmspace.h>
+
+#define K_MODULE K_MODULE_APPLICATION
+
+static uint8_t rx_buf[32u];
+static uint8_t tx_buf[64u];
+
+static const char hello[] = "Type something, it will be echoed in uppercase\r\n";
+
+int main(void)
+{
+	serial_init();
+
+	const struct usart_config cfg = USART_CONFIG_DEFAULT_115200();
+	usart_buffered_init(USART1_DEVICE, &cfg, rx_buf, sizeof(rx_buf), tx_buf,
+						sizeof(tx_buf));
+
+	usart_write(USART1_DEVICE, hello, sizeof(hello) - 1u, K_FOREVER);
+
+	char line[16u];
+
+	for (;;) {
+		/* Read a chunk, return after 50 ms of silence */
+		int len = usart_read(USART1_DEVICE, line, sizeof(line), K_MSEC(50));
+
+		if (len > 0) {
+			for (uint8_t i = 0u; i < len; i++) {
+				line[i] = toupper(line[i]);
+			}
+			usart_write(USART1_DEVICE, line, len, K_FOREVER);
+		} else {
+			struct usart_buffered_stats stats;
+			usart_buffered_get_stats(USART1_DEVICE, &stats, false);
+
+			printf_P(PSTR("[%lu ms] rx_overruns=%u hw_overruns=%u errors=%u\n"),
+					 k_uptime_get_ms32(), stats.rx_overruns, stats.hw_overruns,
+					 stats.errors);
+			k_sleep(K_SECONDS(1));
+		}
+	}
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/gpio.h>
+#include <avrtos/misc/serial.h>
+
+/* Pulse train period (PB7) */
+#define PULSE_HALF_PERIOD_US 150u
+
+/* Delay between two toggles of PB6 by the thread */
+#define SLEEP_US 2500u
+
+static void pulse_handler(struct k_hrtimer *timer)
+{
+	gpiol_pin_toggle(GPIOB_DEVICE, PIN7);
+
+	/* Next edge relative to the previous deadline, latency does not accumulate */
+	k_hrtimer_forward(timer, PULSE_HALF_PERIOD_US);
+}
+
+K_HRTIMER_DEFINE(pulse_timer, pulse_handler);
+
+int main(void)
+{
+	serial_init();
+
+	gpiol_pin_init(GPIOB_DEVICE, PIN7, GPIO_OUTPUT, GPIO_OUTPUT_DRIVEN_LOW);
+	gpiol_pin_init(GPIOB_DEVICE, PIN6, GPIO_OUTPUT, GPIO_OUTPUT_DRIVEN_LOW);
+
+	k_hrtimer_start(&pulse_timer, PULSE_HALF_PERIOD_US);
+
+	for (;;) {
+		gpiol_pin_toggle(GPIOB_DEVICE, PIN6);
+		k_hrtimer_sleep_us(SLEEP_US);
+	}
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/misc/led.h>
+#include <avrtos/misc/serial.h>
+
+#include <util/delay.h>
+
+#define PERIOD_MS 10u
+
+void thread_control(void *arg);
+
+K_THREAD_DEFINE(control, thread_control, 0x100, K_PREEMPTIVE, NULL, 'C');
+
+void thread_control(void *arg)
+{
+	uint16_t iterations = 0u;
+	struct k_periodic periodic;
+
+	k_periodic_init(&periodic, K_MSEC(PERIOD_MS));
+
+	for (;;) {
+		k_periodic_wait(&periodic);
+
+		led_toggle();
+
+		/* Variable work duration, does not shift the next releases */
+		_delay_ms(iterations % 5u);
+
+		/* Every 100 iterations, the work exceeds the period */
+		if (iterations % 100u == 99u) {
+			_delay_ms(3u * PERIOD_MS);
+		}
+
+		if (++iterations % 100u == 0u) {
+			printf_P(PSTR("uptime: %lu ms, overruns: %u\n"), k_uptime_get_ms32(),
+					 periodic.overruns);
+		}
+	}
+}
+
+int main(void)
+{
+	serial_init();
+	led_init();
+
+	k_sleep(K_FOREVER);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * No kernel deadline is pending while the main thread waits for the button on
+ * PB0 (active low), the idle thread enters the power-down mode and the pin
+ * change interrupt wakes up the MCU. Each press prints the sleep statistics,
+ * the interrupt driven stdio buffer keeps the MCU in IDLE mode until the last
+ * character is sent.
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/drivers/exti.h>
+#include <avrtos/drivers/gpio.h>
+
+K_FLAGS_DEFINE(button_flags, 0u);
+
+static struct pcint_pin button = {
+	.pci		= 0u, /* PCINT0 */
+	.edges		= PCINT_EDGE_FALLING,
+	.flags		= &button_flags,
+	.flags_mask = BIT(0u),
+};
+
+int main(void)
+{
+	struct k_pm_stats stats;
+
+	serial_init();
+
+	gpiol_pin_init(GPIOB, PIN0, GPIO_INPUT, GPIO_INPUT_PULLUP);
+	pcint_pin_register(&button);
+
+	for (;;) {
+		k_flags_value_t mask = BIT(0u);
+		k_flags_poll(&button_flags, &mask, K_FLAGS_SET_ANY | K_FLAGS_CONSUME,
+					 K_FOREVER);
+
+		k_pm_stats_get(&stats, false);
+
+		for (uint8_t mode = 0u; mode < K_PM_MODES_COUNT; mode++) {
+			printf_P(PSTR("mode %u: entered %lu times\n"), mode, stats.entries[mode]);
+		}
+		printf_P(PSTR("idle: %lu ticks\n"), stats.idle_ticks);
+	}
+}
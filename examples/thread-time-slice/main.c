@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <avrtos/avrtos.h>
+#include <avrtos/misc/serial.h>
+
+static volatile uint32_t counters[2u];
+
+static void thread_entry(void *arg)
+{
+	volatile uint32_t *const counter = arg;
+
+	for (;;) {
+		(*counter)++;
+	}
+}
+
+/* Throughput thread, preempted every 20 ms */
+K_THREAD_DEFINE_TIME_SLICE(
+	throughput, thread_entry, 0x80, K_PREEMPTIVE, (void *)&counters[0u], 'T', 20u);
+
+/* Interactive thread, preempted every kernel time slice (1 ms) */
+K_THREAD_DEFINE(interactive, thread_entry, 0x80, K_PREEMPTIVE, (void *)&counters[1u], 'R');
+
+int main(void)
+{
+	serial_init();
+
+	for (;;) {
+		k_sleep(K_SECONDS(1));
+
+		const uint8_t key = irq_lock();
+		const uint32_t t  = counters[0u];
+		const uint32_t i  = counters[1u];
+		irq_unlock(key);
+
+		printf_P(PSTR("throughput: %lu interactive: %lu\n"), t, i);
+	}
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Two threads check in their watchdog channel, thread 'B' hangs after a few
+ * seconds: the hardware watchdog is no longer reset and the MCU restarts,
+ * the expired thread is printed after the reset.
+ */
+
+#include <avrtos/avrtos.h>
+
+static void thread_entry(void *arg);
+
+K_THREAD_DEFINE(thread_a, thread_entry, 0x100, K_PREEMPTIVE, (void *)0u, 'A');
+K_THREAD_DEFINE(thread_b, thread_entry, 0x100, K_PREEMPTIVE, (void *)5u, 'B');
+
+static void thread_entry(void *arg)
+{
+	const uint16_t hang_after = (uint16_t)arg;
+	struct k_watchdog_channel channel;
+
+	k_watchdog_register(&channel, K_MSEC(200));
+
+	for (uint16_t i = 1u;; i++) {
+		k_sleep(K_MSEC(100));
+
+		if (hang_after && (i >= hang_after * 10u)) {
+			printf_P(PSTR("%c hangs\n"), k_thread_get_current()->symbol);
+			for (;;) {
+				k_sleep(K_SECONDS(1));
+			}
+		}
+
+		k_watchdog_feed(&channel);
+	}
+}
+
+int main(void)
+{
+	struct k_watchdog_record record;
+
+	serial_init();
+
+	if (k_watchdog_last_expired(&record)) {
+		printf_P(PSTR("Reset by the watchdog, thread %c (%p) expired\n"),
+				 record.symbol, record.thread);
+	}
+
+	k_thread_dump_all();
+
+	k_stop();
+}
@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+
+# Decode the binary records of the deferred logging (CONFIG_LOGGING_DEFERRED)
+# back into text, format strings are read from the ELF file of the application.
+#
+# Bytes which are not part of a record (e.g. printf output) are printed as is.
+#
+# Usage:
+#   python3 scripts/log_decoder.py app.elf --port /dev/ttyACM0 --baudrate 115200
+#   python3 scripts/log_decoder.py app.elf --input capture.bin
+#
+# Record format (little endian), see src/avrtos/logging.h:
+#   0xA5 | len | flags | fmt (2) | [ticks (4)] | payload
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_SYNC = 0xA5
+FLAGS_LEVEL_MSK = 0x07
+FLAGS_TICKS = 0x08
+FLAGS_TYPE_MSK = 0x30
+TYPE_MSG = 0x00
+TYPE_HEXDUMP = 0x10
+TYPE_DROPPED = 0x20
+
+LEVELS = {1: "ERR", 2: "WRN", 3: "INF", 4: "DBG"}
+
+# AVR data addresses are offset by 0x800000 in the ELF file
+AVR_DATA_OFFSET = 0x800000
+
+SHF_ALLOC = 0x2
+SHT_PROGBITS = 0x1
+
+FMT_SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l)?([diouxXcsSpfeEgG%])")
+
+
+class Elf:
+    """Minimal ELF32 little endian reader, only loads flash sections"""
+
+    def __init__(self, path: str):
+        with open(path, "rb") as f:
+            data = f.read()
+
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError(f"{path}: not an ELF32 little endian file")
+
+        e_shoff, = struct.unpack_from("<I", data, 0x20)
+        e_shentsize, e_shnum = struct.unpack_from("<HH", data, 0x2E)
+
+        self.sections = []
+        for i in range(e_shnum):
+            sh = struct.unpack_from("<IIIIIIIIII", data, e_shoff + i * e_shentsize)
+            sh_type, sh_flags, sh_addr, sh_offset, sh_size = sh[1], sh[2], sh[3], sh[4], sh[5]
+            if sh_type == SHT_PROGBITS and sh_flags & SHF_ALLOC and sh_addr < AVR_DATA_OFFSET:
+                self.sections.append((sh_addr, data[sh_offset:sh_offset + sh_size]))
+
+    def read_string(self, addr: int) -> str:
+        for base, content in self.sections:
+            if base <= addr < base + len(content):
+                end = content.find(b"\0", addr - base)
+                return content[addr - base:end].decode("ascii", errors="replace")
+        return f"<unknown string @0x{addr:04x}>"
+
+
+def format_message(elf: Elf, fmt: str, payload: bytes) -> str:
+    out = ""
+    pos = 0
+    off = 0
+
+    def pop(size: int, signed: bool = False) -> int:
+        nonlocal off
+        value = int.from_bytes(payload[off:off + size], "little", signed=signed)
+        off += size
+        return value
+
+    for m in FMT_SPEC.finditer(fmt):
+        out += fmt[pos:m.start()]
+        pos = m.end()
+
+        flags, width, precision, length, conv = m.groups()
+        if conv == "%":
+            out += "%"
+            continue
+
+        if width == "*":
+            width = str(pop(2, True))
+        if precision == "*":
+            precision = str(pop(2, True))
+        spec = "%" + flags + (width or "") + ("." + precision if precision else "")
+
+        if conv in "fFeEgG":
+            value, = struct.unpack("<f", payload[off:off + 4])
+            off += 4
+            out += (spec + conv) % value
+        elif conv == "S":
+            out += (spec + "s") % elf.read_string(pop(2))
+        elif conv == "s":
+            # RAM strings cannot be retrieved from the ELF file
+            out += (spec + "s") % f"<ram@0x{pop(2):04x}>"
+        elif conv == "p":
+            out += f"0x{pop(2):04x}"
+        elif conv == "c":
+            out += (spec + "c") % chr(pop(2) & 0xFF)
+        else:
+            size = {"ll": 8, "l": 4}.get(length, 2)
+            out += (spec + conv.replace("i", "d")) % pop(size, conv in "di")
+
+    return out + fmt[pos:]
+
+
+def decode_record(elf: Elf, record: bytes, tick_us: int) -> str:
+    flags = record[0]
+    fmt_addr, = struct.unpack_from("<H", record, 1)
+    payload = record[3:]
+
+    prefix = ""
+    if flags & FLAGS_TICKS:
+        ticks, = struct.unpack_from("<I", payload)
+        payload = payload[4:]
+        prefix = f"[{ticks * tick_us / 1e6:10.3f}] "
+
+    rtype = flags & FLAGS_TYPE_MSK
+    if rtype == TYPE_MSG:
+        return prefix + format_message(elf, elf.read_string(fmt_addr), payload)
+    elif rtype == TYPE_HEXDUMP:
+        level = LEVELS.get(flags & FLAGS_LEVEL_MSK, "???")
+        return prefix + f"<{level}> " + " ".join(f"{b:02x}" for b in payload) + "\n"
+    elif rtype == TYPE_DROPPED:
+        count, = struct.unpack_from("<H", payload)
+        return prefix + f"--- {count} log record(s) dropped ---\n"
+    else:
+        return prefix + f"<invalid record {record.hex()}>\n"
+
+
+class Decoder:
+    def __init__(self, elf: Elf, tick_us: int):
+        self.elf = elf
+        self.tick_us = tick_us
+        self.buf = bytearray()
+
+    def feed(self, data: bytes) -> str:
+        self.buf += data
+        out = ""
+
+        while self.buf:
+            sync = self.buf.find(LOG_SYNC)
+            if sync < 0:
+                out += self.buf.decode("ascii", errors="replace")
+                self.buf.clear()
+            elif sync > 0:
+                out += self.buf[:sync].decode("ascii", errors="replace")
+                del self.buf[:sync]
+            elif len(self.buf) < 2 or len(self.buf) < 2 + self.buf[1]:
+                # wait for the end of the record
+                break
+            else:
+                length = self.buf[1]
+                out += decode_record(self.elf, bytes(self.buf[2:2 + length]), self.tick_us)
+                del self.buf[:2 + length]
+
+        return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="AVRTOS deferred logging decoder")
+    parser.add_argument("elf", help="ELF file of the application")
+    parser.add_argument("--port", help="serial port to read from")
+    parser.add_argument("--baudrate", type=int, default=115200)
+    parser.add_argument("--input", help="binary capture file (default: stdin)")
+    parser.add_argument("--tick-us", type=int, default=1000,
+                        help="CONFIG_KERNEL_SYSCLOCK_PERIOD_US of the application")
+    args = parser.parse_args()
+
+    decoder = Decoder(Elf(args.elf), args.tick_us)
+
+    if args.port:
+        import serial
+
+        with serial.Serial(args.port, args.baudrate) as ser:
+            while True:
+                data = ser.read(max(1, ser.in_waiting))
+                sys.stdout.write(decoder.feed(data))
+                sys.stdout.flush()
+    else:
+        stream = open(args.input, "rb") if args.input else sys.stdin.buffer
+        with stream:
+            while True:
+                data = stream.read(256)
+                if not data:
+                    break
+                sys.stdout.write(decoder.feed(data))
+
+
+if __name__ == "__main__":
+    main()
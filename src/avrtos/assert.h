@@ -38,6 +38,8 @@ extern "C" {
 #define K_MODULE_SYSCLOCK 3
 #define K_MODULE_THREAD	  4
 #define K_MODULE_IDLE	  5
+#define K_MODULE_WATCHDOG 6
+#define K_MODULE_PM		  7
 
 #define K_MODULE_MUTEX	   10
 #define K_MODULE_SEMAPHORE 11
@@ -52,6 +54,9 @@ extern "C" {
 #define K_MODULE_DRIVERS_USART	19
 #define K_MODULE_DRIVERS_TIMERS 20
 #define K_MODULE_DEVICE			21
+#define K_MODULE_HRTIMER		22
+#define K_MODULE_DRIVERS_SPI	23
+#define K_MODULE_DRIVERS_ADC	24
 
 #define K_MODULE_APPLICATION 32
 
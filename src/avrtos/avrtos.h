@@ -42,10 +42,13 @@
 #include "semaphore.h"
 #include "timer.h"
 #include "event.h"
+#include "hrtimer.h"
 #include "signal.h"
 #include "fifo.h"
 #include "mem_slab.h"
 #include "msgq.h"
+#include "watchdog.h"
+#include "pm.h"
 
 #include "stdio.h"
 
@@ -250,6 +250,22 @@
 #define CONFIG_KERNEL_TIME_SLICE_US 1000llu
 #endif
 
+//
+// Enable per-thread time slices.
+//
+// Each preemptive thread gets a time slice budget expressed as a number of
+// kernel time slices (CONFIG_KERNEL_TIME_SLICE_US), set with
+// K_THREAD_DEFINE_TIME_SLICE() or k_thread_set_time_slice(). The thread is
+// preempted by the systick once its budget is consumed, or at the next systick
+// when another thread becomes ready (e.g. woken up by a timeout).
+//
+// 0: All preemptive threads get a single time slice.
+// 1: Per-thread time slices are enabled.
+//
+#ifndef CONFIG_KERNEL_THREAD_TIME_SLICE
+#define CONFIG_KERNEL_THREAD_TIME_SLICE 0
+#endif
+
 //
 // Select the hardware timer used for the kernel sysclock.
 //
@@ -350,6 +366,74 @@
 #define CONFIG_KERNEL_CLEAR_WDT_ON_INIT 0
 #endif
 
+//
+// Enable the watchdog service (see k_watchdog_register()).
+//
+// The hardware watchdog is enabled at kernel initialization and reset from the
+// tick handler only while all the threads which registered a watchdog channel
+// check in within their timeout. The first expired channel is recorded in the
+// .noinit section before the watchdog resets the MCU.
+//
+// 0: Watchdog service is disabled.
+// 1: Watchdog service is enabled.
+//
+#ifndef CONFIG_KERNEL_WATCHDOG
+#define CONFIG_KERNEL_WATCHDOG 0
+#endif
+
+//
+// Timeout of the hardware watchdog used by the watchdog service, as a WDTO_*
+// value of <avr/wdt.h>.
+//
+// 0: 15ms, 1: 30ms, 2: 60ms, 3: 120ms, 4: 250ms, 5: 500ms, 6: 1s, 7: 2s,
+// 8: 4s, 9: 8s
+//
+#ifndef CONFIG_KERNEL_WATCHDOG_TIMEOUT
+#define CONFIG_KERNEL_WATCHDOG_TIMEOUT 4
+#endif
+
+//
+// Enable the power management of the idle thread (see pm.h).
+//
+// When no thread is ready, the idle thread enters the deepest sleep mode
+// compatible with the pending kernel deadlines and the capabilities required by
+// the peripherals (k_pm_require()). The sysclock only runs in IDLE mode.
+// If CONFIG_KERNEL_STATS is enabled, the sleep residency is accounted.
+//
+// 0: The idle thread executes the SLEEP instruction without enabling it.
+// 1: Power management is enabled.
+//
+#ifndef CONFIG_KERNEL_PM
+#define CONFIG_KERNEL_PM 0
+#endif
+
+//
+// Mask of the sleep modes the power management may use (BIT(k_pm_mode_t)),
+// the IDLE mode is always allowed.
+//
+// The standby modes require an external crystal or resonator.
+//
+#ifndef CONFIG_KERNEL_PM_MODES
+#define CONFIG_KERNEL_PM_MODES 0x3F
+#endif
+
+//
+// Start-up time of the main oscillator when waking up from the power-save and
+// power-down modes, in clock cycles, as selected by the CKSEL and SUT fuses
+// (e.g. 16K CK for a low power crystal oscillator).
+//
+#ifndef CONFIG_KERNEL_PM_OSC_STARTUP_CK
+#define CONFIG_KERNEL_PM_OSC_STARTUP_CK 16384
+#endif
+
+//
+// Maximum wake-up latency tolerated, in microseconds. Sleep modes with a longer
+// exit latency are not used.
+//
+#ifndef CONFIG_KERNEL_PM_MAX_LATENCY_US
+#define CONFIG_KERNEL_PM_MAX_LATENCY_US 0xFFFF
+#endif
+
 //
 // Indicates whether the kernel should define an idle thread to enable other threads to
 // sleep. If disabled, at least one thread must always be ready; otherwise, a fault will
@@ -563,6 +647,30 @@
 #define CONFIG_KERNEL_EVENTS_ALLOW_NO_WAIT 1
 #endif
 
+//
+// Defer the execution of expired event handlers to the system workqueue.
+// The systick interrupt only moves the expired events to a pending list, the
+// handlers are then called one at a time from the system workqueue thread
+// (with interrupts disabled), which keeps the systick interrupt duration bounded
+// regardless of the number of expiring events.
+// Requires CONFIG_SYSTEM_WORKQUEUE_ENABLE.
+//
+// 0: Event handlers are called from the systick interrupt.
+// 1: Event handlers are called from the system workqueue.
+//
+#ifndef CONFIG_KERNEL_EVENTS_DEFERRED
+#define CONFIG_KERNEL_EVENTS_DEFERRED 0
+#endif
+
+//
+// Maximum number of expired events moved to the pending list per systick
+// interrupt, when CONFIG_KERNEL_EVENTS_DEFERRED is enabled. Remaining expired
+// events are moved during the next ticks.
+//
+#ifndef CONFIG_KERNEL_EVENTS_DEFERRED_MAX_PER_TICK
+#define CONFIG_KERNEL_EVENTS_DEFERRED_MAX_PER_TICK 8
+#endif
+
 //
 // Automatic initialization of the serial console.
 //
@@ -594,6 +702,30 @@
 #define CONFIG_STDIO_PRINTF_TO_USART -1
 #endif
 
+//
+// Size of the TX ring buffer used by printf, drained by the UDRE interrupt of
+// the USART selected by CONFIG_STDIO_PRINTF_TO_USART. The usable capacity is
+// (size - 1) bytes.
+//
+// 0: printf is synchronous, each character is sent by polling the USART.
+// 2-255: printf writes to the buffer and returns without waiting for the wire.
+//
+#ifndef CONFIG_STDIO_USART_TX_BUFFER_SIZE
+#define CONFIG_STDIO_USART_TX_BUFFER_SIZE 0
+#endif
+
+//
+// Policy applied by printf when the TX ring buffer is full.
+//
+// 0: Block the calling thread until room is available (bytes are sent by
+//    polling if interrupts are disabled).
+// 1: Drop the new character.
+// 2: Overwrite the oldest character of the buffer.
+//
+#ifndef CONFIG_STDIO_USART_TX_FULL_POLICY
+#define CONFIG_STDIO_USART_TX_FULL_POLICY 0
+#endif
+
 //
 // Enable the logging subsystem.
 //
@@ -604,6 +736,37 @@
 #define CONFIG_LOGGING_SUBSYSTEM 1
 #endif
 
+//
+// Deferred (dictionary) logging. LOG_* macros only store a binary record (format
+// string address in flash, level, timestamp and raw arguments) in a RAM ring
+// buffer, a thread streams the records to stdout. Records are turned back into
+// text on the host with scripts/log_decoder.py and the ELF file.
+//
+// Limitations: at most 8 arguments per call, %s arguments (RAM strings) are not
+// dereferenced, use %S with PSTR() strings instead.
+//
+// 0: Log messages are formatted with printf by the calling thread.
+// 1: Log messages are deferred.
+//
+#ifndef CONFIG_LOGGING_DEFERRED
+#define CONFIG_LOGGING_DEFERRED 0
+#endif
+
+//
+// Size of the deferred logging ring buffer, records which do not fit are dropped
+// and counted.
+//
+#ifndef CONFIG_LOGGING_DEFERRED_BUFFER_SIZE
+#define CONFIG_LOGGING_DEFERRED_BUFFER_SIZE 128
+#endif
+
+//
+// Stack size of the deferred logging thread.
+//
+#ifndef CONFIG_LOGGING_DEFERRED_THREAD_STACK_SIZE
+#define CONFIG_LOGGING_DEFERRED_THREAD_STACK_SIZE 0x80
+#endif
+
 //
 // Enable the uptime counter.
 //
@@ -634,6 +797,30 @@
 #define CONFIG_KERNEL_TIME_API_MS_PRECISION 0
 #endif
 
+//
+// Enable high-resolution (microsecond) one-shot timers.
+// Timers expire on a spare output compare channel of the sysclock hardware timer,
+// (CONFIG_KERNEL_SYSLOCK_HW_TIMER) which must be a 16-bit timer.
+// Requires CONFIG_KERNEL_UPTIME.
+//
+// 0: High-resolution timers are disabled
+// 1: High-resolution timers are enabled
+//
+#ifndef CONFIG_KERNEL_HRTIMER
+#define CONFIG_KERNEL_HRTIMER 0
+#endif
+
+//
+// Output compare channel of the sysclock timer used by high-resolution timers.
+// Channel A is reserved for the sysclock itself.
+//
+// 1: Channel B (OCRnB)
+// 2: Channel C (OCRnC), if the timer has one
+//
+#ifndef CONFIG_KERNEL_HRTIMER_CHANNEL
+#define CONFIG_KERNEL_HRTIMER_CHANNEL 1
+#endif
+
 //
 // Enable atomic API
 //
@@ -755,6 +942,58 @@
 #define CONFIG_DRIVERS_USART3_ASYNC 0
 #endif
 
+//
+// Enable interrupt-driven buffered support for USART0 (usart_read/usart_write)
+//
+// 0: USART0 buffered support is disabled
+// 1: USART0 buffered support is enabled (exclusive with CONFIG_DRIVERS_USART0_ASYNC)
+//
+#ifndef CONFIG_DRIVERS_USART0_BUFFERED
+#define CONFIG_DRIVERS_USART0_BUFFERED 0
+#endif
+
+//
+// Enable interrupt-driven buffered support for USART1 (usart_read/usart_write)
+//
+// 0: USART1 buffered support is disabled
+// 1: USART1 buffered support is enabled (exclusive with CONFIG_DRIVERS_USART1_ASYNC)
+//
+#ifndef CONFIG_DRIVERS_USART1_BUFFERED
+#define CONFIG_DRIVERS_USART1_BUFFERED 0
+#endif
+
+//
+// Enable interrupt-driven buffered support for USART2 (usart_read/usart_write)
+//
+// 0: USART2 buffered support is disabled
+// 1: USART2 buffered support is enabled (exclusive with CONFIG_DRIVERS_USART2_ASYNC)
+//
+#ifndef CONFIG_DRIVERS_USART2_BUFFERED
+#define CONFIG_DRIVERS_USART2_BUFFERED 0
+#endif
+
+//
+// Enable interrupt-driven buffered support for USART3 (usart_read/usart_write)
+//
+// 0: USART3 buffered support is disabled
+// 1: USART3 buffered support is enabled (exclusive with CONFIG_DRIVERS_USART3_ASYNC)
+//
+#ifndef CONFIG_DRIVERS_USART3_BUFFERED
+#define CONFIG_DRIVERS_USART3_BUFFERED 0
+#endif
+
+//
+// Enable RX idle line detection in the asynchronous USART path
+// (see usart_rx_set_idle_timeout()). An event is scheduled per frame, the idle
+// timeout resolution is the kernel tick.
+//
+// 0: RX idle detection is disabled
+// 1: RX idle detection is enabled (requires CONFIG_KERNEL_EVENTS and CONFIG_KERNEL_UPTIME)
+//
+#ifndef CONFIG_DRIVERS_USART_ASYNC_RX_IDLE
+#define CONFIG_DRIVERS_USART_ASYNC_RX_IDLE 0
+#endif
+
 //
 // Enable high level support for timer0
 //
@@ -815,6 +1054,71 @@
 #define CONFIG_DRIVERS_TIMER5_API 0
 #endif
 
+//
+// 16 bits timers drivers: CONFIG_DRIVERS_TIMER_CAPTURE, CONFIG_DRIVERS_TIMER_PWM and
+// CONFIG_DRIVERS_TIMER_MUX are masks of timers, bit n set selects timer n.
+//
+// Only timers 1, 3, 4 and 5 are supported. A timer is used by one of these drivers
+// at most, and neither with its high level API (CONFIG_DRIVERS_TIMERn_API) nor as
+// the sysclock timer (CONFIG_KERNEL_SYSLOCK_HW_TIMER).
+//
+
+//
+// 16 bits timers used for input capture (see timer_capture_start())
+//
+// The input capture and overflow interrupts of the timers are handled by the
+// driver.
+//
+// 0: Input capture is disabled
+// e.g. 0x02: Input capture is enabled for timer1
+//
+#ifndef CONFIG_DRIVERS_TIMER_CAPTURE
+#define CONFIG_DRIVERS_TIMER_CAPTURE 0
+#endif
+
+//
+// 16 bits timers used for synchronized PWM outputs (see timer_pwm_start())
+//
+// The overflow interrupt of the timers is handled by the driver, which applies
+// the committed duty cycles and replays the waveform tables.
+//
+// 0: PWM service is disabled
+// e.g. 0x0A: PWM service is enabled for timers 1 and 3
+//
+#ifndef CONFIG_DRIVERS_TIMER_PWM
+#define CONFIG_DRIVERS_TIMER_PWM 0
+#endif
+
+//
+// 16 bits timers used as multiplexed time bases (see timer_mux_start())
+//
+// The overflow and compare match A interrupts of the timers are handled by the
+// driver, which runs the timer freely and schedules any number of software
+// alarms on its channel A. Channels B and C remain available to other clients
+// (see timer_alloc()).
+//
+// 0: Multiplexer is disabled
+// e.g. 0x02: Multiplexer is enabled for timer1
+//
+#ifndef CONFIG_DRIVERS_TIMER_MUX
+#define CONFIG_DRIVERS_TIMER_MUX 0
+#endif
+
+//
+// Pin change interrupt groups handled by the PCINT dispatcher (see
+// pcint_pin_register())
+//
+// Bit n set: ISR(PCINTn_vect) is defined by the driver and dispatches the
+// changes of the pins of group n to their callbacks and flags. Debouncing
+// requires CONFIG_KERNEL_EVENTS.
+//
+// 0: PCINT dispatcher is disabled
+// 0x1 to 0x7: PCINT dispatcher is enabled for the given groups
+//
+#ifndef CONFIG_DRIVERS_PCINT_DISPATCH
+#define CONFIG_DRIVERS_PCINT_DISPATCH 0
+#endif
+
 //
 // Debug systick using given GPIO pin of PORTB
 //
@@ -831,6 +1135,8 @@
 //
 // Enable statistics for kernel
 //
+// e.g. sleep residency of the power management (see k_pm_stats_get()).
+//
 // 0: Kernel statistics is disabled
 // 1: Kernel statistics is enabled
 //
@@ -895,6 +1201,51 @@
 #define CONFIG_SPI_ASYNC 0
 #endif
 
+//
+// Enable the SPI transaction queue (see spi_transaction_submit())
+//
+// Transactions (slave, TX and RX buffers) are queued and run back to back by
+// the ISR(SPI_STC_vect) interrupt handler, which handles the chip select and
+// the registers of each slave. Completion is signaled with a semaphore or a
+// work item, the calling thread sleeps during the transfer.
+//
+// Synchronous functions should not be used while transactions are queued.
+//
+// 0: SPI transaction queue is disabled
+// 1: SPI transaction queue is enabled (exclusive with CONFIG_SPI_ASYNC)
+//
+#ifndef CONFIG_SPI_TRANSACTIONS
+#define CONFIG_SPI_TRANSACTIONS 0
+#endif
+
+//
+// Enable background sampling of ADC channel sequences (see adc_sequence_start())
+//
+// This option defines ISR(ADC_vect) { } interrupt handler, which prevents the
+// developer from defining its own. Conversions are started by the hardware auto
+// trigger source and the samples are stored in two alternating blocks.
+//
+// 0: ADC sequences are disabled
+// 1: ADC sequences are enabled
+//
+#ifndef CONFIG_DRIVERS_ADC_SEQUENCE
+#define CONFIG_DRIVERS_ADC_SEQUENCE 0
+#endif
+
+//
+// Enable asynchronous EEPROM writes (see eeprom_write_submit())
+//
+// This option defines ISR(EE_READY_vect) { } interrupt handler, which prevents
+// the developer from defining its own. Writes are queued and programmed byte
+// after byte from the interrupt handler, it is required to save records.
+//
+// 0: EEPROM asynchronous writes are disabled
+// 1: EEPROM asynchronous writes are enabled
+//
+#ifndef CONFIG_DRIVERS_EEPROM_ASYNC
+#define CONFIG_DRIVERS_EEPROM_ASYNC 0
+#endif
+
 //
 // Enable AVRTOS banner on startup
 //
@@ -998,6 +1349,21 @@
 #define CONFIG_I2C_LAST_ERROR 1
 #endif
 
+//
+// Enable the I2C transaction queue (see i2c_transaction_submit())
+//
+// Transactions (address and list of read/write messages of any length) are
+// queued per device and run back to back by the TWI interrupt handler, with
+// repeated starts between messages. Completion is signaled with a semaphore,
+// a callback or a work item, the calling thread sleeps during the transfer.
+//
+// 0: I2C transaction queue is disabled
+// 1: I2C transaction queue is enabled (requires CONFIG_I2C_INTERRUPT_DRIVEN)
+//
+#ifndef CONFIG_I2C_TRANSACTIONS
+#define CONFIG_I2C_TRANSACTIONS 0
+#endif
+
 //
 // Enable I2C driver debug
 //
@@ -1030,4 +1396,36 @@
 #define CONFIG_DEVICE_MCP2515 0
 #endif
 
+//
+// Enable interrupt-driven reception and transmission for the MCP2515 (see
+// mcp2515_irq_enable() and mcp2515_send_async())
+//
+// The INT pin of the MCP2515 is connected to an external interrupt (INTn), the
+// interrupt handler submits a work item to the system workqueue which reads
+// the RX buffers and pushes the frames to a message queue, and refills the
+// three TX buffers from the software TX queue.
+//
+// 0: MCP2515 interrupt-driven reception/transmission is disabled
+// 1: MCP2515 interrupt-driven reception/transmission is enabled (requires
+//    CONFIG_SYSTEM_WORKQUEUE_ENABLE)
+//
+#ifndef CONFIG_MCP2515_INTERRUPT
+#define CONFIG_MCP2515_INTERRUPT 0
+#endif
+
+//
+// Enable the periodic I2C sensor acquisition (see sensor_register())
+//
+// Registered sensors (e.g. TCN75, see tcn75_sensor_init()) are read
+// periodically by I2C transactions queued from a kernel event, the samples are
+// decoded and filtered from the TWI interrupt and published to a message queue.
+//
+// 0: Sensor acquisition is disabled
+// 1: Sensor acquisition is enabled (requires CONFIG_I2C_TRANSACTIONS,
+//    CONFIG_KERNEL_EVENTS and CONFIG_KERNEL_UPTIME)
+//
+#ifndef CONFIG_DEVICE_SENSOR
+#define CONFIG_DEVICE_SENSOR 0
+#endif
+
 #endif
@@ -84,6 +84,128 @@
 #error "CONFIG_KERNEL_TIME_API requires CONFIG_KERNEL_UPTIME"
 #endif
 
+#if CONFIG_KERNEL_EVENTS_DEFERRED && !CONFIG_SYSTEM_WORKQUEUE_ENABLE
+#error "CONFIG_KERNEL_EVENTS_DEFERRED requires CONFIG_SYSTEM_WORKQUEUE_ENABLE"
+#endif
+
+#if CONFIG_KERNEL_EVENTS_DEFERRED && (CONFIG_KERNEL_EVENTS_DEFERRED_MAX_PER_TICK == 0 || \
+									  CONFIG_KERNEL_EVENTS_DEFERRED_MAX_PER_TICK > 255)
+#error "CONFIG_KERNEL_EVENTS_DEFERRED_MAX_PER_TICK must be in range [1, 255]"
+#endif
+
+#if CONFIG_DRIVERS_USART0_ASYNC && CONFIG_DRIVERS_USART0_BUFFERED
+#error "CONFIG_DRIVERS_USART0_ASYNC and CONFIG_DRIVERS_USART0_BUFFERED are exclusive"
+#endif
+
+#if CONFIG_DRIVERS_USART1_ASYNC && CONFIG_DRIVERS_USART1_BUFFERED
+#error "CONFIG_DRIVERS_USART1_ASYNC and CONFIG_DRIVERS_USART1_BUFFERED are exclusive"
+#endif
+
+#if CONFIG_DRIVERS_USART2_ASYNC && CONFIG_DRIVERS_USART2_BUFFERED
+#error "CONFIG_DRIVERS_USART2_ASYNC and CONFIG_DRIVERS_USART2_BUFFERED are exclusive"
+#endif
+
+#if CONFIG_DRIVERS_USART3_ASYNC && CONFIG_DRIVERS_USART3_BUFFERED
+#error "CONFIG_DRIVERS_USART3_ASYNC and CONFIG_DRIVERS_USART3_BUFFERED are exclusive"
+#endif
+
+#if CONFIG_DRIVERS_USART_ASYNC_RX_IDLE && (!CONFIG_KERNEL_EVENTS || !CONFIG_KERNEL_UPTIME)
+#error "CONFIG_DRIVERS_USART_ASYNC_RX_IDLE requires CONFIG_KERNEL_EVENTS and CONFIG_KERNEL_UPTIME"
+#endif
+
+#if CONFIG_STDIO_USART_TX_BUFFER_SIZE == 1 || CONFIG_STDIO_USART_TX_BUFFER_SIZE > 255
+#error "CONFIG_STDIO_USART_TX_BUFFER_SIZE must be 0 or in range [2, 255]"
+#endif
+
+#if CONFIG_STDIO_USART_TX_FULL_POLICY > 2
+#error "CONFIG_STDIO_USART_TX_FULL_POLICY must be 0 (block), 1 (drop) or 2 (overwrite)"
+#endif
+
+#if CONFIG_STDIO_USART_TX_BUFFER_SIZE &&                                                 \
+	((CONFIG_STDIO_PRINTF_TO_USART == 0 &&                                               \
+	  (CONFIG_DRIVERS_USART0_ASYNC || CONFIG_DRIVERS_USART0_BUFFERED)) ||                \
+	 (CONFIG_STDIO_PRINTF_TO_USART == 1 &&                                               \
+	  (CONFIG_DRIVERS_USART1_ASYNC || CONFIG_DRIVERS_USART1_BUFFERED)) ||                \
+	 (CONFIG_STDIO_PRINTF_TO_USART == 2 &&                                               \
+	  (CONFIG_DRIVERS_USART2_ASYNC || CONFIG_DRIVERS_USART2_BUFFERED)) ||                \
+	 (CONFIG_STDIO_PRINTF_TO_USART == 3 &&                                               \
+	  (CONFIG_DRIVERS_USART3_ASYNC || CONFIG_DRIVERS_USART3_BUFFERED)))
+#error "CONFIG_STDIO_USART_TX_BUFFER_SIZE uses the UDRE interrupt of the printf USART"
+#endif
+
+#if CONFIG_LOGGING_DEFERRED && (CONFIG_LOGGING_DEFERRED_BUFFER_SIZE < 32 ||            \
+								 CONFIG_LOGGING_DEFERRED_BUFFER_SIZE > 0x7FFF)
+#error "CONFIG_LOGGING_DEFERRED_BUFFER_SIZE must be in range [32, 0x7FFF]"
+#endif
+
+#if CONFIG_SPI_ASYNC && CONFIG_SPI_TRANSACTIONS
+#error "CONFIG_SPI_ASYNC and CONFIG_SPI_TRANSACTIONS both define ISR(SPI_STC_vect)"
+#endif
+
+#if CONFIG_I2C_TRANSACTIONS && !CONFIG_I2C_INTERRUPT_DRIVEN
+#error "CONFIG_I2C_TRANSACTIONS requires CONFIG_I2C_INTERRUPT_DRIVEN"
+#endif
+
+#if CONFIG_MCP2515_INTERRUPT && !CONFIG_SYSTEM_WORKQUEUE_ENABLE
+#error "CONFIG_MCP2515_INTERRUPT requires CONFIG_SYSTEM_WORKQUEUE_ENABLE"
+#endif
+
+#if CONFIG_DEVICE_SENSOR &&                                                              \
+	(!CONFIG_I2C_TRANSACTIONS || !CONFIG_KERNEL_EVENTS || !CONFIG_KERNEL_UPTIME)
+#error "CONFIG_DEVICE_SENSOR requires CONFIG_I2C_TRANSACTIONS, CONFIG_KERNEL_EVENTS and CONFIG_KERNEL_UPTIME"
+#endif
+
+#if CONFIG_KERNEL_WATCHDOG && (CONFIG_KERNEL_WATCHDOG_TIMEOUT > 9)
+#error "CONFIG_KERNEL_WATCHDOG_TIMEOUT must be a WDTO_* value (0 to 9)"
+#endif
+
+#if CONFIG_KERNEL_PM && (CONFIG_KERNEL_PM_MODES & ~0x3F)
+#error "CONFIG_KERNEL_PM_MODES is a mask of k_pm_mode_t values (0x00 to 0x3F)"
+#endif
+
+/* Timers used with the high level API (CONFIG_DRIVERS_TIMERn_API) */
+#define Z_DRIVERS_TIMERS_API_MASK                                                        \
+	((CONFIG_DRIVERS_TIMER0_API ? 0x01 : 0) | (CONFIG_DRIVERS_TIMER1_API ? 0x02 : 0) |   \
+	 (CONFIG_DRIVERS_TIMER2_API ? 0x04 : 0) | (CONFIG_DRIVERS_TIMER3_API ? 0x08 : 0) |   \
+	 (CONFIG_DRIVERS_TIMER4_API ? 0x10 : 0) | (CONFIG_DRIVERS_TIMER5_API ? 0x20 : 0))
+
+/* Timers used by the 16 bits timers drivers (input capture, PWM, multiplexer) */
+#define Z_DRIVERS_TIMERS16_MASK                                                          \
+	(CONFIG_DRIVERS_TIMER_CAPTURE | CONFIG_DRIVERS_TIMER_PWM | CONFIG_DRIVERS_TIMER_MUX)
+
+#if Z_DRIVERS_TIMERS16_MASK & ~0x3A
+#error "The 16 bits timers drivers only support timers 1, 3, 4 and 5"
+#endif
+
+#if (Z_DRIVERS_TIMERS16_MASK >> CONFIG_KERNEL_SYSLOCK_HW_TIMER) & 1
+#error "The 16 bits timers drivers cannot use the sysclock timer (CONFIG_KERNEL_SYSLOCK_HW_TIMER)"
+#endif
+
+#if (CONFIG_DRIVERS_TIMER_CAPTURE & CONFIG_DRIVERS_TIMER_PWM) ||                         \
+	(CONFIG_DRIVERS_TIMER_MUX & (CONFIG_DRIVERS_TIMER_CAPTURE | CONFIG_DRIVERS_TIMER_PWM))
+#error "A timer can be used by one of the 16 bits timers drivers at most"
+#endif
+
+#if Z_DRIVERS_TIMERS16_MASK & Z_DRIVERS_TIMERS_API_MASK
+#error "A timer cannot be used by a 16 bits timers driver and with CONFIG_DRIVERS_TIMERn_API"
+#endif
+
+#if CONFIG_DRIVERS_PCINT_DISPATCH & ~0x7
+#error "CONFIG_DRIVERS_PCINT_DISPATCH must be a mask of groups 0 to 2"
+#endif
+
+#if !CONFIG_KERNEL_UPTIME && CONFIG_KERNEL_HRTIMER
+#error "CONFIG_KERNEL_HRTIMER requires CONFIG_KERNEL_UPTIME"
+#endif
+
+#if CONFIG_KERNEL_HRTIMER && (CONFIG_KERNEL_SYSLOCK_HW_TIMER == 0 || CONFIG_KERNEL_SYSLOCK_HW_TIMER == 2)
+#error "CONFIG_KERNEL_HRTIMER requires a 16-bit sysclock timer (CONFIG_KERNEL_SYSLOCK_HW_TIMER)"
+#endif
+
+#if CONFIG_KERNEL_HRTIMER && (CONFIG_KERNEL_HRTIMER_CHANNEL != 1 && CONFIG_KERNEL_HRTIMER_CHANNEL != 2)
+#error "CONFIG_KERNEL_HRTIMER_CHANNEL must be 1 (B) or 2 (C)"
+#endif
+
 #if CONFIG_KERNEL_TIME_SLICE_US < CONFIG_KERNEL_SYSCLOCK_PERIOD_US
 #error[UNSUPPORTED] CONFIG_KERNEL_TIME_SLICE_US < CONFIG_KERNEL_SYSCLOCK_PERIOD_US
 #elif CONFIG_KERNEL_TIME_SLICE_US > CONFIG_KERNEL_SYSCLOCK_PERIOD_US
@@ -297,7 +419,7 @@ typedef struct {
 	struct z_callsaved_ctx z_stack_buf_##name =                                          \
 		Z_CORE_CONTEXT_INIT(entry, ctx, z_thread_entry)
 
-#define Z_THREAD_INITIALIZER(_name, stack_size, _flags, sym)                             \
+#define Z_THREAD_INITIALIZER(_name, stack_size, _flags, sym, ...)                        \
 	struct k_thread _name = {                                                            \
 		.sp	   = (void *)Z_STACK_INIT_SP_FROM_NAME(_name, stack_size),                   \
 		.flags = _flags,                                                                 \
@@ -309,21 +431,21 @@ typedef struct {
 				.end  = (void *)Z_STACK_END(Z_THREAD_STACK_START(_name), stack_size),    \
 				.size = (stack_size),                                                    \
 			},                                                                           \
-		.symbol = sym}
+		.symbol = sym, __VA_ARGS__}
 
 #if CONFIG_AVRTOS_LINKER_SCRIPT
 #define Z_THREAD_DEFINE(name, entry, stack_size, prio_flag, context_p, symbol,           \
-						auto_start)                                                      \
+						auto_start, ...)                                                 \
 	__attribute__((used)) Z_STACK_INITIALIZER(name, stack_size, entry, context_p);       \
 	Z_LINK_KERNEL_SECTION(.k_threads)                                                    \
 	Z_THREAD_INITIALIZER(name, stack_size,                                               \
 						 (auto_start ? Z_THREAD_STATE_READY : Z_THREAD_STATE_STOPPED) |  \
 							 prio_flag,                                                  \
-						 symbol);                                                        \
+						 symbol, __VA_ARGS__);                                           \
 	Z_STACK_SENTINEL_REGISTER(z_stack_buf_##name)
 #else
 #define Z_THREAD_DEFINE(name, entry, stack_size, prio_flag, context_p, symbol,           \
-						auto_start)                                                      \
+						auto_start, ...)                                                 \
 	__STATIC_ASSERT(0u, "Static thread (K_THREAD_DEFINE) creation is not "               \
 						"supported");
 #endif
@@ -331,6 +453,32 @@ typedef struct {
 #define K_THREAD_DEFINE(name, entry, stack_size, prio_flag, context_p, symbol)           \
 	Z_THREAD_DEFINE(name, entry, stack_size, prio_flag, context_p, symbol, 1)
 
+/* Number of kernel time slices in a duration in milliseconds, rounded down */
+#define Z_THREAD_TIME_SLICES_MS(slice_ms) (((slice_ms)*1000LLU) / CONFIG_KERNEL_TIME_SLICE_US)
+
+/* Convert a duration in milliseconds to a number of kernel time slices, at least 1,
+ * the duration must not exceed 255 time slices (see K_THREAD_DEFINE_TIME_SLICE) */
+#define Z_THREAD_TIME_SLICE_FROM_MS(slice_ms)                                            \
+	(Z_THREAD_TIME_SLICES_MS(slice_ms) == 0u ? 1u                                        \
+											 : (uint8_t)Z_THREAD_TIME_SLICES_MS(slice_ms))
+
+#if CONFIG_KERNEL_THREAD_TIME_SLICE
+/**
+ * @brief Statically define a thread with a time slice budget.
+ *
+ * Same as K_THREAD_DEFINE, the thread is preempted by the systick only after
+ * `slice_ms` milliseconds (rounded down to a multiple of CONFIG_KERNEL_TIME_SLICE_US).
+ * The build fails if `slice_ms` exceeds 255 kernel time slices, as
+ * k_thread_set_time_slice() returns -ERANGE.
+ */
+#define K_THREAD_DEFINE_TIME_SLICE(name, entry, stack_size, prio_flag, context_p, symbol, \
+								   slice_ms)                                              \
+	__STATIC_ASSERT(Z_THREAD_TIME_SLICES_MS(slice_ms) <= 255u,                            \
+					"time slice of thread " #name " exceeds 255 kernel time slices");     \
+	Z_THREAD_DEFINE(name, entry, stack_size, prio_flag, context_p, symbol, 1,             \
+					.time_slice = Z_THREAD_TIME_SLICE_FROM_MS(slice_ms))
+#endif /* CONFIG_KERNEL_THREAD_TIME_SLICE */
+
 #if CONFIG_THREAD_MAIN_MONITOR || CONFIG_THREAD_EXPLICIT_MAIN_STACK
 #define Z_THREAD_IS_MONITORED(thread) true
 #else
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <avrtos/drivers/exti.h>
 #include <avrtos/logging.h>
 
 #include "mcp2515_priv.h"
@@ -28,6 +29,52 @@
 
 #define spi_read() spi_transceive(0x00)
 
+/* If the slave is attached to a SPI bus, the bus mutex protects the device and
+ * the SPI registers of the device are applied when needed.
+ */
+static int8_t mcp_lock_timeout(struct mcp2515_device *mcp, k_timeout_t timeout)
+{
+	if (mcp->slave.bus != NULL) {
+		return spi_bus_acquire(&mcp->slave, timeout);
+	} else {
+		return k_mutex_lock(&mcp->_mutex, timeout);
+	}
+}
+
+static void mcp_lock(struct mcp2515_device *mcp)
+{
+	mcp_lock_timeout(mcp, K_FOREVER);
+}
+
+static void mcp_unlock(struct mcp2515_device *mcp)
+{
+	if (mcp->slave.bus != NULL) {
+		spi_bus_release(&mcp->slave);
+	} else {
+		k_mutex_unlock(&mcp->_mutex);
+	}
+
+#if CONFIG_MCP2515_INTERRUPT
+	/* Run the interrupt handling skipped while the device was locked */
+	const uint8_t key = irq_lock();
+	if (mcp->_work_deferred) {
+		mcp->_work_deferred = 0u;
+		k_system_workqueue_submit(&mcp->_work);
+	}
+	irq_unlock(key);
+#endif
+}
+
+static uint8_t read_register(struct mcp2515_device *mcp, uint8_t reg_addr)
+{
+	MCP_SELECT(mcp);
+	spi_transceive(MCP_READ);
+	spi_transceive(reg_addr);
+	uint8_t reg_val = spi_read();
+	MCP_UNSELECT(mcp);
+	return reg_val;
+}
+
 static void write_register(struct mcp2515_device *mcp, uint8_t reg_addr, uint8_t reg_val)
 {
 	MCP_SELECT(mcp);
@@ -114,11 +161,23 @@ int8_t mcp2515_init(struct mcp2515_device *mcp,
 	/* Init device instance */
 	memcpy(&mcp->slave, spi_slave, sizeof(struct spi_slave));
 	k_mutex_init(&mcp->_mutex);
+#if CONFIG_MCP2515_INTERRUPT
+	mcp->_rx_msgq		= NULL;
+	mcp->_work_deferred = 0u;
+	mcp->_tx_head		= NULL;
+	memset(mcp->_tx_pending, 0x00u, sizeof(mcp->_tx_pending));
+	mcp->_rules		  = NULL;
+	mcp->_rules_count = 0u;
+#endif
 
 	/* Set SPI */
-	spi_regs_restore(&spi_slave->regs);
+	if (mcp->slave.bus == NULL) {
+		spi_regs_restore(&spi_slave->regs);
+	}
 	spi_slave_ss_init(&mcp->slave);
 
+	mcp_lock(mcp);
+
 	/* Reset the MCP2515 */
 	mcp_reset(mcp);
 	k_msleep(CONFIG_MCP2515_DELAY_MS); // wait for reset
@@ -131,7 +190,7 @@ int8_t mcp2515_init(struct mcp2515_device *mcp,
 	ret = config_dr(mcp, config->can_speed, config->clock_speed);
 	if (ret) {
 		LOG_ERR("config_dr failed: %d", ret);
-		return ret;
+		goto exit;
 	}
 	k_msleep(CONFIG_MCP2515_DELAY_MS); // wait for config
 
@@ -186,18 +245,59 @@ int8_t mcp2515_init(struct mcp2515_device *mcp,
 	set_mode(mcp, MCP_MODE_NORMAL);
 	k_msleep(CONFIG_MCP2515_DELAY_MS); // wait for mode change
 
+exit:
+	mcp_unlock(mcp);
+
 	return ret;
 }
 
+#if CONFIG_MCP2515_INTERRUPT
+struct mcp_flush {
+	struct k_work work;
+	struct k_sem sem;
+};
+
+static void mcp_flush_handler(struct k_work *work)
+{
+	struct mcp_flush *const flush = CONTAINER_OF(work, struct mcp_flush, work);
+
+	k_sem_give(&flush->sem);
+}
+
+/* Wait for the work items submitted to the system workqueue so far, including
+ * the interrupt handling of the device */
+static void mcp_flush_work(void)
+{
+	struct mcp_flush flush = {
+		.work = Z_WORK_INIT(mcp_flush_handler),
+	};
+	k_sem_init(&flush.sem, 0u, 1u);
+
+	k_system_workqueue_submit(&flush.work);
+	k_sem_take(&flush.sem, K_FOREVER);
+}
+#endif
+
 int8_t mcp2515_deinit(struct mcp2515_device *mcp)
 {
-	k_mutex_lock(&mcp->_mutex, K_FOREVER);
+#if CONFIG_MCP2515_INTERRUPT
+	/* The EXTI is disabled and the TX requests are completed, the work item
+	 * must not be queued anymore when the device is cleared */
+	mcp2515_irq_disable(mcp);
+	mcp_flush_work();
+#endif
+
+	mcp_lock(mcp);
 
 	mcp_reset(mcp);
 
 	k_msleep(CONFIG_MCP2515_DELAY_MS);
 
-	k_mutex_cancel_wait(&mcp->_mutex);
+	if (mcp->slave.bus != NULL) {
+		spi_bus_release(&mcp->slave);
+	} else {
+		k_mutex_cancel_wait(&mcp->_mutex);
+	}
 
 	memset(mcp, 0, sizeof(struct mcp2515_device));
 
@@ -246,6 +346,13 @@ static void start_transmit(struct mcp2515_device *mcp, uint8_t reg_rts)
 	MCP_UNSELECT(mcp);
 }
 
+/* The lower the identifier, the higher the priority on the bus */
+static uint8_t can_tx_priority(const struct can_frame *frame)
+{
+	const uint8_t msb = frame->is_ext ? (frame->id >> 27u) : (frame->id >> 9u);
+	return 3u - (msb & 0x03u);
+}
+
 // buf is a 4-byte buffer
 static void can_id_to_buf(uint8_t *buf, uint32_t id, uint8_t is_ext)
 {
@@ -269,40 +376,17 @@ static void can_id_to_buf(uint8_t *buf, uint32_t id, uint8_t is_ext)
 	}
 }
 
-int8_t mcp2515_send(struct mcp2515_device *mcp, const struct can_frame *frame)
+/* Load TX buffer txb with the frame and request its transmission */
+static void load_tx_buffer(struct mcp2515_device *mcp,
+						   uint8_t txb,
+						   const struct can_frame *frame,
+						   uint8_t prio)
 {
-	__ASSERT_NOTNULL(mcp);
-	__ASSERT_NOTNULL(frame);
-
-	k_mutex_lock(&mcp->_mutex, K_FOREVER);
-
-	int8_t ret	  = 0;
-	uint8_t txreq = read_status(mcp) & MCP_STATUS_TXREQ_MASK;
-	uint8_t reg_txnif;	// TXnIF flag to clear in CANINTF
-	uint8_t reg_txload; // Register to load TX buffer
-	uint8_t reg_txrts;	// Register to start transmission
-
-	/* Find a free TX buffer */
-	if ((txreq & MCP_STATUS_TX0REQ) == 0) {
-		reg_txnif  = MCP_CANINTF_TX0IF;
-		reg_txload = MCP_LOAD_TX_AT_TXB0SIDH;
-		reg_txrts  = MCP_RTS_TXB0;
-	} else if ((txreq & MCP_STATUS_TX1REQ) == 0) {
-		reg_txnif  = MCP_CANINTF_TX1IF;
-		reg_txload = MCP_LOAD_TX_AT_TXB1SIDH;
-		reg_txrts  = MCP_RTS_TXB1;
-	} else if ((txreq & MCP_STATUS_TX2REQ) == 0) {
-		reg_txnif  = MCP_CANINTF_TX2IF;
-		reg_txload = MCP_LOAD_TX_AT_TXB2SIDH;
-		reg_txrts  = MCP_RTS_TXB2;
-	} else {
-		/* All TX buffers are busy */
-		ret = -EBUSY;
-		goto exit;
-	}
-
 	/* Clear TXnIF flag */
-	modify_register(mcp, MCP_R_CANINTF, reg_txnif, 0);
+	modify_register(mcp, MCP_R_CANINTF, MCP_CANINTF_TXIF(txb), 0);
+
+	/* Set TX priority */
+	write_register(mcp, MCP_R_TXBCTRL(txb), prio & MCP_TXBCTRL_TXP_MASK);
 
 	/* Build TX identifier buffer */
 	uint8_t id[4];
@@ -314,7 +398,7 @@ int8_t mcp2515_send(struct mcp2515_device *mcp, const struct can_frame *frame)
 
 	/* Load TX buffer */
 	MCP_SELECT(mcp);
-	spi_transceive(reg_txload);
+	spi_transceive(MCP_LOAD_TX_BUFFER(txb, 0));
 
 	for (uint8_t i = 0; i < 4; i++) {
 		spi_transceive(id[i]);
@@ -326,10 +410,39 @@ int8_t mcp2515_send(struct mcp2515_device *mcp, const struct can_frame *frame)
 	}
 	MCP_UNSELECT(mcp);
 
-	start_transmit(mcp, reg_txrts);
+	start_transmit(mcp, MCP_RTS_TXB(txb));
+}
+
+int8_t mcp2515_send(struct mcp2515_device *mcp, const struct can_frame *frame)
+{
+	__ASSERT_NOTNULL(mcp);
+	__ASSERT_NOTNULL(frame);
+
+	mcp_lock(mcp);
+
+	int8_t ret	  = 0;
+	uint8_t txreq = read_status(mcp) & MCP_STATUS_TXREQ_MASK;
+	uint8_t txb;
+
+	/* Find a free TX buffer */
+	for (txb = 0u; txb < MCP_TXB_COUNT; txb++) {
+#if CONFIG_MCP2515_INTERRUPT
+		/* Buffer used by mcp2515_send_async() */
+		if (mcp->_tx_pending[txb] != NULL) continue;
+#endif
+		if ((txreq & MCP_STATUS_TXREQ(txb)) == 0) break;
+	}
+
+	if (txb == MCP_TXB_COUNT) {
+		/* All TX buffers are busy */
+		ret = -EBUSY;
+		goto exit;
+	}
+
+	load_tx_buffer(mcp, txb, frame, can_tx_priority(frame));
 
 exit:
-	k_mutex_unlock(&mcp->_mutex);
+	mcp_unlock(mcp);
 
 	return ret;
 }
@@ -339,7 +452,14 @@ int8_t mcp2515_recv(struct mcp2515_device *mcp, struct can_frame *frame)
 	__ASSERT_NOTNULL(mcp);
 	__ASSERT_NOTNULL(frame);
 
-	k_mutex_lock(&mcp->_mutex, K_FOREVER);
+#if CONFIG_MCP2515_INTERRUPT
+	struct k_msgq *const rx_msgq = mcp->_rx_msgq;
+	if (rx_msgq != NULL) {
+		return k_msgq_get(rx_msgq, frame, K_NO_WAIT);
+	}
+#endif
+
+	mcp_lock(mcp);
 
 	int8_t ret;
 	uint8_t status = read_status(mcp);
@@ -358,7 +478,7 @@ int8_t mcp2515_recv(struct mcp2515_device *mcp, struct can_frame *frame)
 		ret = -ENOMSG;
 	}
 
-	k_mutex_unlock(&mcp->_mutex);
+	mcp_unlock(mcp);
 
 	return ret;
 }
@@ -375,7 +495,7 @@ int8_t mcp2515_set_filter(struct mcp2515_device *mcp,
 		return -EINVAL;
 	}
 
-	k_mutex_lock(&mcp->_mutex, K_FOREVER);
+	mcp_lock(mcp);
 
 	set_mode(mcp, MCP_MODE_CONFIG);
 	k_msleep(CONFIG_MCP2515_DELAY_MS);
@@ -409,7 +529,7 @@ int8_t mcp2515_set_filter(struct mcp2515_device *mcp,
 	set_mode(mcp, MCP_MODE_NORMAL);
 	k_msleep(CONFIG_MCP2515_DELAY_MS);
 
-	k_mutex_unlock(&mcp->_mutex);
+	mcp_unlock(mcp);
 
 	return 0;
 }
@@ -424,7 +544,7 @@ mcp2515_set_mask(struct mcp2515_device *mcp, uint8_t index, uint8_t is_ext, uint
 		return -EINVAL;
 	}
 
-	k_mutex_lock(&mcp->_mutex, K_FOREVER);
+	mcp_lock(mcp);
 
 	set_mode(mcp, MCP_MODE_CONFIG);
 	k_msleep(CONFIG_MCP2515_DELAY_MS);
@@ -446,9 +566,380 @@ mcp2515_set_mask(struct mcp2515_device *mcp, uint8_t index, uint8_t is_ext, uint
 	set_mode(mcp, MCP_MODE_NORMAL);
 	k_msleep(CONFIG_MCP2515_DELAY_MS);
 
-	k_mutex_unlock(&mcp->_mutex);
+	mcp_unlock(mcp);
 
 	return 0;
 }
 
+#if CONFIG_MCP2515_INTERRUPT
+
+static void mcp_push_frame(struct mcp2515_device *mcp, uint8_t rxb_reg)
+{
+	struct can_frame frame;
+
+	int8_t ret;
+
+	/* The RXnIF flag is cleared when the chip select is released */
+	read_rx_buf(mcp, &frame, rxb_reg);
+
+	if (mcp->_rules != NULL) {
+		const struct can_sw_rule *const rule =
+			can_sw_filter_match(mcp->_rules, mcp->_rules_count, &frame);
+		if (rule == NULL) {
+			mcp->_stats.rx_rejected++;
+			return;
+		}
+
+		ret = can_sw_filter_dispatch(rule, &frame, mcp->_rx_msgq);
+	} else {
+		ret = k_msgq_put(mcp->_rx_msgq, &frame, K_NO_WAIT);
+	}
+
+	if (ret == 0) {
+		mcp->_stats.rx_frames++;
+	} else {
+		mcp->_stats.rx_queue_overruns++;
+	}
+}
+
+/* Requests are notified without holding the device lock, so that callbacks can
+ * queue new requests */
+static void mcp_tx_notify(struct mcp2515_device *mcp, struct mcp2515_tx_request *done)
+{
+	while (done != NULL) {
+		struct mcp2515_tx_request *const req = done;
+		done								 = req->_next;
+		req->_next							 = NULL;
+
+		if (req->sem != NULL) {
+			k_sem_give(req->sem);
+		}
+
+		if (req->callback != NULL) {
+			req->callback(mcp, req);
+		}
+	}
+}
+
+/* Complete the requests of the TX buffers whose transmission is done, they are
+ * added to the done list */
+static void mcp_tx_complete(struct mcp2515_device *mcp,
+							uint8_t status,
+							struct mcp2515_tx_request **done)
+{
+	for (uint8_t txb = 0u; txb < MCP_TXB_COUNT; txb++) {
+		if ((status & MCP_STATUS_TXIF(txb)) == 0u) continue;
+
+		modify_register(mcp, MCP_R_CANINTF, MCP_CANINTF_TXIF(txb), 0u);
+
+		/* NULL if sent with mcp2515_send() */
+		struct mcp2515_tx_request *const req = mcp->_tx_pending[txb];
+		if (req != NULL) {
+			mcp->_tx_pending[txb] = NULL;
+			mcp->_stats.tx_frames++;
+
+			req->status = 0;
+			req->_next	= *done;
+			*done		= req;
+		}
+	}
+}
+
+#define MCP_TX_RANK(_txp, _txb) ((int8_t)((_txp) * MCP_TXB_COUNT + (_txb)))
+
+/* The MCP2515 sends the pending buffer with the highest TXP first, then the one
+ * with the highest number, i.e. by decreasing rank (TXP * 3 + buffer).
+ *
+ * A frame must be ranked below the pending frames of higher or same priority
+ * (sent in order) and above the ones of lower priority. Its TXP is the highest
+ * one satisfying these constraints, up to its priority: consecutive frames of
+ * the same priority get a lower TXP when loaded in a buffer with a higher
+ * number, instead of waiting for all the buffers to drain.
+ *
+ * Return the TX buffer to load and set *txp, -1 if none can be used yet */
+static int8_t
+mcp_tx_pick_buffer(struct mcp2515_device *mcp, uint8_t status, uint8_t prio, uint8_t *txp)
+{
+	int8_t hi	= MCP_TX_RANK(MCP_TXBCTRL_TXP_MASK + 1u, 0u);
+	int8_t lo	= -1;
+	int8_t txb	= -1;
+	int8_t best = -1;
+
+	for (uint8_t i = 0u; i < MCP_TXB_COUNT; i++) {
+		const struct mcp2515_tx_request *const pending = mcp->_tx_pending[i];
+		if (pending == NULL) continue;
+
+		const int8_t rank = MCP_TX_RANK(pending->_txp, i);
+		if (pending->_prio >= prio) {
+			hi = MIN(hi, rank);
+		} else {
+			lo = MAX(lo, rank);
+		}
+	}
+
+	for (uint8_t i = 0u; i < MCP_TXB_COUNT; i++) {
+		if (mcp->_tx_pending[i] != NULL) continue;
+		if (status & MCP_STATUS_TXREQ(i)) continue;
+		if (hi <= (int8_t)i) continue;
+
+		const uint8_t t	  = MIN((uint8_t)(hi - 1 - i) / MCP_TXB_COUNT, prio);
+		const int8_t rank = MCP_TX_RANK(t, i);
+		if ((rank > lo) && (rank > best)) {
+			best = rank;
+			txb	 = i;
+			*txp = t;
+		}
+	}
+
+	return txb;
+}
+
+static void mcp_tx_refill(struct mcp2515_device *mcp, uint8_t status)
+{
+	struct mcp2515_tx_request *req;
+
+	while ((req = mcp->_tx_head) != NULL) {
+		uint8_t txp;
+		const int8_t txb = mcp_tx_pick_buffer(mcp, status, req->_prio, &txp);
+		if (txb < 0) break;
+
+		mcp->_tx_head		  = req->_next;
+		req->_next			  = NULL;
+		req->_txp			  = txp;
+		mcp->_tx_pending[txb] = req;
+
+		load_tx_buffer(mcp, txb, &req->frame, txp);
+		status |= MCP_STATUS_TXREQ(txb);
+	}
+}
+
+static void mcp_irq_work_handler(struct k_work *work)
+{
+	struct mcp2515_device *const mcp = CONTAINER_OF(work, struct mcp2515_device, _work);
+	struct mcp2515_tx_request *done	 = NULL;
+
+	/* Don't block the system workqueue while a thread holds the device, the
+	 * work is submitted again when the device is unlocked */
+	const uint8_t key = irq_lock();
+	if (mcp->_rx_msgq == NULL) {
+		/* Disabled, the work is not deferred anymore */
+		irq_unlock(key);
+		return;
+	}
+	if (mcp_lock_timeout(mcp, K_NO_WAIT) != 0) {
+		mcp->_work_deferred = 1u;
+		irq_unlock(key);
+		return;
+	}
+	irq_unlock(key);
+
+	if (mcp->_rx_msgq == NULL) {
+		/* Disabled in the meantime */
+		goto exit;
+	}
+
+	/* With rollover, RXB0 holds the oldest frame */
+	uint8_t status;
+	while ((status = read_status(mcp)) & (MCP_STATUS_RXIF_MASK | MCP_STATUS_TXIF_MASK)) {
+		if (status & MCP_STATUS_RX0IF) {
+			mcp_push_frame(mcp, MCP_READ_RX_AT_RXB0SIDH);
+		}
+		if (status & MCP_STATUS_RX1IF) {
+			mcp_push_frame(mcp, MCP_READ_RX_AT_RXB1SIDH);
+		}
+		if (status & MCP_STATUS_TXIF_MASK) {
+			mcp_tx_complete(mcp, status, &done);
+			mcp_tx_refill(mcp, read_status(mcp));
+		}
+	}
+
+	const uint8_t eflg = read_register(mcp, MCP_R_EFLG) & MCP_EFLG_RXOVR_MASK;
+	if (eflg != 0u) {
+		mcp->_stats.rx_hw_overruns += (eflg & MCP_EFLG_RX0OVR) ? 1u : 0u;
+		mcp->_stats.rx_hw_overruns += (eflg & MCP_EFLG_RX1OVR) ? 1u : 0u;
+		modify_register(mcp, MCP_R_EFLG, MCP_EFLG_RXOVR_MASK, 0u);
+		modify_register(mcp, MCP_R_CANINTF, MCP_CANINTF_ERRIF, 0u);
+	}
+
+	/* The INT pin is level triggered, the handler runs again if a frame was
+	 * received in the meantime */
+	exti_enable(mcp->_exti);
+
+exit:
+	mcp_unlock(mcp);
+
+	mcp_tx_notify(mcp, done);
+}
+
+void mcp2515_irq_handler(struct mcp2515_device *mcp)
+{
+	/* Masked until the RX buffers are read */
+	exti_disable(mcp->_exti);
+	k_system_workqueue_submit(&mcp->_work);
+}
+
+int8_t mcp2515_irq_enable(struct mcp2515_device *mcp, uint8_t exti, struct k_msgq *rx_msgq)
+{
+	Z_ARGS_CHECK(mcp && rx_msgq && (rx_msgq->msg_size == sizeof(struct can_frame)) &&
+				 (exti < EXTI_COUNT))
+	{
+		return -EINVAL;
+	}
+
+	int8_t ret = exti_configure(exti, ISC_LOW_LEVEL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	mcp_lock(mcp);
+
+	k_work_init(&mcp->_work, mcp_irq_work_handler);
+	memset(&mcp->_stats, 0x00u, sizeof(mcp->_stats));
+	mcp->_exti	  = exti;
+	mcp->_rx_msgq = rx_msgq;
+
+	modify_register(mcp, MCP_R_CANINTF,
+					MCP_CANINTF_TX0IF | MCP_CANINTF_TX1IF | MCP_CANINTF_TX2IF, 0u);
+	write_register(mcp, MCP_R_CANINTE,
+				   MCP_CANINTE_RX0IE | MCP_CANINTE_RX1IE | MCP_CANINTE_TX0IE |
+					   MCP_CANINTE_TX1IE | MCP_CANINTE_TX2IE);
+
+	/* Frames already received are read by the first interrupt */
+	exti_enable(exti);
+
+	mcp_unlock(mcp);
+
+	return 0;
+}
+
+int8_t mcp2515_irq_disable(struct mcp2515_device *mcp)
+{
+	Z_ARGS_CHECK(mcp) return -EINVAL;
+
+	struct mcp2515_tx_request *done = NULL;
+
+	mcp_lock(mcp);
+
+	if (mcp->_rx_msgq != NULL) {
+		exti_disable(mcp->_exti);
+		write_register(mcp, MCP_R_CANINTE, 0u);
+		mcp->_rx_msgq = NULL;
+	}
+
+	/* Abort the frames loaded in the TX buffers, a transmission in progress
+	 * is not aborted and completes within a frame time */
+	uint8_t aborted = 0u;
+	for (uint8_t txb = 0u; txb < MCP_TXB_COUNT; txb++) {
+		if (mcp->_tx_pending[txb] != NULL) {
+			modify_register(mcp, MCP_R_TXBCTRL(txb), MCP_TXBCTRL_TXREQ, 0u);
+			aborted |= MCP_STATUS_TXREQ(txb);
+		}
+	}
+
+	for (uint8_t n = 0u; (n < CONFIG_MCP2515_DELAY_MS) && (read_status(mcp) & aborted);
+		 n++) {
+		k_msleep(1u);
+	}
+
+	for (uint8_t txb = 0u; txb < MCP_TXB_COUNT; txb++) {
+		struct mcp2515_tx_request *const req = mcp->_tx_pending[txb];
+		if (req == NULL) continue;
+
+		mcp->_tx_pending[txb] = NULL;
+
+		/* The status matches what was sent on the bus */
+		const uint8_t ctrl = read_register(mcp, MCP_R_TXBCTRL(txb));
+		if (ctrl & (MCP_TXBCTRL_TXREQ | MCP_TXBCTRL_ABTF)) {
+			req->status = -ECANCELED;
+		} else {
+			req->status = 0;
+			mcp->_stats.tx_frames++;
+		}
+		modify_register(mcp, MCP_R_CANINTF, MCP_CANINTF_TXIF(txb), 0u);
+
+		req->_next = done;
+		done	   = req;
+	}
+
+	while (mcp->_tx_head != NULL) {
+		struct mcp2515_tx_request *const req = mcp->_tx_head;
+		mcp->_tx_head						 = req->_next;
+		req->status							 = -ECANCELED;
+		req->_next							 = done;
+		done								 = req;
+	}
+
+	mcp_unlock(mcp);
+
+	mcp_tx_notify(mcp, done);
+
+	return 0;
+}
+
+int8_t mcp2515_send_async(struct mcp2515_device *mcp, struct mcp2515_tx_request *req)
+{
+	Z_ARGS_CHECK(mcp && req) return -EINVAL;
+
+	int8_t ret = 0;
+
+	mcp_lock(mcp);
+
+	if (mcp->_rx_msgq == NULL) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	req->status = -EINPROGRESS;
+	req->_prio	= can_tx_priority(&req->frame);
+
+	/* Insert after the requests of higher or same priority */
+	struct mcp2515_tx_request **p = &mcp->_tx_head;
+	while ((*p != NULL) && ((*p)->_prio >= req->_prio)) {
+		p = &(*p)->_next;
+	}
+	req->_next = *p;
+	*p		   = req;
+
+	mcp_tx_refill(mcp, read_status(mcp));
+
+exit:
+	mcp_unlock(mcp);
+
+	return ret;
+}
+
+int8_t mcp2515_set_sw_filter(struct mcp2515_device *mcp,
+							 const struct can_sw_rule *rules,
+							 uint8_t count)
+{
+	Z_ARGS_CHECK(mcp && (rules || !count)) return -EINVAL;
+
+	mcp_lock(mcp);
+
+	mcp->_rules		  = rules;
+	mcp->_rules_count = count;
+
+	mcp_unlock(mcp);
+
+	return 0;
+}
+
+int8_t mcp2515_get_stats(struct mcp2515_device *mcp, struct mcp2515_stats *stats, bool reset)
+{
+	Z_ARGS_CHECK(mcp && stats) return -EINVAL;
+
+	mcp_lock(mcp);
+
+	*stats = mcp->_stats;
+	if (reset) {
+		memset(&mcp->_stats, 0x00u, sizeof(mcp->_stats));
+	}
+
+	mcp_unlock(mcp);
+
+	return 0;
+}
+
+#endif /* CONFIG_MCP2515_INTERRUPT */
+
 #endif /* CONFIG_DEVICE_MCP2515 */
\ No newline at end of file
@@ -13,7 +13,9 @@
 #include <avrtos/drivers/can.h>
 #include <avrtos/drivers/spi.h>
 #include <avrtos/kernel.h>
+#include <avrtos/msgq.h>
 #include <avrtos/mutex.h>
+#include <avrtos/workqueue.h>
 
 /**
  * MCP2515 CAN Controller Driver
@@ -76,12 +78,67 @@ struct mcp2515_config {
 	uint8_t flags : 4u;					  /**< Flags for interrupt and debug options */
 };
 
+/**
+ * @brief Statistics of the MCP2515 (interrupt-driven reception/transmission).
+ */
+struct mcp2515_stats {
+	uint16_t rx_frames;			/**< Frames pushed to the RX queue */
+	uint16_t rx_queue_overruns; /**< Frames dropped because the RX queue was full */
+	uint16_t rx_hw_overruns;	/**< Frames lost by the MCP2515 (RXnOVR flags) */
+	uint16_t tx_frames;			/**< Frames sent with mcp2515_send_async() */
+	uint16_t rx_rejected;		/**< Frames rejected by the software filter */
+};
+
+struct mcp2515_device;
+struct mcp2515_tx_request;
+
+/**
+ * @brief Completion callback of a TX request, called from the system workqueue.
+ */
+typedef void (*mcp2515_tx_callback_t)(struct mcp2515_device *mcp,
+									  struct mcp2515_tx_request *req);
+
+/**
+ * @brief TX request, queued with mcp2515_send_async().
+ *
+ * The structure must remain valid until the request is complete.
+ */
+struct mcp2515_tx_request {
+	struct mcp2515_tx_request *Z_PRIVATE(next); /**< Next request in the queue */
+	struct can_frame frame;						/**< Frame to send */
+	uint8_t Z_PRIVATE(prio);					/**< Priority, from the identifier */
+	uint8_t Z_PRIVATE(txp);						/**< TXP of the loaded buffer */
+
+	/** -EINPROGRESS while queued, 0 when sent, -ECANCELED if canceled */
+	int8_t status;
+
+	struct k_sem *sem;				/**< Given when complete (can be NULL) */
+	mcp2515_tx_callback_t callback; /**< Called when complete (can be NULL) */
+};
+
 /**
  * @brief MCP2515 device structure.
  */
 struct mcp2515_device {
 	struct spi_slave slave;			 /**< SPI slave structure */
 	struct k_mutex Z_PRIVATE(mutex); /**< Mutex for thread-safe access */
+
+#if CONFIG_MCP2515_INTERRUPT
+	struct k_work Z_PRIVATE(work);		/**< Deferred interrupt handling */
+	struct k_msgq *Z_PRIVATE(rx_msgq);	/**< Queue of received frames */
+	uint8_t Z_PRIVATE(exti);			/**< External interrupt of the INT pin */
+	uint8_t Z_PRIVATE(work_deferred);	/**< Work to submit when unlocked */
+	struct mcp2515_stats Z_PRIVATE(stats); /**< Statistics */
+
+	/** Software TX queue, sorted by priority */
+	struct mcp2515_tx_request *Z_PRIVATE(tx_head);
+	/** Requests loaded in the TX buffers */
+	struct mcp2515_tx_request *Z_PRIVATE(tx_pending)[3u];
+
+	/** Software acceptance filter */
+	const struct can_sw_rule *Z_PRIVATE(rules);
+	uint8_t Z_PRIVATE(rules_count);
+#endif
 };
 
 /**
@@ -91,7 +148,8 @@ struct mcp2515_device {
  *
  * @param mcp Pointer to the MCP2515 device structure.
  * @param config Pointer to the MCP2515 configuration structure.
- * @param spi_slave Pointer to the SPI slave structure.
+ * @param spi_slave Pointer to the SPI slave structure. If it is attached to a SPI
+ * bus (see spi_bus_attach()), the bus is locked for each access to the device.
  * @return int8_t 0 on success, negative value on error.
  */
 int8_t mcp2515_init(struct mcp2515_device *mcp,
@@ -101,7 +159,11 @@ int8_t mcp2515_init(struct mcp2515_device *mcp,
 /**
  * @brief Deinitialize the MCP2515 device.
  *
- * This function is not safe to be called from an ISR.
+ * Interrupt-driven operation is disabled first (see mcp2515_irq_disable()) and
+ * the pending interrupt handling is waited for.
+ *
+ * This function is not safe to be called from an ISR or from the system
+ * workqueue.
  *
  * @param mcp Pointer to the MCP2515 device structure.
  * @return int8_t 0 on success, negative value on error.
@@ -111,6 +173,9 @@ int8_t mcp2515_deinit(struct mcp2515_device *mcp);
 /**
  * @brief Send a CAN frame through the MCP2515.
  *
+ * The frame is loaded into a free TX buffer, -EBUSY is returned if none is
+ * available.
+ *
  * This function is not safe to be called from an ISR.
  *
  * @param mcp Pointer to the MCP2515 device structure.
@@ -122,6 +187,9 @@ int8_t mcp2515_send(struct mcp2515_device *mcp, const struct can_frame *frame);
 /**
  * @brief Receive a CAN frame through the MCP2515.
  *
+ * If interrupt-driven reception is enabled (see mcp2515_irq_enable()), the frame
+ * is taken from the RX message queue.
+ *
  * This function is not safe to be called from an ISR.
  *
  * @param mcp Pointer to the MCP2515 device structure.
@@ -162,6 +230,124 @@ int8_t mcp2515_set_mask(struct mcp2515_device *mcp,
 						uint8_t is_ext,
 						uint32_t mask);
 
+/**
+ * @brief Enable interrupt-driven reception.
+ *
+ * The INT pin of the MCP2515 must be connected to the external interrupt `exti`
+ * (e.g. INT0), which is configured as low level triggered. The application
+ * calls mcp2515_irq_handler() from the corresponding interrupt handler:
+ *
+ * ```c
+ * K_MSGQ_DEFINE(can_rx_msgq, sizeof(struct can_frame), 8u);
+ *
+ * ISR(INT0_vect)
+ * {
+ *     mcp2515_irq_handler(&mcp);
+ * }
+ *
+ * mcp2515_irq_enable(&mcp, INT0, &can_rx_msgq);
+ * ```
+ *
+ * The handler masks the external interrupt and submits a work item to the system
+ * workqueue, which reads both RX buffers with the READ RX BUFFER instruction until
+ * they are empty, pushes the frames to `rx_msgq` and unmasks the interrupt.
+ * Frames are dropped and counted if the queue is full.
+ *
+ * Consumers block on the message queue with k_msgq_get(), mcp2515_recv() reads
+ * from it without waiting.
+ *
+ * The RX and TX interrupts of the MCP2515 are enabled, TX buffers are refilled
+ * from the queue of mcp2515_send_async().
+ *
+ * Requires CONFIG_MCP2515_INTERRUPT.
+ *
+ * @param mcp Pointer to the MCP2515 device structure.
+ * @param exti External interrupt connected to the INT pin.
+ * @param rx_msgq Message queue of `struct can_frame` messages.
+ * @return int8_t 0 on success, negative value on error.
+ */
+int8_t mcp2515_irq_enable(struct mcp2515_device *mcp, uint8_t exti, struct k_msgq *rx_msgq);
+
+/**
+ * @brief Disable interrupt-driven reception and transmission.
+ *
+ * Queued TX requests are completed with -ECANCELED. Frames loaded in the TX
+ * buffers are aborted, the request of a frame whose transmission already
+ * started is completed as sent.
+ *
+ * @param mcp Pointer to the MCP2515 device structure.
+ * @return int8_t 0 on success, negative value on error.
+ */
+int8_t mcp2515_irq_disable(struct mcp2515_device *mcp);
+
+/**
+ * @brief Handle the interrupt of the MCP2515 INT pin.
+ *
+ * Must be called from the interrupt handler of the external interrupt given to
+ * mcp2515_irq_enable().
+ *
+ * @param mcp Pointer to the MCP2515 device structure.
+ */
+void mcp2515_irq_handler(struct mcp2515_device *mcp);
+
+/**
+ * @brief Queue a CAN frame for transmission.
+ *
+ * Requests are sorted by priority derived from the identifier (the two most
+ * significant bits, lower identifiers first) and loaded into the three TX
+ * buffers of the MCP2515, with TX priority (TXP) bits keeping this order. Buffers
+ * are refilled by the system workqueue when a transmission completes. Frames of
+ * the same priority are sent in order.
+ *
+ * Completion is signaled with req->sem and/or req->callback (called from the
+ * system workqueue).
+ *
+ * This function is not safe to be called from an ISR.
+ *
+ * Requires interrupt-driven reception/transmission (see mcp2515_irq_enable()).
+ *
+ * @param mcp Pointer to the MCP2515 device structure.
+ * @param req TX request to queue.
+ * @return int8_t 0 on success, -EINVAL if interrupts are not enabled.
+ */
+int8_t mcp2515_send_async(struct mcp2515_device *mcp, struct mcp2515_tx_request *req);
+
+/**
+ * @brief Set the software acceptance filter of the interrupt-driven reception.
+ *
+ * Each received frame is evaluated against the rules (see can_sw_filter_match())
+ * by the system workqueue, before being pushed to any queue: rejected frames are
+ * dropped and counted, accepted frames are pushed to the queue of the matching
+ * rule (or to the RX queue given to mcp2515_irq_enable() if the rule has none)
+ * and the callback of the rule is called.
+ *
+ * Callbacks are called from the system workqueue with the device locked, they
+ * must not call the functions of the device.
+ *
+ * To accept more identifiers than the 6 hardware filters allow, open the hardware
+ * masks (e.g. mcp2515_set_mask(mcp, 0u, CAN_STD_ID, 0u)) and use software rules.
+ *
+ * Requires CONFIG_MCP2515_INTERRUPT.
+ *
+ * @param mcp Pointer to the MCP2515 device structure.
+ * @param rules Rules, must remain valid while set (NULL to accept all frames).
+ * @param count Number of rules.
+ * @return int8_t 0 on success, negative value on error.
+ */
+int8_t mcp2515_set_sw_filter(struct mcp2515_device *mcp,
+							 const struct can_sw_rule *rules,
+							 uint8_t count);
+
+/**
+ * @brief Get the reception and transmission statistics.
+ *
+ * @param mcp Pointer to the MCP2515 device structure.
+ * @param stats Structure to fill.
+ * @param reset Reset the counters after reading them.
+ * @return int8_t 0 on success, negative value on error.
+ */
+int8_t mcp2515_get_stats(struct mcp2515_device *mcp, struct mcp2515_stats *stats, bool reset);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,7 +15,7 @@
 #define MCP_READ					0x03
 #define MCP_READ_RX_BUFFER(n, m)	(0x90 | ((n) << 2) | ((m) << 1))
 #define MCP_WRITE					0x02
-#define MCP_LOAD_TX_BUFFER(a, b, c) (0x40 | ((a) << 5) | ((b) << 6) | ((c) << 7))
+#define MCP_LOAD_TX_BUFFER(n, m)	(0x40 | ((n) << 1) | (m))
 #define MCP_RTS(tx0, tx1, tx2)		(0x80 | (tx0) | ((tx1) << 1) | ((tx2) << 2))
 #define MCP_READ_STATUS				0xA0
 #define MCP_RX_STATUS				0xB0
@@ -26,18 +26,29 @@
 #define MCP_READ_RX_AT_RXB1SIDH MCP_READ_RX_BUFFER(1, 0)
 #define MCP_READ_RX_AT_RXB1D0	MCP_READ_RX_BUFFER(1, 1)
 
-#define MCP_LOAD_TX_AT_TXB0SIDH MCP_LOAD_TX_BUFFER(0, 0, 0)
-#define MCP_LOAD_TX_AT_TXB0D0	MCP_LOAD_TX_BUFFER(0, 0, 1)
-#define MCP_LOAD_TX_AT_TXB1SIDH MCP_LOAD_TX_BUFFER(0, 1, 0)
-#define MCP_LOAD_TX_AT_TXB1D0	MCP_LOAD_TX_BUFFER(0, 1, 1)
-#define MCP_LOAD_TX_AT_TXB2SIDH MCP_LOAD_TX_BUFFER(1, 0, 0)
-#define MCP_LOAD_TX_AT_TXB2D0	MCP_LOAD_TX_BUFFER(1, 0, 1)
+#define MCP_LOAD_TX_AT_TXB0SIDH MCP_LOAD_TX_BUFFER(0, 0)
+#define MCP_LOAD_TX_AT_TXB0D0	MCP_LOAD_TX_BUFFER(0, 1)
+#define MCP_LOAD_TX_AT_TXB1SIDH MCP_LOAD_TX_BUFFER(1, 0)
+#define MCP_LOAD_TX_AT_TXB1D0	MCP_LOAD_TX_BUFFER(1, 1)
+#define MCP_LOAD_TX_AT_TXB2SIDH MCP_LOAD_TX_BUFFER(2, 0)
+#define MCP_LOAD_TX_AT_TXB2D0	MCP_LOAD_TX_BUFFER(2, 1)
 
 #define MCP_RTS_TXB0 MCP_RTS(1, 0, 0)
 #define MCP_RTS_TXB1 MCP_RTS(0, 1, 0)
 #define MCP_RTS_TXB2 MCP_RTS(0, 0, 1)
 #define MCP_RTS_ALL	 MCP_RTS(1, 1, 1)
 
+// TX buffer n (0 to 2)
+#define MCP_TXB_COUNT	3u
+#define MCP_R_TXBCTRL(n) (MCP_R_TXB0CTRL + ((n) << 4))
+#define MCP_RTS_TXB(n)	 (0x80 | (1 << (n)))
+
+// TXBnCTRL Register Bits/Masks
+
+#define MCP_TXBCTRL_TXP_MASK 0x03
+#define MCP_TXBCTRL_TXREQ	 0x08
+#define MCP_TXBCTRL_ABTF	 0x40
+
 // RXB Buffers offsets and masks
 #define MCP_RXB_SIDH 0
 #define MCP_RXB_SIDL 1
@@ -56,6 +67,7 @@
 #define MCP_R_CANCTRL 0x0F
 #define MCP_R_CANINTE 0x2B
 #define MCP_R_CANINTF 0x2C
+#define MCP_R_EFLG	  0x2D
 #define MCP_R_CNF3	  0x28
 #define MCP_R_CNF2	  0x29
 #define MCP_R_CNF1	  0x2A
@@ -113,6 +125,10 @@
 
 #define MCP_STATUS_RXIF_MASK  (MCP_STATUS_RX0IF | MCP_STATUS_RX1IF)
 #define MCP_STATUS_TXREQ_MASK (MCP_STATUS_TX0REQ | MCP_STATUS_TX1REQ | MCP_STATUS_TX2REQ)
+#define MCP_STATUS_TXIF_MASK  (MCP_STATUS_TX0IF | MCP_STATUS_TX1IF | MCP_STATUS_TX2IF)
+
+#define MCP_STATUS_TXREQ(n) (MCP_STATUS_TX0REQ << ((n) << 1))
+#define MCP_STATUS_TXIF(n)	(MCP_STATUS_TX0IF << ((n) << 1))
 
 // CANINTE Register Bits
 
@@ -136,6 +152,15 @@
 #define MCP_CANINTF_WAKIF 0x40
 #define MCP_CANINTF_MERRF 0x80
 
+#define MCP_CANINTF_TXIF(n) (MCP_CANINTF_TX0IF << (n))
+
+// EFLG Register Bits
+
+#define MCP_EFLG_RX0OVR 0x40
+#define MCP_EFLG_RX1OVR 0x80
+
+#define MCP_EFLG_RXOVR_MASK (MCP_EFLG_RX0OVR | MCP_EFLG_RX1OVR)
+
 // CANCTRL Register Bits
 #define MCP_MASK_MODE 0xE0
 
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sensor.h"
+
+#include <avrtos/systime.h>
+
+#if CONFIG_DEVICE_SENSOR
+
+#define K_MODULE K_MODULE_DEVICE
+
+static void sensor_xfer_done(struct i2c_transaction *xfer)
+{
+	struct sensor *const sensor = CONTAINER_OF(xfer, struct sensor, _xfer);
+
+	if (xfer->status != 0) {
+		sensor->errors++;
+		return;
+	}
+
+	int16_t value = sensor->decode(sensor->_raw);
+
+	if (sensor->filter != 0u) {
+		if (!sensor->_primed) {
+			sensor->_acc = (int32_t)value << sensor->filter;
+		} else {
+			sensor->_acc += value - (sensor->_acc >> sensor->filter);
+		}
+		value = sensor->_acc >> sensor->filter;
+	}
+
+	sensor->_primed			= 1u;
+	sensor->last.sensor		= sensor;
+	sensor->last.timestamp	= k_ticks_get_32();
+	sensor->last.value		= value;
+
+	if ((sensor->msgq != NULL) && (k_msgq_put(sensor->msgq, &sensor->last, K_NO_WAIT) != 0)) {
+		sensor->overruns++;
+	}
+}
+
+/**
+ * @brief Schedule the bus event at the earliest deadline of its sensors.
+ *
+ * Requires interrupts to be disabled.
+ */
+static void sensor_bus_schedule(struct sensor_bus *bus, uint32_t now)
+{
+	if (bus->_sensors == NULL) {
+		return;
+	}
+
+	/* Largest delay which is not K_FOREVER, later deadlines are rescheduled */
+	k_delta_t next = (k_delta_t)-2;
+
+	for (struct sensor *s = bus->_sensors; s != NULL; s = s->_next) {
+		const int32_t delta = (int32_t)(s->_deadline - now);
+
+		if (delta <= 0) {
+			next = 1u;
+			break;
+		} else if ((uint32_t)delta < next) {
+			next = delta;
+		}
+	}
+
+	k_event_schedule(&bus->_event, K_TICKS(next));
+}
+
+/* Called from the tick interrupt, or from the system workqueue if
+ * CONFIG_KERNEL_EVENTS_DEFERRED is enabled */
+static void sensor_bus_handler(struct k_event *event)
+{
+	struct sensor_bus *const bus = CONTAINER_OF(event, struct sensor_bus, _event);
+
+	/* The sensors list is shared with sensor_register() and sensor_unregister() */
+	const uint8_t key  = irq_lock();
+	const uint32_t now = k_ticks_get_32();
+
+	/* Reads due at this tick are queued together and run back to back */
+	for (struct sensor *s = bus->_sensors; s != NULL; s = s->_next) {
+		if ((int32_t)(s->_deadline - now) > 0) {
+			continue;
+		}
+
+		if (s->_xfer.status == -EINPROGRESS) {
+			/* Bus too slow for the period, skip this sample */
+			s->overruns++;
+		} else if (i2c_transaction_submit(bus->i2c, &s->_xfer) != 0) {
+			s->errors++;
+		}
+
+		s->_deadline += K_TIMEOUT_TICKS(s->period);
+		if ((int32_t)(s->_deadline - now) <= 0) {
+			/* More than one period late, restart from now */
+			s->_deadline = now + K_TIMEOUT_TICKS(s->period);
+		}
+	}
+
+	sensor_bus_schedule(bus, now);
+
+	irq_unlock(key);
+}
+
+int8_t sensor_bus_init(struct sensor_bus *bus, I2C_Device *i2c)
+{
+	Z_ARGS_CHECK(bus && i2c) return -EINVAL;
+
+	bus->i2c	  = i2c;
+	bus->_sensors = NULL;
+
+	return k_event_init(&bus->_event, sensor_bus_handler);
+}
+
+int8_t sensor_register(struct sensor_bus *bus, struct sensor *sensor)
+{
+	Z_ARGS_CHECK(bus && sensor && sensor->decode) return -EINVAL;
+	Z_ARGS_CHECK(sensor->len && (sensor->len <= SENSOR_RAW_MAX)) return -EINVAL;
+	Z_ARGS_CHECK(K_TIMEOUT_TICKS(sensor->period) &&
+				 !K_TIMEOUT_EQ(sensor->period, K_FOREVER))
+	return -EINVAL;
+	Z_ARGS_CHECK(sensor->filter <= SENSOR_FILTER_MAX) return -EINVAL;
+
+	/* Select the register, then read with a repeated start */
+	sensor->_msgs[0u] = (struct i2c_msg){
+		.buf   = &sensor->reg,
+		.len   = 1u,
+		.flags = I2C_MSG_WRITE,
+	};
+	sensor->_msgs[1u] = (struct i2c_msg){
+		.buf   = sensor->_raw,
+		.len   = sensor->len,
+		.flags = I2C_MSG_READ,
+	};
+
+	sensor->_xfer = (struct i2c_transaction){
+		.addr	  = sensor->addr,
+		.msgs	  = sensor->_msgs,
+		.num_msgs = 2u,
+		.status	  = 0,
+		.callback = sensor_xfer_done,
+	};
+
+	sensor->errors	 = 0u;
+	sensor->overruns = 0u;
+	sensor->_primed	 = 0u;
+
+	const uint8_t key  = irq_lock();
+	const uint32_t now = k_ticks_get_32();
+
+	sensor->_deadline = now + K_TIMEOUT_TICKS(sensor->period);
+	sensor->_next	  = bus->_sensors;
+	bus->_sensors	  = sensor;
+
+	k_event_cancel(&bus->_event);
+	sensor_bus_schedule(bus, now);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t sensor_unregister(struct sensor_bus *bus, struct sensor *sensor)
+{
+	Z_ARGS_CHECK(bus && sensor) return -EINVAL;
+
+	int8_t ret		  = -ENOENT;
+	const uint8_t key = irq_lock();
+
+	for (struct sensor **prev = &bus->_sensors; *prev != NULL; prev = &(*prev)->_next) {
+		if (*prev == sensor) {
+			/* The queued read cannot be canceled once started */
+			if ((sensor->_xfer.status == -EINPROGRESS) &&
+				(i2c_transaction_cancel(bus->i2c, &sensor->_xfer) == -EBUSY)) {
+				ret = -EBUSY;
+				break;
+			}
+
+			*prev		  = sensor->_next;
+			sensor->_next = NULL;
+			ret			  = 0;
+			break;
+		}
+	}
+
+	if (bus->_sensors == NULL) {
+		k_event_cancel(&bus->_event);
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+int8_t sensor_sample_get(struct sensor *sensor, struct sensor_sample *sample)
+{
+	Z_ARGS_CHECK(sensor && sample) return -EINVAL;
+
+	int8_t ret		  = -EAGAIN;
+	const uint8_t key = irq_lock();
+
+	if (sensor->_primed) {
+		*sample = sensor->last;
+		ret		= 0;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+#endif /* CONFIG_DEVICE_SENSOR */
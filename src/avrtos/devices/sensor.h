@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _AVRTOS_DEVICE_SENSOR_H
+#define _AVRTOS_DEVICE_SENSOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <avrtos/drivers/i2c.h>
+#include <avrtos/event.h>
+#include <avrtos/kernel.h>
+#include <avrtos/msgq.h>
+
+/**
+ * Periodic I2C sensor acquisition
+ *
+ * Sensors registered on a bus are read periodically without any thread: a
+ * kernel event wakes up at the next deadline and queues the reads of all the
+ * sensors due at this tick as I2C transactions, which run back to back from
+ * the TWI interrupt. On completion, the raw bytes are converted by the decode
+ * function of the sensor, optionally filtered and published with their
+ * timestamp to the message queue of the sensor.
+ *
+ * Requires CONFIG_DEVICE_SENSOR.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of bytes read per sample */
+#define SENSOR_RAW_MAX 4u
+
+/* Maximum filter setting, average of the last ~2^SENSOR_FILTER_MAX samples */
+#define SENSOR_FILTER_MAX 4u
+
+struct sensor;
+
+/**
+ * @brief Convert the raw bytes read from a sensor into a value, called from the
+ * TWI interrupt.
+ */
+typedef int16_t (*sensor_decode_t)(const uint8_t *raw);
+
+/**
+ * @brief Sample published to the message queue of a sensor.
+ */
+struct sensor_sample {
+	/* Sensor which produced the sample */
+	struct sensor *sensor;
+
+	/* Uptime in ticks when the sample was read */
+	uint32_t timestamp;
+
+	/* Decoded (and filtered) value */
+	int16_t value;
+};
+
+/**
+ * @brief Sensor read periodically, see sensor_register().
+ */
+struct sensor {
+	/* Next sensor of the bus (internal) */
+	struct sensor *_next;
+
+	/* 7-bit slave address */
+	uint8_t addr;
+
+	/* Register selected before each read (repeated start) */
+	uint8_t reg;
+
+	/* Number of bytes read (1 to SENSOR_RAW_MAX) */
+	uint8_t len;
+
+	/* Conversion of the raw bytes */
+	sensor_decode_t decode;
+
+	/* Time between two samples */
+	k_timeout_t period;
+
+	/* Exponential moving average over ~2^filter samples (0: disabled, up to
+	 * SENSOR_FILTER_MAX) */
+	uint8_t filter;
+
+	/* Queue receiving a struct sensor_sample per sample (can be NULL) */
+	struct k_msgq *msgq;
+
+	/* Last sample */
+	struct sensor_sample last;
+
+	/* Number of failed reads (NACK, bus error) */
+	uint16_t errors;
+
+	/* Number of samples lost: read still in progress at the next period or
+	 * message queue full */
+	uint16_t overruns;
+
+	/* Internal */
+	uint32_t Z_PRIVATE(deadline);
+	int32_t Z_PRIVATE(acc);
+	uint8_t Z_PRIVATE(primed);
+	uint8_t Z_PRIVATE(raw)[SENSOR_RAW_MAX];
+	struct i2c_msg Z_PRIVATE(msgs)[2u];
+	struct i2c_transaction Z_PRIVATE(xfer);
+};
+
+/**
+ * @brief Sensors sharing an I2C bus.
+ */
+struct sensor_bus {
+	/* I2C device of the bus, initialized by the application */
+	I2C_Device *i2c;
+
+	/* Internal */
+	struct sensor *Z_PRIVATE(sensors);
+	struct k_event Z_PRIVATE(event);
+};
+
+/**
+ * @brief Initialize a sensor bus.
+ *
+ * @param bus Bus to initialize.
+ * @param i2c I2C device, initialized with i2c_init().
+ * @return int8_t 0 on success, -EINVAL on invalid arguments.
+ */
+int8_t sensor_bus_init(struct sensor_bus *bus, I2C_Device *i2c);
+
+/**
+ * @brief Start reading a sensor periodically, the first sample is read after
+ * one period.
+ *
+ * @param bus Initialized bus.
+ * @param sensor Sensor, must remain valid until unregistered.
+ * @return int8_t 0 on success, -EINVAL on invalid sensor.
+ */
+int8_t sensor_register(struct sensor_bus *bus, struct sensor *sensor);
+
+/**
+ * @brief Stop reading a sensor.
+ *
+ * @param bus Bus the sensor is registered on.
+ * @param sensor Registered sensor.
+ * @return int8_t 0 on success, -EBUSY if a read is in progress (retry later),
+ * -ENOENT if the sensor is not registered.
+ */
+int8_t sensor_unregister(struct sensor_bus *bus, struct sensor *sensor);
+
+/**
+ * @brief Get the last sample of a sensor.
+ *
+ * @param sensor Sensor.
+ * @param sample Last sample.
+ * @return int8_t 0 on success, -EAGAIN if no sample was read yet.
+ */
+int8_t sensor_sample_get(struct sensor *sensor, struct sensor_sample *sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AVRTOS_DEVICE_SENSOR_H */
@@ -91,3 +91,28 @@ int16_t tcn75_select_read(struct tcn75_device *tcn75)
 
 	return temperature;
 }
+
+#if CONFIG_DEVICE_SENSOR
+static int16_t tcn75_decode(const uint8_t *raw)
+{
+	return tcn75_temp2int16(raw[0u], raw[1u]);
+}
+
+int8_t tcn75_sensor_init(struct sensor *sensor,
+						 struct tcn75_device *tcn75,
+						 k_timeout_t period,
+						 struct k_msgq *msgq)
+{
+	Z_ARGS_CHECK(sensor && tcn75) return -EINVAL;
+
+	sensor->addr   = tcn75->addr;
+	sensor->reg	   = TCN75_TEMPERATURE_REGISTER;
+	sensor->len	   = 2u;
+	sensor->decode = tcn75_decode;
+	sensor->period = period;
+	sensor->filter = 0u;
+	sensor->msgq   = msgq;
+
+	return 0;
+}
+#endif /* CONFIG_DEVICE_SENSOR */
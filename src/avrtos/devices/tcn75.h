@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <avrtos/devices/sensor.h>
 #include <avrtos/drivers/i2c.h>
 #include <avrtos/kernel.h>
 
@@ -117,6 +118,23 @@ int16_t tcn75_read(struct tcn75_device *tcn75);
  */
 int16_t tcn75_select_read(struct tcn75_device *tcn75);
 
+/**
+ * @brief Initialize a sensor reading the temperature of a TCN75 device
+ * periodically, the values are in 0.01°C resolution (see sensor_register()).
+ *
+ * Requires CONFIG_DEVICE_SENSOR.
+ *
+ * @param sensor Sensor to initialize, the filter can be set before registering
+ * @param tcn75 initialized TCN75 context
+ * @param period Time between two samples
+ * @param msgq Queue receiving the samples (can be NULL)
+ * @return int8_t 0 if success, negative value otherwise
+ */
+int8_t tcn75_sensor_init(struct sensor *sensor,
+						 struct tcn75_device *tcn75,
+						 k_timeout_t period,
+						 struct k_msgq *msgq);
+
 #ifdef __cplusplus
 }
 #endif
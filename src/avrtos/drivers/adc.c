@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "adc.h"
+
+#include <avrtos/assert.h>
+#include <avrtos/pm.h>
+
+#define K_MODULE K_MODULE_DRIVERS_ADC
+
+#define ADC_MUX_MASK  0x1Fu
+#define ADC_ADTS_MASK 0x07u
+
+#if CONFIG_DRIVERS_ADC_SEQUENCE
+static struct adc_sequence *adc_seq = NULL;
+#endif
+
+static void adc_select(uint8_t channel)
+{
+	ADC_DEVICE->ADMUXn = (ADC_DEVICE->ADMUXn & ~ADC_MUX_MASK) | (channel & ADC_MUX_MASK);
+#if defined(MUX5)
+	if (channel & 0x20u) {
+		ADC_DEVICE->ADCSRBn |= BIT(MUX5);
+	} else {
+		ADC_DEVICE->ADCSRBn &= ~BIT(MUX5);
+	}
+#endif
+}
+
+int8_t adc_init(const struct adc_config *config)
+{
+	Z_ARGS_CHECK(config && config->prescaler) return -EINVAL;
+
+	ADC_DEVICE->ADMUXn	= config->reference << REFS0;
+	ADC_DEVICE->ADCSRBn = 0u;
+	ADC_DEVICE->ADCSRAn = BIT(ADEN) | BIT(ADIF) | (config->prescaler << ADPS0);
+
+	return 0;
+}
+
+void adc_deinit(void)
+{
+#if CONFIG_DRIVERS_ADC_SEQUENCE
+	adc_sequence_stop();
+#endif
+
+	ADC_DEVICE->ADCSRAn = 0u;
+}
+
+int8_t adc_read(uint8_t channel, uint16_t *value)
+{
+	Z_ARGS_CHECK(value) return -EINVAL;
+
+#if CONFIG_DRIVERS_ADC_SEQUENCE
+	if (adc_seq != NULL) {
+		return -EBUSY;
+	}
+#endif
+
+	adc_select(channel);
+
+	ADC_DEVICE->ADCSRAn |= BIT(ADSC);
+	while (ADC_DEVICE->ADCSRAn & BIT(ADSC)) {
+	}
+
+	*value = ADC_DEVICE->ADCn;
+
+	return 0;
+}
+
+#if CONFIG_DRIVERS_ADC_SEQUENCE
+
+/* A new conversion is only triggered on a rising edge of the flag of the
+ * trigger source, which is not cleared by hardware as its interrupt is disabled */
+static void adc_clear_trigger_flag(adc_trigger_t trigger)
+{
+	switch (trigger) {
+	case ADC_TRIGGER_ANALOG_COMPARATOR:
+		ACSR |= BIT(ACI);
+		break;
+	case ADC_TRIGGER_EXTI0:
+		EIFR = BIT(INTF0);
+		break;
+	case ADC_TRIGGER_TIMER0_COMPA:
+		TIFR0 = BIT(OCF0A);
+		break;
+	case ADC_TRIGGER_TIMER0_OVF:
+		TIFR0 = BIT(TOV0);
+		break;
+	case ADC_TRIGGER_TIMER1_COMPB:
+		TIFR1 = BIT(OCF1B);
+		break;
+	case ADC_TRIGGER_TIMER1_OVF:
+		TIFR1 = BIT(TOV1);
+		break;
+	case ADC_TRIGGER_TIMER1_CAPT:
+		TIFR1 = BIT(ICF1);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Return the thread woken up if a block is complete */
+static struct k_thread *adc_sequence_store_frame(struct adc_sequence *seq)
+{
+	uint16_t *const block = seq->buf + (seq->_fill ? seq->block_len : 0u);
+
+	for (uint8_t i = 0u; i < seq->channels_count; i++) {
+		block[seq->_pos++] = seq->_acc[i] >> seq->oversampling;
+		seq->_acc[i]	   = 0u;
+	}
+
+	if (seq->_pos < seq->block_len) {
+		return NULL;
+	}
+
+	seq->_pos = 0u;
+
+	if (seq->_ready) {
+		/* The other block is still held by the consumer, fill the current
+		 * block again */
+		seq->overruns++;
+		return NULL;
+	}
+
+	seq->_ready		= 1u;
+	seq->_ready_idx = seq->_fill;
+	seq->_fill ^= 1u;
+
+	return k_sem_give(&seq->_sem);
+}
+
+ISR(ADC_vect)
+{
+	struct adc_sequence *const seq = adc_seq;
+	struct k_thread *thread		   = NULL;
+
+	if (seq == NULL) {
+		return;
+	}
+
+	adc_clear_trigger_flag(seq->trigger);
+
+	seq->_acc[seq->_ch] += ADC_DEVICE->ADCn;
+
+	if (++seq->_ch == seq->channels_count) {
+		seq->_ch = 0u;
+
+		if (++seq->_scans == BIT(seq->oversampling)) {
+			seq->_scans = 0u;
+			thread		= adc_sequence_store_frame(seq);
+		}
+	}
+
+	/* The next conversion is not started before the next trigger */
+	if (seq->channels_count > 1u) {
+		adc_select(seq->channels[seq->_ch]);
+	}
+
+	k_yield_from_isr_cond(thread);
+}
+
+int8_t adc_sequence_start(struct adc_sequence *seq)
+{
+	Z_ARGS_CHECK(seq && seq->channels && seq->buf) return -EINVAL;
+	Z_ARGS_CHECK(seq->channels_count && (seq->channels_count <= ADC_SEQUENCE_CHANNELS_MAX))
+	return -EINVAL;
+	Z_ARGS_CHECK(seq->block_len && (seq->block_len % seq->channels_count == 0u))
+	return -EINVAL;
+	Z_ARGS_CHECK(seq->oversampling <= 6u) return -EINVAL;
+
+	/* In free running mode, the next conversion starts before the channel can
+	 * be changed */
+	if ((seq->trigger == ADC_TRIGGER_FREE_RUNNING) && (seq->channels_count > 1u)) {
+		return -ENOTSUP;
+	}
+
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	if (adc_seq != NULL) {
+		ret = -EBUSY;
+		goto exit;
+	}
+
+	for (uint8_t i = 0u; i < ADC_SEQUENCE_CHANNELS_MAX; i++) {
+		seq->_acc[i] = 0u;
+	}
+	seq->_pos	   = 0u;
+	seq->_ch	   = 0u;
+	seq->_scans	   = 0u;
+	seq->_fill	   = 0u;
+	seq->_ready	   = 0u;
+	seq->overruns  = 0u;
+	k_sem_init(&seq->_sem, 0u, 1u);
+
+	adc_seq = seq;
+
+#if CONFIG_KERNEL_PM
+	/* The trigger sources are clocked by clk_IO */
+	k_pm_require(K_PM_CAP_CLK_IO);
+#endif
+
+	adc_select(seq->channels[0u]);
+	ADC_DEVICE->ADCSRBn = (ADC_DEVICE->ADCSRBn & ~ADC_ADTS_MASK) | seq->trigger;
+	adc_clear_trigger_flag(seq->trigger);
+	ADC_DEVICE->ADCSRAn |= BIT(ADATE) | BIT(ADIE) | BIT(ADIF);
+
+	if (seq->trigger == ADC_TRIGGER_FREE_RUNNING) {
+		ADC_DEVICE->ADCSRAn |= BIT(ADSC);
+	}
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+int8_t adc_sequence_stop(void)
+{
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	if (adc_seq == NULL) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	ADC_DEVICE->ADCSRAn = (ADC_DEVICE->ADCSRAn & ~(BIT(ADATE) | BIT(ADIE))) | BIT(ADIF);
+	ADC_DEVICE->ADCSRBn &= ~ADC_ADTS_MASK;
+	adc_seq = NULL;
+
+#if CONFIG_KERNEL_PM
+	k_pm_release(K_PM_CAP_CLK_IO);
+#endif
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+int8_t adc_sequence_block_get(struct adc_sequence *seq,
+							  uint16_t **block,
+							  k_timeout_t timeout)
+{
+	Z_ARGS_CHECK(seq && block) return -EINVAL;
+
+	const int8_t ret = k_sem_take(&seq->_sem, timeout);
+	if (ret == 0) {
+		*block = seq->buf + (seq->_ready_idx ? seq->block_len : 0u);
+	}
+
+	return ret;
+}
+
+void adc_sequence_block_release(struct adc_sequence *seq)
+{
+	const uint8_t key = irq_lock();
+	seq->_ready		  = 0u;
+	irq_unlock(key);
+}
+
+#endif /* CONFIG_DRIVERS_ADC_SEQUENCE */
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _AVRTOS_DRIVERS_ADC_H_
+#define _AVRTOS_DRIVERS_ADC_H_
+
+#include <avrtos/drivers.h>
+#include <avrtos/kernel.h>
+#include <avrtos/semaphore.h>
+
+/**
+ * ADC driver
+ *
+ * Single conversions are done with adc_read(), which polls the end of the
+ * conversion (13 ADC clock cycles, 25 for the first conversion).
+ *
+ * If CONFIG_DRIVERS_ADC_SEQUENCE is enabled, a sequence of channels can be
+ * sampled in the background with adc_sequence_start(): each conversion is
+ * started by the hardware auto trigger source (e.g. a timer compare match),
+ * the ISR(ADC_vect) interrupt handler selects the next channel of the sequence,
+ * averages the conversions and fills two blocks of samples alternately. Each
+ * complete block is handed to the consumer thread (see adc_sequence_block_get()).
+ *
+ * The driver only relies on the ADC registers and interrupt, so it runs
+ * unmodified under simulators which inject analog values (e.g. simavr).
+ */
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * @brief ADC device registers.
+ */
+typedef struct {
+	__IO uint16_t ADCn;	  /* Data register (ADCL, ADCH) */
+	__IO uint8_t ADCSRAn; /* Control and status register A */
+	__IO uint8_t ADCSRBn; /* Control and status register B */
+	__IO uint8_t ADMUXn;  /* Multiplexer selection register */
+	__IO uint8_t DIDR2n;  /* Digital input disable register 2 (reserved on ATmega328P) */
+	__IO uint8_t DIDR0n;  /* Digital input disable register 0 */
+	__IO uint8_t DIDR1n;  /* Digital input disable register 1 */
+} ADC_Device;
+
+#define ADC_BASE_ADDR (AVR_IO_BASE_ADDR + 0x0078u)
+#define ADC_DEVICE	  ((ADC_Device *)ADC_BASE_ADDR)
+
+/* Maximum value of a conversion (10 bits) */
+#define ADC_MAX_VALUE 0x3FFu
+
+/* Single ended input channels (MUX5:0 value) */
+#if defined(__AVR_ATmega2560__)
+#define ADC_CHANNEL(_n)		 (((_n) < 8u) ? (_n) : (0x20u | ((_n)-8u)))
+#define ADC_CHANNEL_BANDGAP	 0x1Eu /* 1.1V internal reference */
+#define ADC_CHANNEL_GND		 0x1Fu
+#define ADC_CHANNELS_COUNT	 16u
+#else
+#define ADC_CHANNEL(_n)		 (_n)
+#define ADC_CHANNEL_TEMP	 0x08u /* Internal temperature sensor */
+#define ADC_CHANNEL_BANDGAP	 0x0Eu /* 1.1V internal reference */
+#define ADC_CHANNEL_GND		 0x0Fu
+#define ADC_CHANNELS_COUNT	 8u
+#endif
+
+/* Voltage reference (REFS1:0) */
+typedef enum {
+	ADC_REFERENCE_AREF = 0u, /* External AREF pin */
+	ADC_REFERENCE_AVCC = 1u, /* AVCC with external capacitor on AREF */
+#if defined(__AVR_ATmega2560__)
+	ADC_REFERENCE_INTERNAL_1V1	= 2u,
+	ADC_REFERENCE_INTERNAL_2V56 = 3u,
+#else
+	ADC_REFERENCE_INTERNAL_1V1 = 3u,
+#endif
+} adc_reference_t;
+
+/* ADC clock prescaler (ADPS2:0), the ADC clock should be between 50kHz and
+ * 200kHz for a 10 bits resolution (e.g. ADC_PRESCALER_128 for F_CPU = 16MHz) */
+typedef enum {
+	ADC_PRESCALER_2	  = 1u,
+	ADC_PRESCALER_4	  = 2u,
+	ADC_PRESCALER_8	  = 3u,
+	ADC_PRESCALER_16  = 4u,
+	ADC_PRESCALER_32  = 5u,
+	ADC_PRESCALER_64  = 6u,
+	ADC_PRESCALER_128 = 7u,
+} adc_prescaler_t;
+
+/** ADC configuration (1 byte) */
+struct adc_config {
+	/* Voltage reference */
+	adc_reference_t reference : 2u;
+
+	/* ADC clock prescaler */
+	adc_prescaler_t prescaler : 3u;
+};
+
+/**
+ * @brief Initialize and enable the ADC.
+ *
+ * @param config Configuration to use.
+ * @return int8_t 0 on success, -EINVAL on invalid configuration.
+ */
+int8_t adc_init(const struct adc_config *config);
+
+/**
+ * @brief Disable the ADC.
+ *
+ * A running sequence is stopped.
+ */
+void adc_deinit(void);
+
+/**
+ * @brief Convert a single channel, the function polls the end of the conversion.
+ *
+ * @param channel Input channel (ADC_CHANNEL(n) or ADC_CHANNEL_*).
+ * @param value Result of the conversion (0 to ADC_MAX_VALUE).
+ * @return int8_t 0 on success, -EBUSY if a sequence is running.
+ */
+int8_t adc_read(uint8_t channel, uint16_t *value);
+
+/* Auto trigger source of the conversions of a sequence (ADTS2:0) */
+typedef enum {
+	/* Conversions are chained, single channel sequences only */
+	ADC_TRIGGER_FREE_RUNNING	  = 0u,
+	ADC_TRIGGER_ANALOG_COMPARATOR = 1u,
+	ADC_TRIGGER_EXTI0			  = 2u,
+	ADC_TRIGGER_TIMER0_COMPA	  = 3u,
+	ADC_TRIGGER_TIMER0_OVF		  = 4u,
+	ADC_TRIGGER_TIMER1_COMPB	  = 5u,
+	ADC_TRIGGER_TIMER1_OVF		  = 6u,
+	ADC_TRIGGER_TIMER1_CAPT		  = 7u,
+} adc_trigger_t;
+
+/* Maximum number of channels of a sequence */
+#define ADC_SEQUENCE_CHANNELS_MAX 8u
+
+/**
+ * @brief Sequence of channels sampled in the background (see
+ * adc_sequence_start()).
+ *
+ * Each trigger converts the next channel of the sequence. A frame (one sample
+ * per channel, in the order of the sequence) is stored in the current block
+ * every 2^oversampling complete scans of the sequence, each sample being the
+ * average of the 2^oversampling conversions of its channel.
+ *
+ * The buffer holds two blocks of block_len samples: while a block is held by
+ * the consumer thread, the other one is filled. If the other block is not
+ * released when the current one is complete, the current block is discarded
+ * and filled again (overrun).
+ *
+ * The interrupt of the trigger source must not be enabled, its flag is cleared
+ * by the driver after each conversion to allow the next trigger.
+ */
+struct adc_sequence {
+	/* Channels to convert (ADC_CHANNEL(n) or ADC_CHANNEL_*) */
+	const uint8_t *channels;
+
+	/* Number of channels (1 to ADC_SEQUENCE_CHANNELS_MAX) */
+	uint8_t channels_count;
+
+	/* Auto trigger source */
+	adc_trigger_t trigger : 3u;
+
+	/* Number of conversions averaged per sample, as a power of 2 (0 to 6) */
+	uint8_t oversampling : 3u;
+
+	/* Buffer of 2 * block_len samples */
+	uint16_t *buf;
+
+	/* Number of samples per block, multiple of channels_count */
+	uint16_t block_len;
+
+	/* Number of blocks discarded because the consumer was too slow */
+	uint16_t overruns;
+
+	/* Internal */
+	uint16_t Z_PRIVATE(acc)[ADC_SEQUENCE_CHANNELS_MAX];
+	uint16_t Z_PRIVATE(pos);
+	uint8_t Z_PRIVATE(ch);
+	uint8_t Z_PRIVATE(scans);
+	uint8_t Z_PRIVATE(fill) : 1u;
+	uint8_t Z_PRIVATE(ready) : 1u;
+	uint8_t Z_PRIVATE(ready_idx) : 1u;
+	struct k_sem Z_PRIVATE(sem);
+};
+
+/**
+ * @brief Start sampling a sequence of channels in the background.
+ *
+ * The trigger source (e.g. a timer in CTC mode) must be configured by the
+ * application and defines the conversion rate.
+ *
+ * Requires CONFIG_DRIVERS_ADC_SEQUENCE.
+ *
+ * @param seq Sequence, must remain valid until the sequence is stopped.
+ * @return int8_t 0 on success, -EINVAL on invalid sequence, -ENOTSUP for a
+ * free running multi-channel sequence, -EBUSY if a sequence is running.
+ */
+int8_t adc_sequence_start(struct adc_sequence *seq);
+
+/**
+ * @brief Stop the running sequence.
+ *
+ * @return int8_t 0 on success, -EINVAL if no sequence is running.
+ */
+int8_t adc_sequence_stop(void);
+
+/**
+ * @brief Wait for the next complete block of samples.
+ *
+ * The block is held by the caller until adc_sequence_block_release() is called.
+ *
+ * @param seq Running sequence.
+ * @param block Pointer to the block of block_len samples.
+ * @param timeout Maximum time to wait.
+ * @return int8_t 0 on success, -ETIMEDOUT if the timeout expired.
+ */
+int8_t adc_sequence_block_get(struct adc_sequence *seq,
+							  uint16_t **block,
+							  k_timeout_t timeout);
+
+/**
+ * @brief Release the block returned by adc_sequence_block_get().
+ *
+ * @param seq Running sequence.
+ */
+void adc_sequence_block_release(struct adc_sequence *seq);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _AVRTOS_DRIVERS_ADC_H_ */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "can.h"
+
+static bool table_contains(const struct can_sw_rule *rule, uint32_t id)
+{
+	uint8_t lo = 0u;
+	uint8_t hi = rule->table.count;
+
+	while (lo < hi) {
+		const uint8_t mid  = (lo + hi) >> 1u;
+		const uint32_t cur = rule->is_ext ? rule->table.ids32[mid] : rule->table.ids16[mid];
+
+		if (cur == id) {
+			return true;
+		} else if (cur < id) {
+			lo = mid + 1u;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return false;
+}
+
+const struct can_sw_rule *
+can_sw_filter_match(const struct can_sw_rule *rules, uint8_t count, const struct can_frame *frame)
+{
+	Z_ARGS_CHECK(rules && frame) return NULL;
+
+	const uint32_t id = frame->id;
+
+	for (const struct can_sw_rule *rule = rules; rule < rules + count; rule++) {
+		if (rule->is_ext != frame->is_ext) continue;
+
+		switch (rule->type) {
+		case CAN_SW_RULE_TABLE:
+			if (table_contains(rule, id)) return rule;
+			break;
+		case CAN_SW_RULE_RANGE:
+			if ((id >= rule->range.min) && (id <= rule->range.max)) return rule;
+			break;
+		case CAN_SW_RULE_MASK:
+			if (((id ^ rule->match.id) & rule->match.mask) == 0u) return rule;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+int8_t can_sw_filter_dispatch(const struct can_sw_rule *rule,
+							  const struct can_frame *frame,
+							  struct k_msgq *default_msgq)
+{
+	Z_ARGS_CHECK(rule && frame) return -EINVAL;
+
+	int8_t ret				   = 0;
+	struct k_msgq *const msgq = rule->msgq ? rule->msgq : default_msgq;
+
+	if ((msgq != NULL) && (k_msgq_put(msgq, frame, K_NO_WAIT) != 0)) {
+		ret = -ENOMEM;
+	}
+
+	if (rule->callback != NULL) {
+		rule->callback(frame, rule->user_data);
+	}
+
+	return ret;
+}
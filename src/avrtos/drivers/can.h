@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #include <avrtos/drivers.h>
+#include <avrtos/msgq.h>
 
 #define CAN_STD_ID_MASK 0x7FFu
 #define CAN_EXT_ID_MASK 0x1FFFFFFFu
@@ -34,4 +35,131 @@ typedef struct can_frame {
 	uint32_t _reserved : 1u;
 } __attribute__((packed)) can_frame_t;
 
+/**
+ * Software acceptance filtering
+ *
+ * Rules are evaluated in order on each received frame, the first matching rule
+ * accepts the frame and dispatches it to its message queue and/or callback.
+ * Frames matching no rule are rejected.
+ */
+
+/* Rule types */
+#define CAN_SW_RULE_TABLE 0u /**< Identifier in a sorted table (binary search) */
+#define CAN_SW_RULE_RANGE 1u /**< Identifier in [min, max] */
+#define CAN_SW_RULE_MASK  2u /**< (identifier & mask) == (id & mask) */
+
+/**
+ * @brief Callback of a software filter rule.
+ */
+typedef void (*can_rx_callback_t)(const struct can_frame *frame, void *user_data);
+
+/**
+ * @brief Software acceptance filter rule.
+ */
+struct can_sw_rule {
+	uint8_t type : 2u;	 /**< CAN_SW_RULE_* */
+	uint8_t is_ext : 1u; /**< Apply to extended (1) or standard (0) frames */
+
+	union {
+		/* CAN_SW_RULE_TABLE, identifiers sorted in ascending order, 16-bit entries
+		 * for standard identifiers and 32-bit entries for extended ones */
+		struct {
+			union {
+				const uint16_t *ids16;
+				const uint32_t *ids32;
+			};
+			uint8_t count;
+		} table;
+
+		/* CAN_SW_RULE_RANGE */
+		struct {
+			uint32_t min;
+			uint32_t max;
+		} range;
+
+		/* CAN_SW_RULE_MASK */
+		can_filter_t match;
+	};
+
+	/* Queue of `struct can_frame` accepted frames are pushed to (can be NULL) */
+	struct k_msgq *msgq;
+
+	/* Called with accepted frames (can be NULL) */
+	can_rx_callback_t callback;
+	void *user_data;
+};
+
+/* Rules initializers, for standard (_STD) and extended (_EXT) identifiers. The
+ * identifiers of a table rule are uint16_t for standard identifiers and uint32_t
+ * for extended ones */
+#define CAN_SW_RULE_TABLE_STD(_ids, _msgq)                                               \
+	{                                                                                    \
+		.type = CAN_SW_RULE_TABLE, .is_ext = CAN_STD_ID,                                 \
+		.table = {.ids16 = (_ids), .count = ARRAY_SIZE(_ids)}, .msgq = (_msgq),          \
+	}
+
+#define CAN_SW_RULE_RANGE_STD(_min, _max, _msgq)                                         \
+	{                                                                                    \
+		.type = CAN_SW_RULE_RANGE, .is_ext = CAN_STD_ID,                                 \
+		.range = {.min = (_min), .max = (_max)}, .msgq = (_msgq),                        \
+	}
+
+#define CAN_SW_RULE_MASK_STD(_id, _mask, _msgq)                                          \
+	{                                                                                    \
+		.type = CAN_SW_RULE_MASK, .is_ext = CAN_STD_ID,                                  \
+		.match = {.id = (_id), .mask = (_mask)}, .msgq = (_msgq),                        \
+	}
+
+#define CAN_SW_RULE_TABLE_EXT(_ids, _msgq)                                               \
+	{                                                                                    \
+		.type = CAN_SW_RULE_TABLE, .is_ext = CAN_EXT_ID,                                 \
+		.table = {.ids32 = (_ids), .count = ARRAY_SIZE(_ids)}, .msgq = (_msgq),          \
+	}
+
+#define CAN_SW_RULE_RANGE_EXT(_min, _max, _msgq)                                         \
+	{                                                                                    \
+		.type = CAN_SW_RULE_RANGE, .is_ext = CAN_EXT_ID,                                 \
+		.range = {.min = (_min), .max = (_max)}, .msgq = (_msgq),                        \
+	}
+
+#define CAN_SW_RULE_MASK_EXT(_id, _mask, _msgq)                                          \
+	{                                                                                    \
+		.type = CAN_SW_RULE_MASK, .is_ext = CAN_EXT_ID,                                  \
+		.match = {.id = (_id), .mask = (_mask)}, .msgq = (_msgq),                        \
+	}
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * @brief Find the first rule accepting a frame.
+ *
+ * @param rules Rules to evaluate, in order.
+ * @param count Number of rules.
+ * @param frame Received frame.
+ * @return const struct can_sw_rule* Matching rule, NULL if the frame is rejected.
+ */
+const struct can_sw_rule *
+can_sw_filter_match(const struct can_sw_rule *rules, uint8_t count, const struct can_frame *frame);
+
+/**
+ * @brief Dispatch a frame accepted by a rule.
+ *
+ * The frame is pushed to rule->msgq without waiting (or to `default_msgq` if
+ * rule->msgq is NULL) and rule->callback is called.
+ *
+ * @param rule Matching rule.
+ * @param frame Received frame.
+ * @param default_msgq Queue used if the rule has none (can be NULL).
+ * @return int8_t 0 on success, -ENOMEM if the queue is full.
+ */
+int8_t can_sw_filter_dispatch(const struct can_sw_rule *rule,
+							  const struct can_frame *frame,
+							  struct k_msgq *default_msgq);
+
+#if defined(__cplusplus)
+}
+#endif
+
 #endif /* _AVRTOS_DRIVERS_CAN */
\ No newline at end of file
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "eeprom.h"
+
+#include <string.h>
+
+#include <avrtos/assert.h>
+#include <avrtos/pm.h>
+
+#include <util/crc16.h>
+
+/* EEPM1:0 programming modes */
+#define EEPROM_MODE_ERASE_WRITE (0x00u << EEPM0) /* 3.4ms */
+#define EEPROM_MODE_ERASE		(0x01u << EEPM0) /* 1.8ms */
+#define EEPROM_MODE_WRITE		(0x02u << EEPM0) /* 1.8ms */
+
+/* Requires the EEPROM not to be programming */
+static uint8_t eeprom_read_byte_locked(uint16_t addr)
+{
+	EEPROM_DEVICE->EEARn = addr;
+	EEPROM_DEVICE->EECRn |= BIT(EERE);
+	return EEPROM_DEVICE->EEDRn;
+}
+
+void eeprom_read(uint16_t addr, void *buf, uint16_t len)
+{
+	uint8_t *p = buf;
+
+	while (len--) {
+		uint8_t key = irq_lock();
+
+		while (EEPROM_DEVICE->EECRn & BIT(EEPE)) {
+			irq_unlock(key);
+#if CONFIG_DRIVERS_EEPROM_ASYNC
+			k_yield();
+#endif
+			key = irq_lock();
+		}
+
+		*p++ = eeprom_read_byte_locked(addr++);
+
+		irq_unlock(key);
+	}
+}
+
+#if CONFIG_DRIVERS_EEPROM_ASYNC
+
+static struct eeprom_write *q_head = NULL;
+static struct eeprom_write *q_tail = NULL;
+
+static struct k_thread *eeprom_notify(struct eeprom_write *req)
+{
+	struct k_thread *thread = NULL;
+
+	if (req->sem != NULL) {
+		thread = k_sem_give(req->sem);
+	}
+
+	if (req->callback != NULL) {
+		req->callback(req);
+	}
+
+	return thread;
+}
+
+/* Triggered as long as EERIE is set and no byte is being programmed */
+ISR(EE_READY_vect)
+{
+	struct k_thread *thread = NULL;
+
+	while (q_head != NULL) {
+		struct eeprom_write *const req = q_head;
+
+		while (req->_pos < req->len) {
+			const uint16_t addr = req->addr + req->_pos;
+			const uint8_t val	= req->data[req->_pos++];
+			const uint8_t old	= eeprom_read_byte_locked(addr);
+
+			if (old == val) {
+				continue;
+			}
+
+			uint8_t mode;
+			if (val == 0xFFu) {
+				mode = EEPROM_MODE_ERASE;
+			} else if ((old & val) == val) {
+				/* Bits are only cleared */
+				mode = EEPROM_MODE_WRITE;
+			} else {
+				mode = EEPROM_MODE_ERASE_WRITE;
+			}
+
+			/* EEPE must be set within four cycles after EEMPE */
+			EEPROM_DEVICE->EEDRn = val;
+			EEPROM_DEVICE->EECRn = mode | BIT(EERIE) | BIT(EEMPE);
+			EEPROM_DEVICE->EECRn |= BIT(EEPE);
+
+			goto exit;
+		}
+
+		/* The callback may queue new requests */
+		q_head = req->_next;
+		if (q_head == NULL) {
+			q_tail = NULL;
+		}
+
+		req->_next	= NULL;
+		req->status = 0;
+
+		struct k_thread *const woken = eeprom_notify(req);
+		if (woken != NULL) {
+			thread = woken;
+		}
+	}
+
+	EEPROM_DEVICE->EECRn &= ~BIT(EERIE);
+#if CONFIG_KERNEL_PM
+	k_pm_release(K_PM_CAP_EEPROM);
+#endif
+
+exit:
+	k_yield_from_isr_cond(thread);
+}
+
+int8_t eeprom_write_submit(struct eeprom_write *req)
+{
+	Z_ARGS_CHECK(req && req->data && req->len) return -EINVAL;
+	Z_ARGS_CHECK((uint32_t)req->addr + req->len <= (uint32_t)E2END + 1u) return -EINVAL;
+
+	const uint8_t key = irq_lock();
+
+	if (req->status == -EINPROGRESS) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	req->_next	= NULL;
+	req->_pos	= 0u;
+	req->status = -EINPROGRESS;
+
+	if (q_head == NULL) {
+		q_head = req;
+	} else {
+		q_tail->_next = req;
+	}
+	q_tail = req;
+
+#if CONFIG_KERNEL_PM
+	/* The EEPROM ready interrupt must be able to wake up the CPU, the
+	 * reference is held as long as EERIE is set */
+	if (!(EEPROM_DEVICE->EECRn & BIT(EERIE))) {
+		k_pm_require(K_PM_CAP_EEPROM);
+	}
+#endif
+
+	/* The interrupt triggers as soon as no byte is being programmed */
+	EEPROM_DEVICE->EECRn |= BIT(EERIE);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t eeprom_write(uint16_t addr, const void *data, uint16_t len)
+{
+	struct k_sem sem;
+	k_sem_init(&sem, 0u, 1u);
+
+	struct eeprom_write req = {
+		.addr	  = addr,
+		.data	  = data,
+		.len	  = len,
+		.sem	  = &sem,
+		.callback = NULL,
+	};
+
+	int8_t ret = eeprom_write_submit(&req);
+	if (ret == 0) {
+		k_sem_take(&sem, K_FOREVER);
+		ret = req.status;
+	}
+
+	return ret;
+}
+
+#endif /* CONFIG_DRIVERS_EEPROM_ASYNC */
+
+/* Sequence numbers run from 0 to 0xFE, 0xFF marks an erased slot */
+#define EEPROM_RECORD_SEQ_ERASED 0xFFu
+
+static uint8_t record_next_seq(uint8_t seq)
+{
+	return (seq >= 0xFEu) ? 0u : seq + 1u;
+}
+
+static uint16_t record_slot_addr(struct eeprom_record *rec, uint8_t idx)
+{
+	return rec->addr + (uint16_t)idx * (rec->size + 2u);
+}
+
+static uint8_t record_read_seq(struct eeprom_record *rec, uint8_t idx)
+{
+	uint8_t seq;
+	eeprom_read(record_slot_addr(rec, idx) + rec->size + 1u, &seq, 1u);
+	return seq;
+}
+
+/* Check the CRC of a slot, covering the value and the sequence number */
+static bool record_slot_check(struct eeprom_record *rec, uint8_t idx, uint8_t seq)
+{
+	uint16_t addr = record_slot_addr(rec, idx);
+	uint8_t crc	  = 0u;
+	uint8_t byte;
+
+	for (uint8_t i = 0u; i < rec->size; i++) {
+		eeprom_read(addr++, &byte, 1u);
+		crc = _crc8_ccitt_update(crc, byte);
+	}
+	crc = _crc8_ccitt_update(crc, seq);
+
+	eeprom_read(addr, &byte, 1u);
+
+	return byte == crc;
+}
+
+int8_t eeprom_record_init(struct eeprom_record *rec)
+{
+	Z_ARGS_CHECK(rec && rec->cache && rec->size) return -EINVAL;
+	Z_ARGS_CHECK((rec->depth >= 2u) && (rec->depth <= 254u)) return -EINVAL;
+
+	rec->_req_value.status	 = 0;
+	rec->_req_trailer.status = 0;
+
+	/* The first slot is written next if no value is found */
+	rec->_idx = rec->depth - 1u;
+	rec->_seq = 0xFEu;
+
+	/* The current slot is the last of the chain of consecutive sequence
+	 * numbers */
+	uint8_t idx = rec->depth;
+	uint8_t seq = EEPROM_RECORD_SEQ_ERASED;
+	for (uint8_t i = 0u; i < rec->depth; i++) {
+		seq = record_read_seq(rec, i);
+		if (seq == EEPROM_RECORD_SEQ_ERASED) {
+			continue;
+		}
+
+		const uint8_t next = record_read_seq(rec, (i + 1u) % rec->depth);
+		if (next != record_next_seq(seq)) {
+			idx = i;
+			break;
+		}
+	}
+
+	if (idx == rec->depth) {
+		return -ENOENT;
+	}
+
+	/* A save interrupted while writing the sequence number leaves an invalid
+	 * slot, fall back on the previous one */
+	for (uint8_t n = 0u; n < 2u; n++) {
+		if ((seq != EEPROM_RECORD_SEQ_ERASED) && record_slot_check(rec, idx, seq)) {
+			eeprom_read(record_slot_addr(rec, idx), rec->cache, rec->size);
+			rec->_idx = idx;
+			rec->_seq = seq;
+			return 0;
+		}
+
+		idx = (idx == 0u) ? rec->depth - 1u : idx - 1u;
+		seq = record_read_seq(rec, idx);
+	}
+
+	return -ENOENT;
+}
+
+bool eeprom_record_busy(struct eeprom_record *rec)
+{
+	return rec->_req_trailer.status == -EINPROGRESS;
+}
+
+#if CONFIG_DRIVERS_EEPROM_ASYNC
+
+int8_t eeprom_record_save(struct eeprom_record *rec)
+{
+	Z_ARGS_CHECK(rec && rec->cache) return -EINVAL;
+
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	if (eeprom_record_busy(rec)) {
+		ret = -EBUSY;
+		goto exit;
+	}
+
+	const uint8_t idx	 = (rec->_idx + 1u) % rec->depth;
+	const uint8_t seq	 = record_next_seq(rec->_seq);
+	const uint16_t addr	 = record_slot_addr(rec, idx);
+	const uint8_t *value = rec->cache;
+	uint8_t crc			 = 0u;
+
+	for (uint8_t i = 0u; i < rec->size; i++) {
+		crc = _crc8_ccitt_update(crc, value[i]);
+	}
+	rec->_trailer[0u] = _crc8_ccitt_update(crc, seq);
+	rec->_trailer[1u] = seq;
+
+	/* The sequence number is written last, it validates the slot */
+	rec->_req_value = (struct eeprom_write){
+		.addr = addr,
+		.data = value,
+		.len  = rec->size,
+	};
+	rec->_req_trailer = (struct eeprom_write){
+		.addr = addr + rec->size,
+		.data = rec->_trailer,
+		.len  = sizeof(rec->_trailer),
+	};
+
+	eeprom_write_submit(&rec->_req_value);
+	eeprom_write_submit(&rec->_req_trailer);
+
+	rec->_idx = idx;
+	rec->_seq = seq;
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+int8_t eeprom_record_set(struct eeprom_record *rec, const void *value)
+{
+	Z_ARGS_CHECK(rec && rec->cache && value) return -EINVAL;
+
+	if (memcmp(rec->cache, value, rec->size) == 0) {
+		return 0;
+	}
+
+	if (eeprom_record_busy(rec)) {
+		return -EBUSY;
+	}
+
+	memcpy(rec->cache, value, rec->size);
+
+	return eeprom_record_save(rec);
+}
+
+#endif /* CONFIG_DRIVERS_EEPROM_ASYNC */
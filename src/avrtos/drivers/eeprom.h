@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _AVRTOS_DRIVERS_EEPROM_H_
+#define _AVRTOS_DRIVERS_EEPROM_H_
+
+#include <avrtos/drivers.h>
+#include <avrtos/kernel.h>
+#include <avrtos/semaphore.h>
+
+/**
+ * EEPROM driver
+ *
+ * Programming a byte takes up to 3.4ms. With CONFIG_DRIVERS_EEPROM_ASYNC, writes
+ * are queued and the bytes are programmed one after the other from the
+ * ISR(EE_READY_vect) interrupt handler, the calling thread sleeps or is notified
+ * with a callback. Bytes which are already equal to the new value are skipped,
+ * bytes which only need to be erased (0xFF) or written (bits cleared) are
+ * programmed in half the time.
+ *
+ * Records (see eeprom_record_init()) store a value in a ring of slots to spread
+ * the erase cycles, the value is cached in RAM for reads.
+ *
+ * Do not use the avr-libc eeprom_*() functions while writes are queued.
+ */
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * @brief EEPROM registers.
+ */
+typedef struct {
+	__IO uint8_t EECRn;	 /* Control register */
+	__IO uint8_t EEDRn;	 /* Data register */
+	__IO uint16_t EEARn; /* Address register */
+} EEPROM_Device;
+
+#define EEPROM_BASE_ADDR (AVR_IO_BASE_ADDR + 0x003Fu)
+#define EEPROM_DEVICE	 ((EEPROM_Device *)EEPROM_BASE_ADDR)
+
+/**
+ * @brief Read bytes from the EEPROM.
+ *
+ * The EEPROM cannot be read while a byte is being programmed, the function
+ * yields until the current byte is programmed. Queued writes are not waited
+ * for: bytes not programmed yet are read with their previous value.
+ *
+ * @param addr EEPROM address.
+ * @param buf Buffer receiving the data.
+ * @param len Number of bytes to read.
+ */
+void eeprom_read(uint16_t addr, void *buf, uint16_t len);
+
+struct eeprom_write;
+
+typedef void (*eeprom_callback_t)(struct eeprom_write *req);
+
+/**
+ * @brief EEPROM write request, queued with eeprom_write_submit().
+ *
+ * The structure must be zero-initialized (or its status different from
+ * -EINPROGRESS) before the first submission. The structure and the data must
+ * remain valid until the write is complete.
+ */
+struct eeprom_write {
+	/* Next request in the queue (internal) */
+	struct eeprom_write *_next;
+
+	/* EEPROM address */
+	uint16_t addr;
+
+	/* Data to write */
+	const uint8_t *data;
+
+	/* Number of bytes to write */
+	uint16_t len;
+
+	/* Next byte to program (internal) */
+	uint16_t _pos;
+
+	/* -EINPROGRESS while queued, 0 when complete */
+	int8_t status;
+
+	/* Semaphore given when the write is complete (can be NULL) */
+	struct k_sem *sem;
+
+	/* Callback called from the interrupt handler when the write is complete
+	 * (can be NULL) */
+	eeprom_callback_t callback;
+};
+
+/**
+ * @brief Queue an EEPROM write.
+ *
+ * Can be called from an interrupt handler or a completion callback.
+ *
+ * Requires CONFIG_DRIVERS_EEPROM_ASYNC.
+ *
+ * @param req Write request.
+ * @return int8_t 0 on success, -EBUSY if the request is already queued,
+ * -EINVAL on invalid request.
+ */
+int8_t eeprom_write_submit(struct eeprom_write *req);
+
+/**
+ * @brief Write bytes to the EEPROM, the calling thread sleeps until the bytes
+ * are programmed.
+ *
+ * Requires CONFIG_DRIVERS_EEPROM_ASYNC.
+ *
+ * @param addr EEPROM address.
+ * @param data Data to write.
+ * @param len Number of bytes to write.
+ * @return int8_t 0 on success, negative on error.
+ */
+int8_t eeprom_write(uint16_t addr, const void *data, uint16_t len);
+
+/* Size in EEPROM of a record of the given value size and depth */
+#define EEPROM_RECORD_AREA_SIZE(_size, _depth) ((uint16_t)(_depth) * ((_size) + 2u))
+
+/**
+ * @brief Wear leveled record.
+ *
+ * The record occupies depth slots in EEPROM (see EEPROM_RECORD_AREA_SIZE()),
+ * each slot holding a copy of the value followed by a CRC and a sequence number.
+ * Each save writes the next slot, the sequence number is written last so an
+ * interrupted save leaves the previous value valid. The endurance of the record
+ * is multiplied by its depth.
+ */
+struct eeprom_record {
+	/* EEPROM address of the first slot */
+	uint16_t addr;
+
+	/* Size of the value in bytes */
+	uint8_t size;
+
+	/* Number of slots (2 to 254) */
+	uint8_t depth;
+
+	/* RAM cache of the value (size bytes) */
+	void *cache;
+
+	/* Current slot and its sequence number (internal) */
+	uint8_t Z_PRIVATE(idx);
+	uint8_t Z_PRIVATE(seq);
+
+	/* CRC and sequence number of the slot being saved (internal) */
+	uint8_t Z_PRIVATE(trailer)[2u];
+
+	struct eeprom_write Z_PRIVATE(req_value);
+	struct eeprom_write Z_PRIVATE(req_trailer);
+};
+
+/**
+ * @brief Load a record from the EEPROM into its cache.
+ *
+ * If no valid value is found, the cache is left unchanged (e.g. with default
+ * values).
+ *
+ * @param rec Record.
+ * @return int8_t 0 on success, -ENOENT if no value is stored, -EINVAL on invalid
+ * record.
+ */
+int8_t eeprom_record_init(struct eeprom_record *rec);
+
+/**
+ * @brief Save the cache of a record to the next slot.
+ *
+ * The write is queued and the function returns immediately, the cache must not
+ * be modified until the save is complete (see eeprom_record_busy()).
+ *
+ * Requires CONFIG_DRIVERS_EEPROM_ASYNC.
+ *
+ * @param rec Record.
+ * @return int8_t 0 on success, -EBUSY if the previous save is not complete.
+ */
+int8_t eeprom_record_save(struct eeprom_record *rec);
+
+/**
+ * @brief Update the cache of a record and save it if the value changed.
+ *
+ * Requires CONFIG_DRIVERS_EEPROM_ASYNC.
+ *
+ * @param rec Record.
+ * @param value New value (size bytes).
+ * @return int8_t 0 on success, -EBUSY if the previous save is not complete.
+ */
+int8_t eeprom_record_set(struct eeprom_record *rec, const void *value);
+
+/**
+ * @brief Check whether a save of the record is in progress.
+ *
+ * @param rec Record.
+ * @return true if the save is not complete.
+ */
+bool eeprom_record_busy(struct eeprom_record *rec);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _AVRTOS_DRIVERS_EEPROM_H_ */
@@ -6,6 +6,8 @@
 
 #include "exti.h"
 
+#include <avrtos/drivers/gpio.h>
+
 int8_t exti_configure(uint8_t exti, uint8_t isc)
 {
 	Z_ARGS_CHECK(exti < EXTI_COUNT) return -EINVAL;
@@ -22,4 +24,196 @@ int8_t exti_configure(uint8_t exti, uint8_t isc)
 	EXTI_CTRL_DEVICE->EICRn[regn] = (eicrn & ~group_mask) | (isc << (group << 1u));
 
 	return 0;
-}
\ No newline at end of file
+}
+
+#if CONFIG_DRIVERS_PCINT_DISPATCH
+
+#define PCINT_GROUP_HANDLED(_group) ((CONFIG_DRIVERS_PCINT_DISPATCH >> (_group)) & 1u)
+
+/* Registered pins, indexed by PCINT number */
+static struct pcint_pin *pcint_pins[PCI_COUNT];
+
+/* Last state of the pins of each group */
+static uint8_t pcint_snapshot[PCI_GROUPS_COUNT];
+
+static uint8_t pcint_group_read(uint8_t group)
+{
+	switch (group) {
+	case PCINT_0_7:
+		return GPIOB->PIN;
+#if defined(__AVR_ATmega2560__)
+	case PCINT_8_15:
+		/* PCINT8 is PE0, PCINT9 to PCINT15 are PJ0 to PJ6 */
+		return (GPIOE->PIN & BIT(0u)) | (GPIOJ->PIN << 1u);
+	case PCINT_16_23:
+		return GPIOK->PIN;
+#else
+	case PCINT_8_15:
+		return GPIOC->PIN;
+	case PCINT_16_23:
+		return GPIOD->PIN;
+#endif
+	default:
+		return 0u;
+	}
+}
+
+/* Return true if a thread was woken up by the flags */
+static bool pcint_notify(struct pcint_pin *pin, uint8_t level)
+{
+	bool woken = false;
+
+	if (level == pin->_level) {
+		return false;
+	}
+	pin->_level = level;
+
+	if (!(pin->edges & (level ? PCINT_EDGE_RISING : PCINT_EDGE_FALLING))) {
+		return false;
+	}
+
+	if (pin->callback != NULL) {
+		pin->callback(pin, level);
+	}
+
+	if (pin->flags != NULL) {
+		woken = k_flags_notify(pin->flags, pin->flags_mask, K_FLAGS_SET) > 0;
+	}
+
+	return woken;
+}
+
+#if CONFIG_KERNEL_EVENTS
+static void pcint_debounce_handler(struct k_event *event)
+{
+	struct pcint_pin *const pin = CONTAINER_OF(event, struct pcint_pin, _event);
+
+	const uint8_t state = pcint_group_read(pin->pci >> 3u);
+
+	/* The scheduler is called at the end of the tick */
+	pcint_notify(pin, (state >> (pin->pci & 0x07u)) & 1u);
+}
+#endif
+
+static void pcint_group_handler(uint8_t group)
+{
+	bool woken = false;
+
+	const uint8_t state	  = pcint_group_read(group);
+	const uint8_t changed = (state ^ pcint_snapshot[group]) & PCI_CTRL_DEVICE->PCMSK[group];
+	pcint_snapshot[group] = state;
+
+	for (uint8_t line = 0u; line < 8u; line++) {
+		if (!(changed & BIT(line))) continue;
+
+		struct pcint_pin *const pin = pcint_pins[(group << 3u) | line];
+		if (pin == NULL) continue;
+
+#if CONFIG_KERNEL_EVENTS
+		if (!K_TIMEOUT_EQ(pin->debounce, K_NO_WAIT)) {
+			/* Restart the stability period on each change */
+			k_event_cancel(&pin->_event);
+			k_event_schedule(&pin->_event, pin->debounce);
+			continue;
+		}
+#endif
+
+		woken |= pcint_notify(pin, (state >> line) & 1u);
+	}
+
+	if (woken) {
+		k_yield_from_isr();
+	}
+}
+
+int8_t pcint_pin_register(struct pcint_pin *pin)
+{
+	Z_ARGS_CHECK(pin && (pin->pci < PCI_COUNT)) return -EINVAL;
+
+	const uint8_t group = pin->pci >> 3u;
+	const uint8_t line	= pin->pci & 0x07u;
+
+	if (!PCINT_GROUP_HANDLED(group)) {
+		return -EINVAL;
+	}
+
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	if (pcint_pins[pin->pci] != NULL) {
+		ret = -EBUSY;
+		goto exit;
+	}
+
+#if CONFIG_KERNEL_EVENTS
+	k_event_init(&pin->_event, pcint_debounce_handler);
+#endif
+
+	/* The snapshot of the group is refreshed for the new line */
+	const uint8_t state	  = pcint_group_read(group);
+	pin->_level			  = (state >> line) & 1u;
+	pcint_snapshot[group] = (pcint_snapshot[group] & ~BIT(line)) | (state & BIT(line));
+	pcint_pins[pin->pci]  = pin;
+
+	pci_pin_enable_group_line(group, line);
+	pci_clear_flag(group);
+	pci_enable(group);
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+int8_t pcint_pin_unregister(struct pcint_pin *pin)
+{
+	Z_ARGS_CHECK(pin && (pin->pci < PCI_COUNT)) return -EINVAL;
+
+	const uint8_t group = pin->pci >> 3u;
+	const uint8_t line	= pin->pci & 0x07u;
+
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	if (pcint_pins[pin->pci] != pin) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+#if CONFIG_KERNEL_EVENTS
+	k_event_cancel(&pin->_event);
+#endif
+
+	pcint_pins[pin->pci] = NULL;
+
+	pci_pin_disable_group_line(group, line);
+	if (PCI_CTRL_DEVICE->PCMSK[group] == 0u) {
+		pci_disable(group);
+	}
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+#if PCINT_GROUP_HANDLED(PCINT_0_7)
+ISR(PCINT0_vect)
+{
+	pcint_group_handler(PCINT_0_7);
+}
+#endif
+
+#if PCINT_GROUP_HANDLED(PCINT_8_15)
+ISR(PCINT1_vect)
+{
+	pcint_group_handler(PCINT_8_15);
+}
+#endif
+
+#if PCINT_GROUP_HANDLED(PCINT_16_23)
+ISR(PCINT2_vect)
+{
+	pcint_group_handler(PCINT_16_23);
+}
+#endif
+
+#endif /* CONFIG_DRIVERS_PCINT_DISPATCH */
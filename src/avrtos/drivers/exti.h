@@ -10,6 +10,11 @@
 #include <avrtos/drivers.h>
 #include <avrtos/kernel.h>
 
+#if CONFIG_DRIVERS_PCINT_DISPATCH
+#include <avrtos/event.h>
+#include <avrtos/flags.h>
+#endif
+
 /**
  * @brief Definitions for External Interrupt (EXTI) and Pin Change Interrupt (PCI)
  * configuration and handling.
@@ -277,6 +282,88 @@ __always_inline void pci_disable(uint8_t group)
 	PCICR &= ~BIT(group);
 }
 
+#if CONFIG_DRIVERS_PCINT_DISPATCH
+
+/* Edges notified by the PCINT dispatcher */
+#define PCINT_EDGE_RISING  BIT(0u)
+#define PCINT_EDGE_FALLING BIT(1u)
+#define PCINT_EDGE_BOTH	   (PCINT_EDGE_RISING | PCINT_EDGE_FALLING)
+
+struct pcint_pin;
+
+/**
+ * @brief Callback of a pin registered to the PCINT dispatcher.
+ *
+ * Called from the PCINTn interrupt, or from the kernel event (interrupt context)
+ * if the pin is debounced.
+ *
+ * @param pin Registered pin.
+ * @param level New level of the pin (0 or 1).
+ */
+typedef void (*pcint_callback_t)(struct pcint_pin *pin, uint8_t level);
+
+/**
+ * @brief Pin registered to the PCINT dispatcher (see pcint_pin_register()).
+ *
+ * The structure must remain valid while the pin is registered.
+ */
+struct pcint_pin {
+	/* Pin change interrupt number (e.g. PCINT5 for PB5 on ATmega328P) */
+	uint8_t pci;
+
+	/* Edges to notify (PCINT_EDGE_*) */
+	uint8_t edges;
+
+	/* Called on each notified edge (can be NULL) */
+	pcint_callback_t callback;
+
+	/* Bits set in flags on each notified edge (flags can be NULL) */
+	struct k_flags *flags;
+	k_flags_value_t flags_mask;
+
+#if CONFIG_KERNEL_EVENTS
+	/* Time the level must be stable before it is notified, K_NO_WAIT to notify
+	 * each change immediately */
+	k_timeout_t debounce;
+
+	struct k_event Z_PRIVATE(event);
+#endif
+
+	/* Last notified level (internal) */
+	uint8_t Z_PRIVATE(level);
+};
+
+/**
+ * @brief Register a pin to the PCINT dispatcher.
+ *
+ * Each group has a single interrupt handler: the state of the port is compared
+ * (XOR) with the previous snapshot to find the pins which changed, and their
+ * level is dispatched to the callback and/or flags of the registered pins.
+ * The pin change interrupt of the pin and of its group are enabled.
+ *
+ * The GPIO must be configured as input by the application.
+ *
+ * Requires the group of the pin in CONFIG_DRIVERS_PCINT_DISPATCH.
+ *
+ * @param pin Pin to register.
+ * @return int8_t 0 on success, -EINVAL if the group is not handled, -EBUSY if the
+ * pin is already registered.
+ */
+int8_t pcint_pin_register(struct pcint_pin *pin);
+
+/**
+ * @brief Unregister a pin from the PCINT dispatcher.
+ *
+ * The pin change interrupt of the pin is disabled, and the one of its group if
+ * no other pin of the group is registered.
+ *
+ * @param pin Pin to unregister.
+ * @return int8_t 0 on success, -EINVAL if the pin is not registered.
+ */
+int8_t pcint_pin_unregister(struct pcint_pin *pin);
+
+#endif /* CONFIG_DRIVERS_PCINT_DISPATCH */
+
 #if defined(__cplusplus)
 }
 #endif
@@ -139,10 +139,12 @@ typedef struct {
 	((GPIO_Device *)(AVR_GPIO_BASE_ADDR + ((_idx) * sizeof(GPIO_Device))))
 
 #if defined(PORTH)
+/* There is no port I, port J follows port H */
 #define GPIO_DEVICE_HIKL(_idx)                                                           \
-	((GPIO_Device *)(AVR_GPIO_HIKL_BASE_ADDR + ((_idx - 6u) * sizeof(GPIO_Device))))
+	((GPIO_Device *)(AVR_GPIO_HIKL_BASE_ADDR +                                           \
+					 (((_idx) - GPIOH_INDEX) * sizeof(GPIO_Device))))
 #define GPIO_DEVICE(_idx)                                                                \
-	(((_idx) <= 5) ? GPIO_DEVICE_ABCDEFG(_idx) : GPIO_DEVICE_HIKL(_idx))
+	(((_idx) < GPIOH_INDEX) ? GPIO_DEVICE_ABCDEFG(_idx) : GPIO_DEVICE_HIKL(_idx))
 #else
 #define GPIO_DEVICE GPIO_DEVICE_ABCDEFG
 #endif
@@ -203,6 +205,33 @@ __always_inline uint8_t gpiol_pin_read_state(GPIO_Device *gpio, uint8_t pin)
 	return (gpio->PIN >> pin) & 1u;
 }
 
+/* Compile-time API
+ *
+ * When the GPIO device and the pin are constants, each macro compiles to a single
+ * instruction for ports A to G (sbi, cbi, sbis/sbic or an out to PINx for
+ * toggling). Ports H to L are outside of the bit-addressable I/O space: the
+ * set, clear and direction macros are read-modify-write sequences there and
+ * are not safe against interrupts modifying the same port.
+ */
+
+#define GPIO_PIN_SET(_gpio, _pin)	((_gpio)->PORT |= BIT(_pin))
+#define GPIO_PIN_CLEAR(_gpio, _pin) ((_gpio)->PORT &= ~BIT(_pin))
+#define GPIO_PIN_WRITE(_gpio, _pin, _state)                                              \
+	((_state) ? GPIO_PIN_SET(_gpio, _pin) : GPIO_PIN_CLEAR(_gpio, _pin))
+
+/* Writing a one to PINxn toggles PORTxn */
+#define GPIO_PIN_TOGGLE(_gpio, _pin) ((_gpio)->PIN = BIT(_pin))
+#define GPIO_PIN_READ(_gpio, _pin)	 (((_gpio)->PIN & BIT(_pin)) ? 1u : 0u)
+
+#define GPIO_PIN_OUTPUT(_gpio, _pin) ((_gpio)->DDR |= BIT(_pin))
+#define GPIO_PIN_INPUT(_gpio, _pin)	 ((_gpio)->DDR &= ~BIT(_pin))
+
+/* Write the bits of _value selected by _mask to the port. The bits to change are
+ * toggled with a single write to PINx, so other bits of the port are never
+ * written (e.g. from an interrupt between the read and the write). */
+#define GPIO_PORT_WRITE_MASKED(_gpio, _mask, _value)                                     \
+	((_gpio)->PIN = ((_gpio)->PORT ^ (_value)) & (_mask))
+
 /* Non-inline API */
 
 void gpio_init(GPIO_Device *gpio, uint8_t dir_mask, uint8_t pullup_mask);
@@ -221,6 +250,97 @@ uint8_t gpio_pin_read_state(GPIO_Device *gpio, uint8_t pin);
 
 #if defined(__cplusplus)
 }
+
+namespace avrtos
+{
+
+/**
+ * @brief Compile-time GPIO port, Port is the port index (e.g. GPIOB_INDEX).
+ */
+template <uint8_t Port> class GpioPort
+{
+  public:
+	static_assert(Port <= 10u, "Invalid port index");
+
+	/* Data address of the PINx register */
+	static constexpr uint16_t addr =
+		(Port < 7u) ? AVR_GPIO_ABCDEFG_BASE_ADDR + Port * sizeof(GPIO_Device)
+					: AVR_GPIO_HIKL_BASE_ADDR + (Port - 7u) * sizeof(GPIO_Device);
+
+	static GPIO_Device *dev(void)
+	{
+		return reinterpret_cast<GPIO_Device *>(addr);
+	}
+
+	static void write(uint8_t value)
+	{
+		dev()->PORT = value;
+	}
+
+	/* See GPIO_PORT_WRITE_MASKED() */
+	template <uint8_t Mask> static void write_masked(uint8_t value)
+	{
+		dev()->PIN = (dev()->PORT ^ value) & Mask;
+	}
+
+	static uint8_t read(void)
+	{
+		return dev()->PIN;
+	}
+};
+
+/**
+ * @brief Compile-time GPIO pin, e.g. `using Led = avrtos::GpioPin<GPIOB_INDEX, 5u>;`
+ */
+template <uint8_t Port, uint8_t Pin> class GpioPin
+{
+  public:
+	static_assert(Pin <= 7u, "Invalid pin");
+
+	static constexpr uint8_t mask = 1u << Pin;
+
+	static void set(void)
+	{
+		GpioPort<Port>::dev()->PORT |= mask;
+	}
+
+	static void clear(void)
+	{
+		GpioPort<Port>::dev()->PORT &= ~mask;
+	}
+
+	static void write(bool state)
+	{
+		if (state) {
+			set();
+		} else {
+			clear();
+		}
+	}
+
+	static void toggle(void)
+	{
+		GpioPort<Port>::dev()->PIN = mask;
+	}
+
+	static bool read(void)
+	{
+		return (GpioPort<Port>::dev()->PIN & mask) != 0u;
+	}
+
+	static void output(void)
+	{
+		GpioPort<Port>::dev()->DDR |= mask;
+	}
+
+	static void input(bool pullup = false)
+	{
+		GpioPort<Port>::dev()->DDR &= ~mask;
+		write(pullup);
+	}
+};
+
+} // namespace avrtos
 #endif
 
 #endif /* _GPIO_H_ */
\ No newline at end of file
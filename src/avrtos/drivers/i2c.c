@@ -9,6 +9,7 @@
 #include <avrtos/drivers.h>
 #include <avrtos/drivers/gpio.h>
 #include <avrtos/misc/serial.h>
+#include <avrtos/pm.h>
 #include <avrtos/semaphore.h>
 
 #include <avr/eeprom.h>
@@ -84,6 +85,13 @@ struct i2c_context {
 #if CONFIG_I2C_LAST_ERROR
 	i2c_error_t error;
 #endif // CONFIG_I2C_LAST_ERROR
+
+#if CONFIG_I2C_TRANSACTIONS
+	/* Queued transactions, the first one is in progress if q_active is set */
+	struct i2c_transaction *q_head;
+	struct i2c_transaction *q_tail;
+	uint8_t q_active;
+#endif // CONFIG_I2C_TRANSACTIONS
 };
 
 #if CONFIG_I2C_LAST_ERROR
@@ -228,14 +236,33 @@ exit:
 
 void transfer_stop(I2C_Device *dev, struct i2c_context *x)
 {
+#if CONFIG_I2C_TRANSACTIONS
+	if (x->q_head != NULL) {
+		/* Transactions were queued during the transfer, start them after the
+		 * stop condition */
+		x->q_active = 1u;
+		x->state	= MASTER_TX;
+		TWI_RESET(dev);
+		return;
+	}
+#endif // CONFIG_I2C_TRANSACTIONS
+
 	TWI_STOP(dev);
 	x->state = READY;
+
+#if CONFIG_KERNEL_PM
+	k_pm_release(K_PM_CAP_CLK_IO);
+#endif
 }
 
 __always_inline void poll_end(struct i2c_context *x)
 {
 	do {
 		memory_barrier();
+#if CONFIG_I2C_TRANSACTIONS
+		/* Queued transactions may start right after the transfer */
+		if (x->q_active) break;
+#endif
 	} while (x->state != READY);
 }
 
@@ -344,6 +371,11 @@ i2c_run(I2C_Device *dev, uint8_t addr, uint8_t *data, uint8_t w_len, uint8_t r_l
 	}
 	if (x->state != READY) return -EBUSY;
 
+#if CONFIG_KERNEL_PM
+	/* Keep the TWI clocked until the stop condition */
+	k_pm_require(K_PM_CAP_CLK_IO);
+#endif
+
 	x->sla_w = (addr << 1);
 	if (w_len == 0) {
 		x->state = MASTER_RX;
@@ -434,18 +466,277 @@ int8_t i2c_calc_config(struct i2c_config *config, uint32_t desired_freq)
 	return -ENOTSUP;
 }
 
+#if CONFIG_I2C_TRANSACTIONS
+
+static void i2c_q_notify(struct i2c_transaction *xfer)
+{
+	struct k_thread *thread = NULL;
+
+	if (xfer->sem != NULL) {
+		thread = k_sem_give(xfer->sem);
+	}
+
+	if (xfer->callback != NULL) {
+		xfer->callback(xfer);
+	}
+
+#if CONFIG_SYSTEM_WORKQUEUE_ENABLE
+	if (xfer->work != NULL) {
+		k_system_workqueue_submit(xfer->work);
+	}
+#endif
+
+	k_yield_from_isr_cond(thread);
+}
+
+/* Complete the transaction in progress and start the next one */
+static void i2c_q_complete(I2C_Device *dev, struct i2c_context *x, int8_t status)
+{
+	struct i2c_transaction *const xfer = x->q_head;
+
+	x->q_head = xfer->_next;
+	if (x->q_head != NULL) {
+		/* Stop condition followed by a start for the next transaction */
+		TWI_RESET(dev);
+	} else {
+		x->q_tail	= NULL;
+		x->q_active = 0u;
+		TWI_STOP(dev);
+		x->state = READY;
+#if CONFIG_KERNEL_PM
+		k_pm_release(K_PM_CAP_CLK_IO);
+#endif
+	}
+
+	xfer->_next	 = NULL;
+	xfer->status = status;
+
+	i2c_q_notify(xfer);
+}
+
+/* Move to the next message of the transaction, or complete it */
+static void i2c_q_next_msg(I2C_Device *dev, struct i2c_context *x)
+{
+	struct i2c_transaction *const xfer = x->q_head;
+
+	xfer->_cur = 0u;
+	if (++xfer->_msg < xfer->num_msgs) {
+		TWI_START(dev); /* Trigger a repeated start */
+	} else {
+		i2c_q_complete(dev, x, 0);
+	}
+}
+
+static void i2c_q_state_machine(I2C_Device *dev, struct i2c_context *x)
+{
+	struct i2c_transaction *const xfer = x->q_head;
+	struct i2c_msg *const msg		   = &xfer->msgs[xfer->_msg];
+	const uint8_t status			   = dev->TWSRn & TW_STATUS_MASK;
+
+	switch (status) {
+	case TW_START: // Start condition transmitted
+	case TW_REP_START:
+		if (msg->flags & I2C_MSG_READ) {
+			x->state   = MASTER_RX;
+			dev->TWDRn = (xfer->addr << 1) | TW_READ;
+		} else {
+			x->state   = MASTER_TX;
+			dev->TWDRn = (xfer->addr << 1) | TW_WRITE;
+		}
+		TWI_REPLY(dev, 1u);
+		break;
+
+	case TW_MT_SLA_ACK:	 // SLA+W transmitted, ACK received
+	case TW_MT_DATA_ACK: // Data transmitted, ACK received
+		if (xfer->_cur < msg->len) {
+			dev->TWDRn = msg->buf[xfer->_cur++];
+			TWI_REPLY(dev, 1u);
+		} else {
+			i2c_q_next_msg(dev, x);
+		}
+		break;
+
+	case TW_MR_DATA_ACK: // Data received, ACK returned
+		msg->buf[xfer->_cur++] = dev->TWDRn;
+	case TW_MR_SLA_ACK: // SLA+R transmitted, ACK received
+		/* ACK if more data is expected (NACK otherwise) */
+		TWI_REPLY(dev, msg->len - xfer->_cur > 1u);
+		break;
+
+	case TW_MR_DATA_NACK: // Data received, NACK returned
+		msg->buf[xfer->_cur++] = dev->TWDRn;
+		i2c_q_next_msg(dev, x);
+		break;
+
+	case TW_MT_SLA_NACK:  // SLA+W transmitted, NACK received
+	case TW_MT_DATA_NACK: // Data transmitted, NACK received
+	case TW_MR_SLA_NACK:  // SLA+R transmitted, NACK received
+		i2c_q_complete(dev, x, -EIO);
+		break;
+
+	case TW_MT_ARB_LOST:
+		/* Restart the current message */
+		xfer->_cur = 0u;
+		TWI_START(dev);
+		break;
+
+	// fatal
+	case TW_NO_INFO:
+	case TW_BUS_ERROR:
+	default:
+		i2c_q_complete(dev, x, -EIO);
+		break;
+	}
+}
+
+int8_t i2c_transaction_submit(I2C_Device *dev, struct i2c_transaction *xfer)
+{
+	struct i2c_context *const x = i2c_get_context(dev);
+
+	Z_ARGS_CHECK(x && xfer && xfer->msgs && xfer->num_msgs) return -EINVAL;
+
+	for (uint8_t i = 0u; i < xfer->num_msgs; i++) {
+		const struct i2c_msg *const msg = &xfer->msgs[i];
+
+		/* A read message must receive at least one byte to NACK it */
+		Z_ARGS_CHECK((msg->buf || !msg->len) &&
+					 (!(msg->flags & I2C_MSG_READ) || msg->len))
+		{
+			return -EINVAL;
+		}
+	}
+
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	if (x->state == UNINITIALIZED) {
+		ret = -ENODEV;
+		goto exit;
+	}
+
+	xfer->_next	 = NULL;
+	xfer->_msg	 = 0u;
+	xfer->_cur	 = 0u;
+	xfer->status = -EINPROGRESS;
+
+	if (x->q_head == NULL) {
+		x->q_head = xfer;
+		x->q_tail = xfer;
+
+		/* Otherwise the transfer in progress starts the queue when complete */
+		if (x->state == READY) {
+#if CONFIG_KERNEL_PM
+			/* Keep the TWI clocked until the queue is empty */
+			k_pm_require(K_PM_CAP_CLK_IO);
+#endif
+			x->q_active = 1u;
+			x->state	= MASTER_TX;
+			TWI_START(dev);
+		}
+	} else {
+		x->q_tail->_next = xfer;
+		x->q_tail		 = xfer;
+	}
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+int8_t i2c_transaction_cancel(I2C_Device *dev, struct i2c_transaction *xfer)
+{
+	struct i2c_context *const x = i2c_get_context(dev);
+
+	Z_ARGS_CHECK(x && xfer) return -EINVAL;
+
+	int8_t ret		  = -EALREADY;
+	const uint8_t key = irq_lock();
+
+	if (xfer == x->q_head) {
+		if (x->q_active) {
+			ret = -EBUSY;
+			goto exit;
+		}
+
+		/* Waiting for the end of a i2c_master_*() transfer */
+		x->q_head = xfer->_next;
+		if (x->q_head == NULL) {
+			x->q_tail = NULL;
+		}
+		xfer->_next	 = NULL;
+		xfer->status = -ECANCELED;
+		ret			 = 0;
+		goto exit;
+	}
+
+	for (struct i2c_transaction *prev = x->q_head; prev != NULL; prev = prev->_next) {
+		if (prev->_next == xfer) {
+			prev->_next = xfer->_next;
+			if (x->q_tail == xfer) {
+				x->q_tail = prev;
+			}
+			xfer->_next	 = NULL;
+			xfer->status = -ECANCELED;
+			ret			 = 0;
+			break;
+		}
+	}
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+int8_t i2c_transaction_transceive(I2C_Device *dev, struct i2c_transaction *xfer)
+{
+	Z_ARGS_CHECK(xfer) return -EINVAL;
+
+	struct k_sem sem;
+	k_sem_init(&sem, 0u, 1u);
+
+	xfer->sem	   = &sem;
+	xfer->callback = NULL;
+#if CONFIG_SYSTEM_WORKQUEUE_ENABLE
+	xfer->work = NULL;
+#endif
+
+	int8_t ret = i2c_transaction_submit(dev, xfer);
+	if (ret == 0) {
+		k_sem_take(&sem, K_FOREVER);
+		ret = xfer->status;
+	}
+
+	xfer->sem = NULL;
+
+	return ret;
+}
+
+#endif // CONFIG_I2C_TRANSACTIONS
+
 #if CONFIG_I2C_INTERRUPT_DRIVEN
+__always_inline void i2c_isr(I2C_Device *dev, struct i2c_context *x)
+{
+#if CONFIG_I2C_TRANSACTIONS
+	if (x->q_active) {
+		i2c_q_state_machine(dev, x);
+		return;
+	}
+#endif // CONFIG_I2C_TRANSACTIONS
+
+	i2c_state_machine(dev, x);
+}
+
 #if I2C0_DEVICE_ENABLED
 ISR(TWI0_vect)
 {
-	i2c_state_machine(I2C0_DEVICE, &i2c_contexts[I2C0_INDEX]);
+	i2c_isr(I2C0_DEVICE, &i2c_contexts[I2C0_INDEX]);
 }
 #endif // I2C0_DEVICE_ENABLED
 
 #if I2C1_DEVICE_ENABLED
 ISR(TWI1_vect)
 {
-	i2c_state_machine(I2C0_DEVICE, &i2c_contexts[I2C1_INDEX]);
+	i2c_isr(I2C1_DEVICE, &i2c_contexts[I2C1_INDEX]);
 }
 #endif // I2C1_DEVICE_ENABLED
 #endif // CONFIG_I2C_INTERRUPT_DRIVEN
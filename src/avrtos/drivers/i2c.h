@@ -9,6 +9,8 @@
 
 #include <avrtos/drivers.h>
 #include <avrtos/kernel.h>
+#include <avrtos/semaphore.h>
+#include <avrtos/workqueue.h>
 
 #include "i2c_defs.h"
 
@@ -220,6 +222,112 @@ i2c_error_t i2c_last_error(I2C_Device *dev);
  */
 int8_t i2c_calc_config(struct i2c_config *config, uint32_t desired_freq);
 
+/* Message flags */
+#define I2C_MSG_WRITE 0u
+#define I2C_MSG_READ  1u
+
+/**
+ * @brief Message of an I2C transaction, a repeated start is generated between
+ * consecutive messages.
+ */
+struct i2c_msg {
+	/* Data to write or buffer to fill */
+	uint8_t *buf;
+
+	/* Number of bytes to transfer, can be 0 for a write (address probe) */
+	uint8_t len;
+
+	/* I2C_MSG_WRITE or I2C_MSG_READ */
+	uint8_t flags;
+};
+
+struct i2c_transaction;
+
+/**
+ * @brief Completion callback of an I2C transaction, called from the TWI interrupt.
+ */
+typedef void (*i2c_callback_t)(struct i2c_transaction *xfer);
+
+/**
+ * @brief I2C transaction, queued with i2c_transaction_submit().
+ *
+ * The structure and the messages must remain valid until the transaction is
+ * complete.
+ */
+struct i2c_transaction {
+	/* Next transaction in the queue (internal) */
+	struct i2c_transaction *_next;
+
+	/* 7-bit slave address */
+	uint8_t addr;
+
+	/* Messages to transfer, in order */
+	struct i2c_msg *msgs;
+
+	/* Number of messages */
+	uint8_t num_msgs;
+
+	/* Current message and byte (internal) */
+	uint8_t _msg;
+	uint8_t _cur;
+
+	/* -EINPROGRESS while queued, 0 when complete, -EIO on NACK or bus error,
+	 * -ECANCELED if canceled */
+	int8_t status;
+
+	/* Semaphore given when the transaction is complete (can be NULL) */
+	struct k_sem *sem;
+
+	/* Callback called when the transaction is complete (can be NULL) */
+	i2c_callback_t callback;
+
+#if CONFIG_SYSTEM_WORKQUEUE_ENABLE
+	/* Work submitted to the system workqueue when the transaction is complete
+	 * (can be NULL) */
+	struct k_work *work;
+#endif
+};
+
+/**
+ * @brief Queue an I2C transaction.
+ *
+ * The transaction starts immediately if the bus is idle, otherwise when the
+ * previous transactions (or the transfer started with i2c_master_*()) are
+ * complete. All messages are transferred from the TWI interrupt, with a
+ * repeated start between messages and a stop condition at the end.
+ *
+ * Can be called from an interrupt handler or a completion callback.
+ *
+ * Requires CONFIG_I2C_TRANSACTIONS.
+ *
+ * @param dev I2C device
+ * @param xfer Transaction to queue.
+ * @return int8_t 0 on success, negative on error.
+ */
+int8_t i2c_transaction_submit(I2C_Device *dev, struct i2c_transaction *xfer);
+
+/**
+ * @brief Cancel a queued I2C transaction which is not started yet.
+ *
+ * @param dev I2C device
+ * @param xfer Transaction to cancel.
+ * @return int8_t 0 on success, -EBUSY if the transaction is in progress,
+ * -EALREADY if it is not queued.
+ */
+int8_t i2c_transaction_cancel(I2C_Device *dev, struct i2c_transaction *xfer);
+
+/**
+ * @brief Queue an I2C transaction and wait for its completion.
+ *
+ * The calling thread sleeps during the transfer, xfer->sem, xfer->callback and
+ * xfer->work are overwritten.
+ *
+ * @param dev I2C device
+ * @param xfer Transaction to run.
+ * @return int8_t 0 on success, negative on error.
+ */
+int8_t i2c_transaction_transceive(I2C_Device *dev, struct i2c_transaction *xfer);
+
 #if defined(__cplusplus)
 }
 #endif
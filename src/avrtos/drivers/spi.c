@@ -8,9 +8,13 @@
 
 #include <avrtos/drivers.h>
 #include <avrtos/drivers/gpio.h>
+#include <avrtos/assert.h>
+#include <avrtos/pm.h>
 
 #include "gpio.h"
 
+#define K_MODULE K_MODULE_DRIVERS_SPI
+
 #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328PB__)
 #define SPI_MOSI_PIN 3u
 #define SPI_MISO_PIN 4u
@@ -25,9 +29,13 @@
 
 #define SPI2X_MASK BIT(SPI2X)
 
+/* Bus whose slave registers are applied, NULL once the registers are written
+ * without the bus API */
+static struct spi_bus *spi_regs_bus = NULL;
+
 int8_t spi_init(struct spi_config config)
 {
-#if CONFIG_SPI_ASYNC
+#if CONFIG_SPI_ASYNC || CONFIG_SPI_TRANSACTIONS
 	/* If async API is used, the interrupt cannot be enabled through
 	 * configuration, so disable it */
 	config.irq_enabled = 0u;
@@ -79,8 +87,9 @@ struct spi_regs spi_config_into_regs(struct spi_config config)
 
 void spi_regs_restore(const struct spi_regs *regs)
 {
-	SPI->SPCRn = regs->spcr;
-	SPI->SPSRn = regs->spsr;
+	spi_regs_bus = NULL;
+	SPI->SPCRn	 = regs->spcr;
+	SPI->SPSRn	 = regs->spsr;
 }
 
 void spi_regs_swap(struct spi_regs *regs)
@@ -99,7 +108,8 @@ void spi_regs_save(struct spi_regs *regs)
 
 void spi_deinit(void)
 {
-	SPI->SPCRn = 0u;
+	spi_regs_bus = NULL;
+	SPI->SPCRn	 = 0u;
 	SPI->SPSRn = 0u;
 }
 
@@ -129,6 +139,7 @@ int8_t spi_slave_init(struct spi_slave *slave,
 {
 	Z_ARGS_CHECK(slave && regs && cs_port && cs_pin <= PIN7) return -EINVAL;
 
+	slave->bus			= NULL;
 	slave->cs_port		= cs_port;
 	slave->cs_pin		= cs_pin;
 	slave->active_state = active_state;
@@ -181,6 +192,95 @@ void spi_slave_transceive_buf(const struct spi_slave *slave, char *rxtx, uint8_t
 						 slave->active_state ? GPIO_HIGH : GPIO_LOW);
 }
 
+int8_t spi_bus_init(struct spi_bus *bus)
+{
+	Z_ARGS_CHECK(bus) return -EINVAL;
+
+	k_mutex_init(&bus->mutex);
+	bus->current = NULL;
+
+	return 0;
+}
+
+int8_t spi_bus_attach(struct spi_bus *bus,
+					  struct spi_slave *slave,
+					  GPIO_Device *cs_port,
+					  uint8_t cs_pin,
+					  uint8_t active_state,
+					  struct spi_config config)
+{
+	Z_ARGS_CHECK(bus && config.role == SPI_ROLE_MASTER) return -EINVAL;
+
+	const struct spi_regs regs = spi_config_into_regs(config);
+
+	int8_t ret = spi_slave_init(slave, cs_port, cs_pin, active_state, &regs);
+	if (ret == 0) {
+		slave->bus = bus;
+		ret		   = spi_slave_ss_init(slave);
+	}
+
+	return ret;
+}
+
+int8_t spi_bus_acquire(const struct spi_slave *slave, k_timeout_t timeout)
+{
+	Z_ARGS_CHECK(slave && slave->bus) return -EINVAL;
+
+	struct spi_bus *const bus = slave->bus;
+
+	int8_t ret = k_mutex_lock(&bus->mutex, timeout);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Skip reconfiguration for consecutive transfers of the same slave, unless
+	 * the registers were written in the meantime (e.g. by a transaction) */
+	const uint8_t key = irq_lock();
+	if ((bus->current != slave) || (spi_regs_bus != bus)) {
+		spi_regs_restore(&slave->regs);
+		spi_regs_bus = bus;
+		bus->current = slave;
+	}
+	irq_unlock(key);
+
+	return 0;
+}
+
+void spi_bus_release(const struct spi_slave *slave)
+{
+	__ASSERT_NOTNULL(slave);
+
+	k_mutex_unlock(&slave->bus->mutex);
+}
+
+void spi_bus_invalidate(struct spi_bus *bus)
+{
+	__ASSERT_NOTNULL(bus);
+
+	bus->current = NULL;
+}
+
+int8_t spi_bus_transceive(const struct spi_slave *slave,
+						  char *rxtx,
+						  uint8_t len,
+						  k_timeout_t timeout)
+{
+	Z_ARGS_CHECK(rxtx || !len) return -EINVAL;
+
+	int8_t ret = spi_bus_acquire(slave, timeout);
+	if (ret != 0) {
+		return ret;
+	}
+
+	spi_slave_select(slave);
+	spi_transceive_buf(rxtx, len);
+	spi_slave_unselect(slave);
+
+	spi_bus_release(slave);
+
+	return 0;
+}
+
 #if CONFIG_SPI_ASYNC
 /* Callback function for async SPI
  * it should remain properly defined when SPI->SPCRn is set
@@ -199,6 +299,9 @@ ISR(SPI_STC_vect)
 		SPI->SPDRn = rxtx;
 	} else {
 		SPI->SPCRn &= ~BIT(SPIE);
+#if CONFIG_KERNEL_PM
+		k_pm_release(K_PM_CAP_CLK_IO);
+#endif
 	}
 }
 
@@ -208,6 +311,11 @@ int8_t spi_transceive_async_start(char first_tx, spi_callback_t callback)
 
 	if (spi_async_inprogress()) return -EBUSY;
 
+#if CONFIG_KERNEL_PM
+	/* Keep the SPI clocked until the callback ends the transfer */
+	k_pm_require(K_PM_CAP_CLK_IO);
+#endif
+
 	spi_callback = callback;
 	SPI->SPDRn	 = first_tx;
 	SPI->SPCRn |= BIT(SPIE);
@@ -226,6 +334,10 @@ int8_t spi_cancel_async(void)
 		SPI->SPCRn &= ~BIT(SPIE); /* Disable interrupt */
 		spi_callback(NULL);		  /* Notify cancelation */
 
+#if CONFIG_KERNEL_PM
+		k_pm_release(K_PM_CAP_CLK_IO);
+#endif
+
 		// required ?
 		SPI->SPSRn |= BIT(SPIF); /* Clear SPIF flag */
 	}
@@ -233,4 +345,167 @@ int8_t spi_cancel_async(void)
 	return 0;
 }
 
-#endif /* CONFIG_SPI_ASYNC */
\ No newline at end of file
+#endif /* CONFIG_SPI_ASYNC */
+#if CONFIG_SPI_TRANSACTIONS
+
+/* Queued transactions, the first one is in progress */
+static struct spi_transaction *spi_q_head = NULL;
+static struct spi_transaction *spi_q_tail = NULL;
+
+/* Registers in use before the queue started, restored when it is empty */
+static struct spi_regs spi_q_idle_regs;
+
+#define SPI_DUMMY_BYTE 0xFFu
+
+/* Requires interrupts to be disabled */
+static void spi_q_start(struct spi_transaction *xfer)
+{
+	struct spi_regs regs = xfer->slave->regs;
+	regs.spcr |= BIT(SPIE);
+
+	spi_regs_restore(&regs);
+	spi_slave_select(xfer->slave);
+
+	xfer->_cur = 0u;
+	SPI->SPDRn = xfer->tx_buf ? xfer->tx_buf[0u] : SPI_DUMMY_BYTE;
+}
+
+static void spi_q_notify(struct spi_transaction *xfer)
+{
+	struct k_thread *thread = NULL;
+
+	if (xfer->sem != NULL) {
+		thread = k_sem_give(xfer->sem);
+	}
+
+#if CONFIG_SYSTEM_WORKQUEUE_ENABLE
+	if (xfer->work != NULL) {
+		k_system_workqueue_submit(xfer->work);
+	}
+#endif
+
+	k_yield_from_isr_cond(thread);
+}
+
+ISR(SPI_STC_vect)
+{
+	struct spi_transaction *const xfer = spi_q_head;
+	const uint8_t rx				   = SPI->SPDRn;
+
+	if (xfer->rx_buf != NULL) {
+		xfer->rx_buf[xfer->_cur] = rx;
+	}
+
+	/* More bytes to transceive */
+	if (++xfer->_cur < xfer->len) {
+		SPI->SPDRn = xfer->tx_buf ? xfer->tx_buf[xfer->_cur] : SPI_DUMMY_BYTE;
+		return;
+	}
+
+	spi_slave_unselect(xfer->slave);
+
+	spi_q_head = xfer->_next;
+	if (spi_q_head != NULL) {
+		/* Run the next transaction back to back */
+		spi_q_start(spi_q_head);
+	} else {
+		spi_q_tail = NULL;
+		spi_regs_restore(&spi_q_idle_regs);
+#if CONFIG_KERNEL_PM
+		k_pm_release(K_PM_CAP_CLK_IO);
+#endif
+	}
+
+	xfer->_next	 = NULL;
+	xfer->status = 0;
+
+	spi_q_notify(xfer);
+}
+
+int8_t spi_transaction_submit(struct spi_transaction *xfer)
+{
+	Z_ARGS_CHECK(xfer && xfer->slave && xfer->len) return -EINVAL;
+
+	const uint8_t key = irq_lock();
+
+	if (xfer->status == -EINPROGRESS) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	xfer->_next	 = NULL;
+	xfer->status = -EINPROGRESS;
+
+	if (spi_q_head == NULL) {
+#if CONFIG_KERNEL_PM
+		/* Keep the SPI clocked until the queue is empty */
+		k_pm_require(K_PM_CAP_CLK_IO);
+#endif
+		spi_regs_save(&spi_q_idle_regs);
+		spi_q_head = xfer;
+		spi_q_tail = xfer;
+		spi_q_start(xfer);
+	} else {
+		spi_q_tail->_next = xfer;
+		spi_q_tail		  = xfer;
+	}
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t spi_transaction_cancel(struct spi_transaction *xfer)
+{
+	Z_ARGS_CHECK(xfer) return -EINVAL;
+
+	int8_t ret		  = -EALREADY;
+	const uint8_t key = irq_lock();
+
+	if (xfer == spi_q_head) {
+		ret = -EBUSY;
+		goto exit;
+	}
+
+	for (struct spi_transaction *prev = spi_q_head; prev != NULL; prev = prev->_next) {
+		if (prev->_next == xfer) {
+			prev->_next = xfer->_next;
+			if (spi_q_tail == xfer) {
+				spi_q_tail = prev;
+			}
+			xfer->_next	 = NULL;
+			xfer->status = -ECANCELED;
+			ret			 = 0;
+			break;
+		}
+	}
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+int8_t spi_transaction_transceive(struct spi_transaction *xfer)
+{
+	Z_ARGS_CHECK(xfer) return -EINVAL;
+
+	struct k_sem sem;
+	k_sem_init(&sem, 0u, 1u);
+
+	xfer->sem = &sem;
+#if CONFIG_SYSTEM_WORKQUEUE_ENABLE
+	xfer->work = NULL;
+#endif
+
+	int8_t ret = spi_transaction_submit(xfer);
+	if (ret == 0) {
+		k_sem_take(&sem, K_FOREVER);
+		ret = xfer->status;
+	}
+
+	xfer->sem = NULL;
+
+	return ret;
+}
+
+#endif /* CONFIG_SPI_TRANSACTIONS */
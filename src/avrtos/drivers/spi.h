@@ -9,6 +9,9 @@
 
 #include <avrtos/drivers/gpio.h>
 #include <avrtos/kernel.h>
+#include <avrtos/mutex.h>
+#include <avrtos/semaphore.h>
+#include <avrtos/workqueue.h>
 
 /**
  * SPI driver
@@ -187,7 +190,11 @@ char spi_transceive(char tx);
  */
 void spi_transceive_buf(char *rxtx, uint8_t len);
 
+struct spi_bus;
+
 struct spi_slave {
+	/* Bus the slave is attached to (see spi_bus_attach()), can be NULL */
+	struct spi_bus *bus;
 	/* Slave chip select port */
 	GPIO_Device *cs_port;
 	/* Slave chip select pin */
@@ -248,6 +255,106 @@ char spi_slave_transceive(const struct spi_slave *slave, char tx);
  */
 void spi_slave_transceive_buf(const struct spi_slave *slave, char *rxtx, uint8_t len);
 
+/**
+ * @brief Shared SPI bus.
+ *
+ * Arbitrates the SPI peripheral between threads using slaves with different
+ * configurations. The registers of the slave which used the bus last are
+ * remembered, they are only written when another slave uses the bus or when
+ * the registers were written without the bus API in the meantime (e.g.
+ * spi_init(), spi_regs_restore() or SPI transactions).
+ */
+struct spi_bus {
+	/* Mutex held during a transfer */
+	struct k_mutex mutex;
+	/* Slave whose registers are applied, NULL if unknown */
+	const struct spi_slave *current;
+};
+
+#define Z_SPI_BUS_INIT(_bus)                                                             \
+	{                                                                                    \
+		.mutex = Z_MUTEX_INIT(_bus.mutex), .current = NULL,                              \
+	}
+
+#define SPI_BUS_DEFINE(_name) struct spi_bus _name = Z_SPI_BUS_INIT(_name)
+
+/**
+ * @brief Initialize a SPI bus at runtime.
+ *
+ * @param bus Pointer to the bus structure.
+ * @return int8_t 0 on success, negative on error.
+ */
+int8_t spi_bus_init(struct spi_bus *bus);
+
+/**
+ * @brief Attach a slave to a bus.
+ *
+ * The registers of the slave are built from the configuration with
+ * spi_config_into_regs() and its chip select pin is initialized.
+ *
+ * @param bus Pointer to the bus structure.
+ * @param slave Pointer to the slave structure.
+ * @param cs_port Pointer to the GPIO port of the slave chip select pin.
+ * @param cs_pin Slave chip select pin.
+ * @param active_state Slave chip select active state.
+ * @param config SPI configuration of the slave (master role).
+ * @return int8_t 0 on success, negative on error.
+ */
+int8_t spi_bus_attach(struct spi_bus *bus,
+					  struct spi_slave *slave,
+					  GPIO_Device *cs_port,
+					  uint8_t cs_pin,
+					  uint8_t active_state,
+					  struct spi_config config);
+
+/**
+ * @brief Lock the bus of the slave and apply its registers if needed.
+ *
+ * The slave is not selected. This function is not safe to be called from an ISR.
+ *
+ * @param slave Pointer to a slave attached to a bus.
+ * @param timeout Maximum time to wait for the bus.
+ * @return int8_t 0 on success, negative on error.
+ */
+int8_t spi_bus_acquire(const struct spi_slave *slave, k_timeout_t timeout);
+
+/**
+ * @brief Unlock the bus of the slave.
+ *
+ * @param slave Pointer to a slave attached to a bus.
+ */
+void spi_bus_release(const struct spi_slave *slave);
+
+/**
+ * @brief Forget the registers applied on the bus.
+ *
+ * The registers of the next slave are applied even if it used the bus last.
+ * Writes of the SPI registers with the driver functions (e.g. spi_init(),
+ * spi_regs_restore()) already invalidate the bus.
+ *
+ * @param bus Pointer to the bus structure.
+ */
+void spi_bus_invalidate(struct spi_bus *bus);
+
+/**
+ * @brief Transceive a buffer with a slave attached to a bus.
+ *
+ * Lock the bus, apply the slave registers if another slave used the bus last,
+ * select the slave, transceive the buffer, unselect the slave and unlock the bus.
+ *
+ * This function is not safe to be called from an ISR.
+ *
+ * @param slave Pointer to a slave attached to a bus.
+ * @param rxtx Buffer to send, the received bytes are stored in place.
+ * @param len Number of bytes to transceive.
+ * @param timeout Maximum time to wait for the bus.
+ * @return int8_t 0 on success, negative on error.
+ */
+int8_t spi_bus_transceive(const struct spi_slave *slave,
+						  char *rxtx,
+						  uint8_t len,
+						  k_timeout_t timeout);
+
 /**
  * @brief SPI callback function type for asynchronous SPI tranceive.
  *
@@ -311,6 +418,86 @@ bool spi_async_inprogress(void);
  */
 int8_t spi_cancel_async(void);
 
+struct spi_transaction;
+
+/**
+ * @brief SPI transaction, queued with spi_transaction_submit().
+ *
+ * The structure must be zero-initialized (or its status different from
+ * -EINPROGRESS) before the first submission, and remain valid until the
+ * transaction is complete.
+ */
+struct spi_transaction {
+	/* Next transaction in the queue (internal) */
+	struct spi_transaction *_next;
+
+	/* Slave to select during the transaction, its registers are applied */
+	const struct spi_slave *slave;
+
+	/* Bytes to send, 0xFF is sent if NULL */
+	const uint8_t *tx_buf;
+
+	/* Received bytes, discarded if NULL (can be the same buffer as tx_buf) */
+	uint8_t *rx_buf;
+
+	/* Number of bytes to transceive */
+	size_t len;
+
+	/* Number of bytes transceived (internal) */
+	size_t _cur;
+
+	/* -EINPROGRESS while queued, 0 when complete, -ECANCELED if canceled */
+	int8_t status;
+
+	/* Semaphore given when the transaction is complete (can be NULL) */
+	struct k_sem *sem;
+
+#if CONFIG_SYSTEM_WORKQUEUE_ENABLE
+	/* Work submitted to the system workqueue when the transaction is complete
+	 * (can be NULL) */
+	struct k_work *work;
+#endif
+};
+
+/**
+ * @brief Queue an SPI transaction.
+ *
+ * The transaction starts immediately if the queue is empty, otherwise when the
+ * previous transactions are complete. For each transaction, the slave is
+ * selected and its registers applied, all bytes are transceived from the SPI
+ * interrupt and the slave is unselected. The SPI registers in use before the
+ * first transaction are restored when the queue is empty.
+ *
+ * Can be called from an interrupt handler or a completion callback.
+ *
+ * Requires CONFIG_SPI_TRANSACTIONS and the SPI to be initialized in master mode.
+ *
+ * @param xfer Transaction to queue.
+ * @return int8_t 0 on success, -EBUSY if the transaction is already queued,
+ * negative on error.
+ */
+int8_t spi_transaction_submit(struct spi_transaction *xfer);
+
+/**
+ * @brief Cancel a queued SPI transaction which is not started yet.
+ *
+ * @param xfer Transaction to cancel.
+ * @return int8_t 0 on success, -EBUSY if the transaction is in progress,
+ * -EALREADY if it is not queued.
+ */
+int8_t spi_transaction_cancel(struct spi_transaction *xfer);
+
+/**
+ * @brief Queue an SPI transaction and wait for its completion.
+ *
+ * The calling thread sleeps during the transfer, xfer->sem and xfer->work are
+ * overwritten.
+ *
+ * @param xfer Transaction to run.
+ * @return int8_t 0 on success, negative on error.
+ */
+int8_t spi_transaction_transceive(struct spi_transaction *xfer);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -7,12 +7,21 @@
 #include "timer.h"
 
 #include <avrtos/assert.h>
+#include <avrtos/pm.h>
 
 #define DRIVERS_TIMERS_API                                                               \
 	((CONFIG_DRIVERS_TIMER0_API) || (CONFIG_DRIVERS_TIMER1_API) ||                       \
 	 (CONFIG_DRIVERS_TIMER2_API) || (CONFIG_DRIVERS_TIMER3_API) ||                       \
 	 (CONFIG_DRIVERS_TIMER4_API) || (CONFIG_DRIVERS_TIMER5_API))
 
+/* Timers used by the 16 bits timers drivers */
+#define TIMER_CAPTURE_ENABLED(n) ((CONFIG_DRIVERS_TIMER_CAPTURE >> (n)) & 1u)
+#define TIMER_PWM_ENABLED(n)	 ((CONFIG_DRIVERS_TIMER_PWM >> (n)) & 1u)
+#define TIMER_MUX_ENABLED(n)	 ((CONFIG_DRIVERS_TIMER_MUX >> (n)) & 1u)
+
+#define TIMER16_DRIVER_ENABLED(n)                                                        \
+	(TIMER_CAPTURE_ENABLED(n) || TIMER_PWM_ENABLED(n) || TIMER_MUX_ENABLED(n))
+
 #define K_MODULE K_MODULE_DRIVERS_TIMERS
 
 /* not __always_inline version of timer_get_index */
@@ -268,6 +277,79 @@ int8_t timer_calc_prescaler(uint8_t timer_index, uint32_t period_us, uint16_t *c
 	return (int8_t)prescaler_id;
 }
 
+#define TIMER_RES_CHANNELS ((uint8_t)(BIT(TIMER_CHANNELS_COUNT) - 1u))
+
+/* Resources of the sysclock timer reserved by the kernel */
+#if CONFIG_KERNEL_HRTIMER
+#define TIMER_RES_SYSCLOCK                                                               \
+	(TIMER_RES_COUNTER | TIMER_RES_CHANNEL_A | BIT(CONFIG_KERNEL_HRTIMER_CHANNEL))
+#else
+#define TIMER_RES_SYSCLOCK (TIMER_RES_COUNTER | TIMER_RES_CHANNEL_A)
+#endif
+
+/* Resources allocated on each timer */
+static uint8_t tim_res[TIMERS_COUNT] = {
+	[CONFIG_KERNEL_SYSLOCK_HW_TIMER] = TIMER_RES_SYSCLOCK,
+};
+
+int8_t timer_alloc(uint8_t tim_idx, uint8_t res)
+{
+	if (!TIMER_INDEX_EXISTS(tim_idx) || (res == 0u)) {
+		return -EINVAL;
+	}
+
+	/* 8 bits timers have two channels and no input capture */
+	if (_is_16bits(tim_idx)) {
+		if (res & ~(TIMER_RES_COUNTER | TIMER_RES_CHANNELS | TIMER_RES_CAPTURE)) {
+			return -EINVAL;
+		}
+	} else if (res & ~(TIMER_RES_COUNTER | TIMER_RES_CHANNEL_A | TIMER_RES_CHANNEL_B)) {
+		return -EINVAL;
+	}
+
+	int8_t ret		  = -EBUSY;
+	const uint8_t key = irq_lock();
+
+	if ((tim_res[tim_idx] & res) == 0u) {
+		tim_res[tim_idx] |= res;
+		ret = 0;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+void timer_free(uint8_t tim_idx, uint8_t res)
+{
+	__ASSERT_TRUE(TIMER_INDEX_EXISTS(tim_idx));
+
+	const uint8_t key = irq_lock();
+	tim_res[tim_idx] &= ~res;
+	irq_unlock(key);
+}
+
+uint8_t timer_alloc_get(uint8_t tim_idx)
+{
+	__ASSERT_TRUE(TIMER_INDEX_EXISTS(tim_idx));
+
+	return tim_res[tim_idx];
+}
+
+/* COMnx bits (TCCRnA) of the channels of a resources mask */
+static inline uint8_t timer_res_com_bits(uint8_t res)
+{
+	uint8_t bits = 0u;
+
+	for (uint8_t ch = 0u; ch < TIMER_CHANNELS_COUNT; ch++) {
+		if (res & BIT(ch)) {
+			bits |= 0x03u << (2u * (2u - ch) + 2u);
+		}
+	}
+
+	return bits;
+}
+
 #if DRIVERS_TIMERS_API
 
 static void *_get_device(uint8_t tim_idx)
@@ -330,6 +412,31 @@ __STATIC_ASSERT(CONFIG_KERNEL_SYSLOCK_HW_TIMER != 5,
 __DECL_TIMER_COMPA_ISR(5);
 #endif /* CONFIG_DRIVERS_TIMER5_API */
 
+#if CONFIG_KERNEL_PM
+/* Timers running with this API, each one holds a reference on clk_IO */
+static uint8_t tim_running;
+#endif
+
+static void timer_set_running(uint8_t tim_idx, bool running)
+{
+#if CONFIG_KERNEL_PM
+	const uint8_t key = irq_lock();
+
+	if (running && !(tim_running & BIT(tim_idx))) {
+		tim_running |= BIT(tim_idx);
+		k_pm_require(K_PM_CAP_CLK_IO);
+	} else if (!running && (tim_running & BIT(tim_idx))) {
+		tim_running &= ~BIT(tim_idx);
+		k_pm_release(K_PM_CAP_CLK_IO);
+	}
+
+	irq_unlock(key);
+#else
+	ARG_UNUSED(tim_idx);
+	ARG_UNUSED(running);
+#endif /* CONFIG_KERNEL_PM */
+}
+
 int8_t timer_init(uint8_t tim_idx,
 				  uint32_t period_us,
 				  timer_callback_t cb,
@@ -352,15 +459,28 @@ int8_t timer_init(uint8_t tim_idx,
 		return prescaler_id;
 	}
 
+	/* The timer can be initialized again with this API */
+	if (tim_ctx[tim_idx].cb == NULL) {
+		const int8_t ret = timer_alloc(tim_idx, TIMER_RES_COUNTER | TIMER_RES_CHANNEL_A);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
 	tim_ctx[tim_idx].cb		   = cb;
 	tim_ctx[tim_idx].user_data = user_data;
 	tim_ctx[tim_idx].prescaler = prescaler_id;
 
+	/* The channels B and C may be used by other clients, TCCRnA is at the same
+	 * offset for all timers */
+	const uint8_t others = timer_res_com_bits(TIMER_RES_CHANNEL_B | TIMER_RES_CHANNEL_C);
+	const uint8_t tccra	 = ((TIMER8_Device *)dev)->TCCRnA & others;
+
 	const struct timer_config cfg = {
 		.mode	   = TIMER_MODE_CTC,
 		.prescaler = (flags & TIMER_API_FLAG_AUTOSTART) ? prescaler_id : 0U,
 		.counter   = counter,
-		.timsk	   = BIT(OCIEnA)};
+		.timsk	   = BIT(OCIEnA) | (TIMSKn[tim_idx] & (BIT(OCIEnB) | BIT(OCIEnC)))};
 
 	const bool is_16bit_timer = _is_16bits(tim_idx);
 	if (is_16bit_timer) {
@@ -369,6 +489,35 @@ int8_t timer_init(uint8_t tim_idx,
 		ll_timer8_init((TIMER8_Device *)dev, tim_idx, &cfg);
 	}
 
+	((TIMER8_Device *)dev)->TCCRnA |= tccra;
+
+	timer_set_running(tim_idx, flags & TIMER_API_FLAG_AUTOSTART);
+
+	return 0;
+}
+
+int8_t timer_deinit(uint8_t tim_idx)
+{
+	if (!TIMER_INDEX_EXISTS(tim_idx) || (tim_ctx[tim_idx].cb == NULL)) {
+		return -EINVAL;
+	}
+
+	TIMER8_Device *const dev = _get_device(tim_idx);
+
+	const uint8_t key = irq_lock();
+
+	/* TCCRnA and TCCRnB are at the same offsets for all timers */
+	dev->TCCRnB = 0u;
+	dev->TCCRnA &= ~(timer_res_com_bits(TIMER_RES_CHANNEL_A) | BIT(WGMn0) | BIT(WGMn1));
+	TIMER_TIMSK_CLEAR_OCIEA(tim_idx);
+	TIFRn[tim_idx] = BIT(OCFnA);
+
+	tim_ctx[tim_idx].cb = NULL;
+	timer_free(tim_idx, TIMER_RES_COUNTER | TIMER_RES_CHANNEL_A);
+	timer_set_running(tim_idx, false);
+
+	irq_unlock(key);
+
 	return 0;
 }
 
@@ -378,6 +527,7 @@ void timer_start(uint8_t tim_idx)
 
 	void *const dev = _get_device(tim_idx);
 	if (dev != NULL) {
+		timer_set_running(tim_idx, true);
 		ll_timer_start(dev, timer_get_prescaler(tim_idx));
 	}
 }
@@ -389,6 +539,7 @@ void timer_stop(uint8_t tim_idx)
 	void *const dev = _get_device(tim_idx);
 	if (dev != NULL) {
 		ll_timer_stop(dev);
+		timer_set_running(tim_idx, false);
 	}
 }
 
@@ -410,4 +561,1043 @@ uint32_t timer_get_max_period_us(uint8_t tim_idx)
 	}
 }
 
-#endif /* DRIVERS_TIMERS_API */
\ No newline at end of file
+#endif /* DRIVERS_TIMERS_API */
+#if CONFIG_DRIVERS_TIMER_CAPTURE
+
+static struct timer_capture *tim_capture[TIMERS_COUNT];
+
+static void timer_capture_handler(TIMER16_Device *dev, uint8_t tim_idx)
+{
+	struct timer_capture *const cap = tim_capture[tim_idx];
+
+	/* ICRnL is read first, as required for a 16-bit read */
+	const uint16_t icr = dev->IRCN;
+	uint16_t ovf	   = cap->_ovf;
+
+	/* The capture interrupt has a higher priority than the overflow one, an
+	 * overflow can be pending but not yet counted. A low capture value means
+	 * the capture occurred after the overflow. */
+	if ((TIFRn[tim_idx] & BIT(TOVn)) && (icr < 0x8000u)) {
+		ovf++;
+	}
+
+	const uint8_t rising = (dev->TCCRnB >> ICESn) & 1u;
+
+	if (cap->edge == TIMER_CAPTURE_EDGE_BOTH) {
+		/* Changing the edge may set ICFn, which must be cleared afterwards */
+		dev->TCCRnB ^= BIT(ICESn);
+		TIFRn[tim_idx] = BIT(ICFn);
+	}
+
+	uint16_t w = (uint16_t)cap->_r + cap->_count;
+	if (w >= cap->size) {
+		w -= cap->size;
+	}
+	cap->buf[w] = ((uint32_t)ovf << 16u) | icr;
+
+	if (cap->_count == 0u) {
+		cap->_rising = rising;
+	}
+
+	if (cap->_count == cap->size) {
+		/* Overwrite the oldest capture */
+		if (++cap->_r == cap->size) {
+			cap->_r = 0u;
+		}
+		cap->_rising ^= 1u;
+		cap->overruns++;
+	} else {
+		cap->_count++;
+	}
+
+	if (cap->_threshold && (cap->_count >= cap->_threshold)) {
+		cap->_threshold				= 0u;
+		struct k_thread *const thread = k_sem_give(&cap->_sem);
+		k_yield_from_isr_cond(thread);
+	}
+}
+
+int8_t timer_capture_start(uint8_t tim_idx, struct timer_capture *cap)
+{
+	Z_ARGS_CHECK(TIMER_INDEX_EXISTS(tim_idx) && TIMER_CAPTURE_ENABLED(tim_idx))
+	return -EINVAL;
+	Z_ARGS_CHECK(cap && cap->buf && cap->size) return -EINVAL;
+	Z_ARGS_CHECK(timer_get_prescaler_value(cap->prescaler) > 0) return -EINVAL;
+
+	/* The capture can be restarted */
+	if ((tim_capture[tim_idx] == NULL) &&
+		(timer_alloc(tim_idx, TIMER_RES_COUNTER | TIMER_RES_CAPTURE) != 0)) {
+		return -EBUSY;
+	}
+
+	TIMER16_Device *const dev = timer_get_device(tim_idx);
+
+	k_sem_init(&cap->_sem, 0u, 1u);
+	cap->_r			= 0u;
+	cap->_count		= 0u;
+	cap->_threshold = 0u;
+	cap->_ovf		= 0u;
+	cap->overruns	= 0u;
+
+	const uint8_t key = irq_lock();
+
+	ll_timer16_stop(dev);
+	TIMER_TIMSK_CLEAR_ICIE(tim_idx);
+	TIMER_TIMSK_CLEAR_TOIE(tim_idx);
+
+#if CONFIG_KERNEL_PM
+	/* The timer is clocked by clk_IO, unless restarted */
+	if (tim_capture[tim_idx] == NULL) {
+		k_pm_require(K_PM_CAP_CLK_IO);
+	}
+#endif
+
+	tim_capture[tim_idx] = cap;
+
+	/* Normal mode, the timer counts up to 0xFFFF. The compare channels may be
+	 * used by other clients, only the WGM bits of TCCRnA are changed */
+	dev->TCCRnA &= ~(BIT(WGMn0) | BIT(WGMn1));
+	dev->TCCRnB = (cap->noise_canceler ? BIT(ICNCn) : 0u) |
+				  (cap->edge != TIMER_CAPTURE_EDGE_FALLING ? BIT(ICESn) : 0u);
+	ll_timer16_counter_reset(dev);
+
+	TIFRn[tim_idx] = BIT(ICFn) | BIT(TOVn);
+	TIMER_TIMSK_SET_ICIE(tim_idx);
+	TIMER_TIMSK_SET_TOIE(tim_idx);
+	ll_timer16_start(dev, cap->prescaler);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t timer_capture_stop(uint8_t tim_idx)
+{
+	Z_ARGS_CHECK(TIMER_INDEX_EXISTS(tim_idx) && TIMER_CAPTURE_ENABLED(tim_idx))
+	return -EINVAL;
+
+	if (tim_capture[tim_idx] == NULL) {
+		return -EINVAL;
+	}
+
+	const uint8_t key = irq_lock();
+
+	ll_timer16_stop(timer_get_device(tim_idx));
+	TIMER_TIMSK_CLEAR_ICIE(tim_idx);
+	TIMER_TIMSK_CLEAR_TOIE(tim_idx);
+	TIFRn[tim_idx]		 = BIT(ICFn) | BIT(TOVn);
+	tim_capture[tim_idx] = NULL;
+	timer_free(tim_idx, TIMER_RES_COUNTER | TIMER_RES_CAPTURE);
+
+#if CONFIG_KERNEL_PM
+	k_pm_release(K_PM_CAP_CLK_IO);
+#endif
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t timer_capture_wait(struct timer_capture *cap, uint8_t n, k_timeout_t timeout)
+{
+	Z_ARGS_CHECK(cap && n && (n <= cap->size)) return -EINVAL;
+
+	int8_t ret;
+	uint8_t key = irq_lock();
+
+	if (cap->_count >= n) {
+		irq_unlock(key);
+		return 0;
+	}
+
+	/* Discard a notification given after a previous timeout */
+	k_sem_take(&cap->_sem, K_NO_WAIT);
+	cap->_threshold = n;
+
+	irq_unlock(key);
+
+	ret = k_sem_take(&cap->_sem, timeout);
+	if (ret != 0) {
+		key				= irq_lock();
+		cap->_threshold = 0u;
+		irq_unlock(key);
+	}
+
+	return ret;
+}
+
+uint8_t timer_capture_count(struct timer_capture *cap)
+{
+	return cap->_count;
+}
+
+uint8_t timer_capture_read(struct timer_capture *cap, uint32_t *ts, uint8_t n)
+{
+	uint8_t i;
+
+	const uint8_t key = irq_lock();
+
+	for (i = 0u; (i < n) && (cap->_count != 0u); i++) {
+		ts[i] = cap->buf[cap->_r];
+		if (++cap->_r == cap->size) {
+			cap->_r = 0u;
+		}
+		cap->_count--;
+		cap->_rising ^= 1u;
+	}
+
+	irq_unlock(key);
+
+	return i;
+}
+
+void timer_capture_flush(struct timer_capture *cap)
+{
+	const uint8_t key = irq_lock();
+	cap->_count		  = 0u;
+	irq_unlock(key);
+}
+
+/* Get the n latest captures, from the newest to the oldest, and the edge of the
+ * newest one. Requires interrupts to be disabled. */
+static bool timer_capture_latest(struct timer_capture *cap, uint32_t *ts, uint8_t n, uint8_t *rising)
+{
+	if (cap->_count < n) {
+		return false;
+	}
+
+	uint16_t idx = (uint16_t)cap->_r + cap->_count - 1u;
+	if (idx >= cap->size) {
+		idx -= cap->size;
+	}
+
+	*rising = cap->_rising ^ ((cap->_count - 1u) & 1u);
+
+	for (uint8_t i = 0u; i < n; i++) {
+		ts[i] = cap->buf[idx];
+		idx	  = (idx == 0u) ? cap->size - 1u : idx - 1u;
+	}
+
+	return true;
+}
+
+int8_t timer_capture_period(struct timer_capture *cap, uint32_t *period)
+{
+	uint32_t ts[3u];
+	uint8_t rising;
+
+	/* The period is measured between two edges of the same kind */
+	const uint8_t n = (cap->edge == TIMER_CAPTURE_EDGE_BOTH) ? 3u : 2u;
+
+	const uint8_t key = irq_lock();
+	const bool ok	  = timer_capture_latest(cap, ts, n, &rising);
+	irq_unlock(key);
+
+	if (!ok) {
+		return -EAGAIN;
+	}
+
+	*period = ts[0u] - ts[n - 1u];
+
+	return 0;
+}
+
+int8_t timer_capture_frequency(struct timer_capture *cap, uint32_t *freq_mhz)
+{
+	uint32_t period;
+
+	const int8_t ret = timer_capture_period(cap, &period);
+	if (ret != 0) {
+		return ret;
+	}
+
+	const uint32_t clk = F_CPU / (uint32_t)timer_get_prescaler_value(cap->prescaler);
+
+	*freq_mhz = ((uint64_t)clk * 1000u) / period;
+
+	return 0;
+}
+
+int8_t timer_capture_duty_cycle(struct timer_capture *cap, uint16_t *permille)
+{
+	uint32_t ts[3u];
+	uint8_t rising;
+
+	if (cap->edge != TIMER_CAPTURE_EDGE_BOTH) {
+		return -ENOTSUP;
+	}
+
+	const uint8_t key = irq_lock();
+	const bool ok	  = timer_capture_latest(cap, ts, 3u, &rising);
+	irq_unlock(key);
+
+	if (!ok) {
+		return -EAGAIN;
+	}
+
+	/* rising, falling, rising: the high level is between the two oldest edges
+	 * falling, rising, falling: the high level is between the two newest edges */
+	const uint32_t high	  = rising ? ts[1u] - ts[2u] : ts[0u] - ts[1u];
+	const uint32_t period = ts[0u] - ts[2u];
+
+	*permille = (uint16_t)(((uint64_t)high * 1000u) / period);
+
+	return 0;
+}
+
+#endif /* CONFIG_DRIVERS_TIMER_CAPTURE */
+
+#if CONFIG_DRIVERS_TIMER_PWM
+
+#define TIMER_PWM_CHANNELS_MASK (BIT(TIMER_CHANNELS_COUNT) - 1u)
+
+static struct timer_pwm *tim_pwm[TIMERS_COUNT];
+
+static bool timer_pwm_mode_valid(timer_mode_t mode)
+{
+	switch (mode) {
+	case TIMER_MODE_NORMAL:
+	case TIMER_MODE_CTC:
+	case TIMER_MODE_CTC_ICRn:
+	case TIMER_MODE_RESERVED:
+		return false;
+	default:
+		return true;
+	}
+}
+
+static bool timer_pwm_mode_fast(timer_mode_t mode)
+{
+	switch (mode) {
+	case TIMER_MODE_FAST_PWM_8bit:
+	case TIMER_MODE_FAST_PWM_9bit:
+	case TIMER_MODE_FAST_PWM_10bit:
+	case TIMER_MODE_FAST_PWM_ICR1:
+	case TIMER_MODE_FAST_PWM_OCR1A:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void timer_pwm_write(TIMER16_Device *dev, uint8_t mask, const uint16_t *values)
+{
+	for (uint8_t ch = 0u; mask != 0u; ch++, mask >>= 1u) {
+		if (mask & 1u) {
+			ll_timer16_write_reg16(&dev->OCRnx[ch], *values);
+		}
+		values++;
+	}
+}
+
+static void timer_pwm_handler(TIMER16_Device *dev, uint8_t tim_idx)
+{
+	struct timer_pwm *const pwm			= tim_pwm[tim_idx];
+	struct k_thread *thread				= NULL;
+	const struct timer_pwm_waveform *wf = pwm->_wf;
+
+	/* In fast PWM modes, the interrupt may be served at TOP, before the OCRnx
+	 * buffers are latched at BOTTOM: wait for the counter to leave TOP so that
+	 * all the values written below are latched together at the next BOTTOM */
+	if (pwm->_fast) {
+		const uint16_t cnt = ll_timer16_get_tcnt(dev);
+		if (cnt != 0u) {
+			while (ll_timer16_get_tcnt(dev) == cnt) {
+			}
+		}
+	}
+
+	/* The values written here are latched together by the next update of the
+	 * OCRnx buffers, at TOP or BOTTOM */
+	if (pwm->_next_mask != 0u) {
+		timer_pwm_write(dev, pwm->_next_mask, pwm->_next);
+		pwm->_next_mask = 0u;
+	}
+
+	if ((wf != NULL) && (--pwm->_periods == 0u)) {
+		uint8_t mask = wf->channels;
+
+		for (uint8_t ch = 0u; mask != 0u; ch++, mask >>= 1u) {
+			if (mask & 1u) {
+				ll_timer16_write_reg16(&dev->OCRnx[ch], *pwm->_entry++);
+			}
+		}
+
+		pwm->_periods = wf->periods;
+
+		if (--pwm->_steps == 0u) {
+			if (wf->loop) {
+				pwm->_entry = wf->table;
+				pwm->_steps = wf->steps;
+			} else {
+				pwm->_wf = NULL;
+				thread	 = k_sem_give(&pwm->_sem);
+			}
+		}
+	}
+
+	if (pwm->_wf == NULL) {
+		TIMER_TIMSK_CLEAR_TOIE(tim_idx);
+	}
+
+	k_yield_from_isr_cond(thread);
+}
+
+/* Resources used by a PWM configuration */
+static uint8_t timer_pwm_resources(const struct timer_pwm_config *config)
+{
+	uint8_t res = TIMER_RES_COUNTER;
+
+	for (uint8_t ch = 0u; ch < TIMER_CHANNELS_COUNT; ch++) {
+		if (config->com[ch] != TIMER_CHANNEL_COMP_MODE_NORMAL) {
+			res |= BIT(ch);
+		}
+	}
+
+	switch (config->mode) {
+	case TIMER_MODE_PWM_PHASE_FREQUENCY_CORRECT_OCRnA:
+	case TIMER_MODE_PWM_PHASE_CORRECT_OCRnA:
+	case TIMER_MODE_FAST_PWM_OCR1A:
+		/* OCRnA is the TOP value */
+		res |= TIMER_RES_CHANNEL_A;
+		break;
+	case TIMER_MODE_PWM_PHASE_FREQUENCY_CORRECT_ICRn:
+	case TIMER_MODE_PWM_PHASE_CORRECT_ICRn:
+	case TIMER_MODE_FAST_PWM_ICR1:
+		/* ICRn is the TOP value */
+		res |= TIMER_RES_CAPTURE;
+		break;
+	default:
+		break;
+	}
+
+	return res;
+}
+
+/* Get the PWM context of a timer, NULL if not started */
+static struct timer_pwm *timer_pwm_get(uint8_t tim_idx)
+{
+	if (!TIMER_INDEX_EXISTS(tim_idx) || !TIMER_PWM_ENABLED(tim_idx)) {
+		return NULL;
+	}
+
+	return tim_pwm[tim_idx];
+}
+
+/* Enable the overflow interrupt. TOVn is set at every overflow while TOIEn is
+ * cleared, a stale flag would run the handler at once, at any point of the PWM
+ * period. Requires interrupts to be disabled */
+static void timer_pwm_ovf_enable(uint8_t tim_idx)
+{
+	if (!(TIMSKn[tim_idx] & BIT(TOIEn))) {
+		TIFRn[tim_idx] = BIT(TOVn);
+		TIMER_TIMSK_SET_TOIE(tim_idx);
+	}
+}
+
+/* Check that the PWM of all the timers of the mask is started */
+static bool timer_pwm_started(uint8_t timers)
+{
+	if ((timers == 0u) || (timers & ~CONFIG_DRIVERS_TIMER_PWM)) {
+		return false;
+	}
+
+	for (uint8_t i = 0u; i < TIMERS_COUNT; i++) {
+		if ((timers & BIT(i)) && (tim_pwm[i] == NULL)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int8_t timer_pwm_start(uint8_t tim_idx,
+					   struct timer_pwm *pwm,
+					   const struct timer_pwm_config *config)
+{
+	Z_ARGS_CHECK(TIMER_INDEX_EXISTS(tim_idx) && TIMER_PWM_ENABLED(tim_idx))
+	return -EINVAL;
+	Z_ARGS_CHECK(pwm && config && timer_pwm_mode_valid(config->mode)) return -EINVAL;
+	Z_ARGS_CHECK(timer_get_prescaler_value(config->prescaler) > 0) return -EINVAL;
+
+	const uint8_t res		  = timer_pwm_resources(config);
+	TIMER16_Device *const dev = timer_get_device(tim_idx);
+
+	const uint8_t key = irq_lock();
+
+	/* The PWM can be restarted, with other resources */
+	struct timer_pwm *const prev = tim_pwm[tim_idx];
+	if (prev != NULL) {
+		timer_free(tim_idx, prev->_res);
+	}
+
+	if (timer_alloc(tim_idx, res) != 0) {
+		if (prev != NULL) {
+			timer_alloc(tim_idx, prev->_res);
+		}
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	ll_timer16_stop(dev);
+	TIMER_TIMSK_CLEAR_TOIE(tim_idx);
+
+#if CONFIG_KERNEL_PM
+	/* The timer is clocked by clk_IO, unless restarted */
+	if (prev == NULL) {
+		k_pm_require(K_PM_CAP_CLK_IO);
+	}
+#endif
+
+	k_sem_init(&pwm->_sem, 0u, 1u);
+	pwm->_res		  = res;
+	pwm->_staged_mask = 0u;
+	pwm->_next_mask	  = 0u;
+	pwm->_wf		  = NULL;
+	pwm->_fast		  = timer_pwm_mode_fast(config->mode);
+
+	tim_pwm[tim_idx] = pwm;
+
+	/* Only the WGM bits and the COMnx bits of the channels owned (previously
+	 * or now) are rewritten, the other channels may be used by other clients */
+	const uint8_t com = timer_res_com_bits(res | (prev ? prev->_res : 0u));
+	const uint8_t wgm = (config->mode & 0x03u) << WGMn0;
+
+	dev->TCCRnA = (dev->TCCRnA & ~(com | BIT(WGMn0) | BIT(WGMn1))) | wgm;
+	dev->TCCRnB = ((config->mode >> 2u) & 0x03u) << WGMn2;
+	TIMSKn[tim_idx] &= ~((res & TIMER_RES_CHANNELS) << OCIEnA);
+
+	if (res & TIMER_RES_CAPTURE) {
+		ll_timer16_write_reg16(&dev->IRCN, config->top);
+	}
+
+	for (uint8_t ch = 0u; ch < TIMER_CHANNELS_COUNT; ch++) {
+		if (res & BIT(ch)) {
+			const struct timer_channel_compare_config comp = {
+				.mode  = config->com[ch],
+				.value = config->duty[ch],
+			};
+			ll_timer16_channel_configure(dev, ch, &comp);
+		}
+	}
+
+	ll_timer16_counter_reset(dev);
+	TIFRn[tim_idx] = BIT(TOVn);
+	ll_timer16_start(dev, config->prescaler);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t timer_pwm_stop(uint8_t tim_idx)
+{
+	if (timer_pwm_get(tim_idx) == NULL) {
+		return -EINVAL;
+	}
+
+	TIMER16_Device *const dev = timer_get_device(tim_idx);
+
+	const uint8_t key = irq_lock();
+
+	ll_timer16_stop(dev);
+	TIMER_TIMSK_CLEAR_TOIE(tim_idx);
+	TIFRn[tim_idx] = BIT(TOVn);
+
+	/* Disconnect the outputs owned, the other channels are left untouched */
+	const uint8_t com = timer_res_com_bits(tim_pwm[tim_idx]->_res);
+	dev->TCCRnA &= ~(com | BIT(WGMn0) | BIT(WGMn1));
+	dev->TCCRnB = 0u;
+
+	timer_free(tim_idx, tim_pwm[tim_idx]->_res);
+	tim_pwm[tim_idx] = NULL;
+
+#if CONFIG_KERNEL_PM
+	k_pm_release(K_PM_CAP_CLK_IO);
+#endif
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t timer_pwm_stage(uint8_t tim_idx, timer_channel_t channel, uint16_t value)
+{
+	struct timer_pwm *const pwm = timer_pwm_get(tim_idx);
+
+	Z_ARGS_CHECK(pwm && (channel < TIMER_CHANNELS_COUNT) && (pwm->_res & BIT(channel)))
+	return -EINVAL;
+
+	const uint8_t key	  = irq_lock();
+	pwm->_staged[channel] = value;
+	pwm->_staged_mask |= BIT(channel);
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t timer_pwm_commit(uint8_t timers)
+{
+	int8_t ret		  = -EINVAL;
+	const uint8_t key = irq_lock();
+
+	if (timer_pwm_started(timers)) {
+		for (uint8_t i = 0u; i < TIMERS_COUNT; i++) {
+			struct timer_pwm *const pwm = tim_pwm[i];
+
+			if (!(timers & BIT(i)) || (pwm->_staged_mask == 0u)) {
+				continue;
+			}
+
+			for (uint8_t ch = 0u; ch < TIMER_CHANNELS_COUNT; ch++) {
+				if (pwm->_staged_mask & BIT(ch)) {
+					pwm->_next[ch] = pwm->_staged[ch];
+				}
+			}
+
+			pwm->_next_mask |= pwm->_staged_mask;
+			pwm->_staged_mask = 0u;
+
+			timer_pwm_ovf_enable(i);
+		}
+
+		ret = 0;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+int8_t timer_pwm_sync(uint8_t timers)
+{
+	int8_t ret		  = -EINVAL;
+	const uint8_t key = irq_lock();
+
+	if (timer_pwm_started(timers)) {
+		/* Halt and reset the prescaler of the synchronous timers, the sysclock
+		 * timer is delayed as well if it is clocked by this prescaler */
+		GTCCR = BIT(TSM) | BIT(PSRSYNC);
+
+		for (uint8_t i = 0u; i < TIMERS_COUNT; i++) {
+			if (timers & BIT(i)) {
+				ll_timer16_counter_reset(timer_get_device(i));
+			}
+		}
+
+		/* All the counters start again from the same prescaler clock */
+		GTCCR = 0u;
+
+		ret = 0;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+int8_t timer_pwm_waveform_start(uint8_t tim_idx, const struct timer_pwm_waveform *wf)
+{
+	Z_ARGS_CHECK(wf && wf->table && wf->steps && wf->periods) return -EINVAL;
+	Z_ARGS_CHECK(wf->channels && !(wf->channels & ~TIMER_PWM_CHANNELS_MASK))
+	return -EINVAL;
+
+	int8_t ret		  = -EINVAL;
+	const uint8_t key = irq_lock();
+
+	struct timer_pwm *const pwm = timer_pwm_get(tim_idx);
+	if ((pwm != NULL) && !(wf->channels & ~pwm->_res)) {
+		/* Discard the notification of a previous waveform */
+		k_sem_take(&pwm->_sem, K_NO_WAIT);
+
+		pwm->_wf	  = wf;
+		pwm->_entry	  = wf->table;
+		pwm->_steps	  = wf->steps;
+		pwm->_periods = 1u;
+
+		timer_pwm_ovf_enable(tim_idx);
+
+		ret = 0;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+int8_t timer_pwm_waveform_stop(uint8_t tim_idx)
+{
+	int8_t ret		  = -EINVAL;
+	const uint8_t key = irq_lock();
+
+	struct timer_pwm *const pwm = timer_pwm_get(tim_idx);
+	if (pwm != NULL) {
+		/* The overflow interrupt is disabled by the handler */
+		if (pwm->_wf != NULL) {
+			pwm->_wf = NULL;
+			k_sem_give(&pwm->_sem);
+		}
+		ret = 0;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+int8_t timer_pwm_waveform_wait(uint8_t tim_idx, k_timeout_t timeout)
+{
+	const uint8_t key = irq_lock();
+
+	struct timer_pwm *const pwm = timer_pwm_get(tim_idx);
+	if (pwm == NULL) {
+		irq_unlock(key);
+		return -EINVAL;
+	} else if (pwm->_wf == NULL) {
+		irq_unlock(key);
+		return 0;
+	}
+
+	irq_unlock(key);
+
+	return k_sem_take(&pwm->_sem, timeout);
+}
+
+#endif /* CONFIG_DRIVERS_TIMER_PWM */
+
+#if CONFIG_DRIVERS_TIMER_MUX
+
+static struct timer_mux *tim_mux[TIMERS_COUNT];
+
+/* Requires interrupts to be disabled */
+static uint32_t timer_mux_counter(struct timer_mux *mux)
+{
+	TIMER16_Device *const dev = timer_get_device(mux->_tim_idx);
+
+	const uint16_t cnt = ll_timer16_get_tcnt(dev);
+	uint16_t ovf	   = mux->_ovf;
+
+	/* The counter wrapped but the overflow interrupt did not run yet */
+	if ((TIFRn[mux->_tim_idx] & BIT(TOVn)) && (cnt < 0x8000u)) {
+		ovf++;
+	}
+
+	return ((uint32_t)ovf << 16u) | cnt;
+}
+
+static void timer_mux_insert(struct timer_mux *mux, struct timer_alarm *alarm)
+{
+	struct timer_alarm **prev = &mux->_alarms;
+
+	/* Alarms with the same deadline expire in the order they were started */
+	while ((*prev != NULL) && ((int32_t)(alarm->deadline - (*prev)->deadline) >= 0)) {
+		prev = &(*prev)->_next;
+	}
+
+	alarm->_next	 = *prev;
+	alarm->scheduled = 1u;
+	*prev			 = alarm;
+}
+
+/**
+ * @brief Call the handlers of the expired alarms and program the channel A for
+ * the earliest remaining deadline.
+ *
+ * Requires interrupts to be disabled.
+ */
+static void timer_mux_update(struct timer_mux *mux)
+{
+	const uint8_t tim_idx	  = mux->_tim_idx;
+	TIMER16_Device *const dev = timer_get_device(tim_idx);
+	struct timer_alarm *alarm;
+
+	if (mux->_processing) {
+		return;
+	}
+
+	mux->_processing = 1u;
+
+	for (;;) {
+		uint32_t now = timer_mux_counter(mux);
+
+		while (((alarm = mux->_alarms) != NULL) &&
+			   ((int32_t)(alarm->deadline - now) <= 0)) {
+			mux->_alarms	 = alarm->_next;
+			alarm->scheduled = 0u;
+			alarm->handler(alarm);
+		}
+
+		if (alarm == NULL) {
+			TIMER_TIMSK_CLEAR_OCIEA(tim_idx);
+			break;
+		}
+
+		/* The channel matches once per counter period, the interrupt is a no-op
+		 * until the period of the deadline is reached */
+		ll_timer16_write_reg16(&dev->OCRnA, (uint16_t)alarm->deadline);
+		TIFRn[tim_idx] = BIT(OCFnA);
+		TIMER_TIMSK_SET_OCIEA(tim_idx);
+
+		/* If the counter went past the deadline while programming the channel,
+		 * the match is missed: process the alarm right away */
+		now = timer_mux_counter(mux);
+		if ((int32_t)(alarm->deadline - now) > 0) {
+			break;
+		}
+	}
+
+	mux->_processing = 0u;
+}
+
+int8_t timer_mux_start(uint8_t tim_idx, struct timer_mux *mux, uint8_t prescaler)
+{
+	Z_ARGS_CHECK(TIMER_INDEX_EXISTS(tim_idx) && TIMER_MUX_ENABLED(tim_idx))
+	return -EINVAL;
+	Z_ARGS_CHECK(mux && (timer_get_prescaler_value(prescaler) > 0)) return -EINVAL;
+
+	const int8_t ret = timer_alloc(tim_idx, TIMER_RES_COUNTER | TIMER_RES_CHANNEL_A);
+	if (ret != 0) {
+		return ret;
+	}
+
+	TIMER16_Device *const dev = timer_get_device(tim_idx);
+
+	mux->_alarms	 = NULL;
+	mux->_ovf		 = 0u;
+	mux->_tim_idx	 = tim_idx;
+	mux->_processing = 0u;
+
+	const uint8_t key = irq_lock();
+
+#if CONFIG_KERNEL_PM
+	k_pm_require(K_PM_CAP_CLK_IO);
+#endif
+
+	tim_mux[tim_idx] = mux;
+
+	/* Normal mode, the timer counts up to 0xFFFF. Only the counter interrupts
+	 * are changed, the channels B and C may be used by other clients */
+	dev->TCCRnA &= ~(BIT(WGMn0) | BIT(WGMn1));
+	dev->TCCRnB = 0u;
+	ll_timer16_counter_reset(dev);
+
+	TIFRn[tim_idx] = BIT(TOVn) | BIT(OCFnA);
+	TIMER_TIMSK_CLEAR_OCIEA(tim_idx);
+	TIMER_TIMSK_SET_TOIE(tim_idx);
+	ll_timer16_start(dev, prescaler);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t timer_mux_stop(struct timer_mux *mux)
+{
+	Z_ARGS_CHECK(mux) return -EINVAL;
+
+	const uint8_t tim_idx = mux->_tim_idx;
+
+	Z_ARGS_CHECK(TIMER_INDEX_EXISTS(tim_idx) && TIMER_MUX_ENABLED(tim_idx))
+	return -EINVAL;
+
+	const uint8_t key = irq_lock();
+
+	if (tim_mux[tim_idx] != mux) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	ll_timer16_stop(timer_get_device(tim_idx));
+	TIMER_TIMSK_CLEAR_OCIEA(tim_idx);
+	TIMER_TIMSK_CLEAR_TOIE(tim_idx);
+
+	for (struct timer_alarm *alarm = mux->_alarms; alarm != NULL; alarm = alarm->_next) {
+		alarm->scheduled = 0u;
+	}
+	mux->_alarms = NULL;
+
+	tim_mux[tim_idx] = NULL;
+	timer_free(tim_idx, TIMER_RES_COUNTER | TIMER_RES_CHANNEL_A);
+
+#if CONFIG_KERNEL_PM
+	k_pm_release(K_PM_CAP_CLK_IO);
+#endif
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+uint32_t timer_mux_now(struct timer_mux *mux)
+{
+	const uint8_t key  = irq_lock();
+	const uint32_t now = timer_mux_counter(mux);
+	irq_unlock(key);
+
+	return now;
+}
+
+int8_t timer_alarm_init(struct timer_alarm *alarm, timer_alarm_handler_t handler)
+{
+	Z_ARGS_CHECK(alarm && handler) return -EINVAL;
+
+	alarm->_next	 = NULL;
+	alarm->handler	 = handler;
+	alarm->scheduled = 0u;
+
+	return 0;
+}
+
+static int8_t timer_alarm_schedule(struct timer_mux *mux,
+								   struct timer_alarm *alarm,
+								   uint32_t counts,
+								   bool forward)
+{
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	if (alarm->scheduled) {
+		ret = -EAGAIN;
+		goto exit;
+	}
+
+	if (!forward) {
+		alarm->deadline = timer_mux_counter(mux);
+	}
+	alarm->deadline += counts;
+
+	timer_mux_insert(mux, alarm);
+	timer_mux_update(mux);
+
+exit:
+	irq_unlock(key);
+	return ret;
+}
+
+int8_t timer_alarm_start(struct timer_mux *mux, struct timer_alarm *alarm, uint32_t counts)
+{
+	Z_ARGS_CHECK(mux && alarm && alarm->handler) return -EINVAL;
+
+	return timer_alarm_schedule(mux, alarm, counts, false);
+}
+
+int8_t timer_alarm_forward(struct timer_mux *mux, struct timer_alarm *alarm, uint32_t counts)
+{
+	Z_ARGS_CHECK(mux && alarm && alarm->handler) return -EINVAL;
+
+	return timer_alarm_schedule(mux, alarm, counts, true);
+}
+
+int8_t timer_alarm_cancel(struct timer_mux *mux, struct timer_alarm *alarm)
+{
+	Z_ARGS_CHECK(mux && alarm) return -EINVAL;
+
+	int8_t ret		  = -EAGAIN;
+	const uint8_t key = irq_lock();
+
+	struct timer_alarm **prev;
+
+	for (prev = &mux->_alarms; *prev != NULL; prev = &(*prev)->_next) {
+		if (*prev == alarm) {
+			*prev			 = alarm->_next;
+			alarm->scheduled = 0u;
+			ret				 = 0;
+
+			/* Reprogram the channel if the earliest alarm was removed */
+			timer_mux_update(mux);
+			break;
+		}
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+#endif /* CONFIG_DRIVERS_TIMER_MUX */
+
+#if CONFIG_DRIVERS_TIMER_CAPTURE || CONFIG_DRIVERS_TIMER_PWM || CONFIG_DRIVERS_TIMER_MUX
+
+/* Interrupts of the 16 bits timers drivers, a timer is used by one of them at
+ * most (see defines.h). The overflow interrupt is used by all of them, the
+ * capture and compare match A interrupts only by the input capture and the
+ * multiplexer drivers, the other vectors are left to other clients. */
+
+__always_inline static void timer16_ovf_handler(uint8_t tim_idx)
+{
+#if CONFIG_DRIVERS_TIMER_CAPTURE
+	if (TIMER_CAPTURE_ENABLED(tim_idx)) {
+		tim_capture[tim_idx]->_ovf++;
+	}
+#endif
+#if CONFIG_DRIVERS_TIMER_PWM
+	if (TIMER_PWM_ENABLED(tim_idx)) {
+		timer_pwm_handler(timer_get_device(tim_idx), tim_idx);
+	}
+#endif
+#if CONFIG_DRIVERS_TIMER_MUX
+	if (TIMER_MUX_ENABLED(tim_idx)) {
+		tim_mux[tim_idx]->_ovf++;
+	}
+#endif
+}
+
+#define __DECL_TIMER16_OVF_ISR(n)                                                        \
+	ISR(TIMER##n##_OVF_vect)                                                             \
+	{                                                                                    \
+		timer16_ovf_handler(n);                                                          \
+	}
+
+#define __DECL_TIMER16_CAPT_ISR(n)                                                       \
+	ISR(TIMER##n##_CAPT_vect)                                                            \
+	{                                                                                    \
+		timer_capture_handler(timer_get_device(n), n);                                   \
+	}
+
+#define __DECL_TIMER16_COMPA_ISR(n)                                                      \
+	ISR(TIMER##n##_COMPA_vect)                                                           \
+	{                                                                                    \
+		const uint8_t ready_count = k_ready_count();                                     \
+		timer_mux_update(tim_mux[n]);                                                    \
+		if (k_ready_count() != ready_count) {                                            \
+			k_yield_from_isr();                                                          \
+		}                                                                                \
+	}
+
+#if TIMER16_DRIVER_ENABLED(1) && TIMER_INDEX_EXISTS(1)
+__DECL_TIMER16_OVF_ISR(1);
+#if TIMER_CAPTURE_ENABLED(1)
+__DECL_TIMER16_CAPT_ISR(1);
+#elif TIMER_MUX_ENABLED(1)
+__DECL_TIMER16_COMPA_ISR(1);
+#endif
+#endif
+
+#if TIMER16_DRIVER_ENABLED(3) && TIMER_INDEX_EXISTS(3)
+__DECL_TIMER16_OVF_ISR(3);
+#if TIMER_CAPTURE_ENABLED(3)
+__DECL_TIMER16_CAPT_ISR(3);
+#elif TIMER_MUX_ENABLED(3)
+__DECL_TIMER16_COMPA_ISR(3);
+#endif
+#endif
+
+#if TIMER16_DRIVER_ENABLED(4) && TIMER_INDEX_EXISTS(4)
+__DECL_TIMER16_OVF_ISR(4);
+#if TIMER_CAPTURE_ENABLED(4)
+__DECL_TIMER16_CAPT_ISR(4);
+#elif TIMER_MUX_ENABLED(4)
+__DECL_TIMER16_COMPA_ISR(4);
+#endif
+#endif
+
+#if TIMER16_DRIVER_ENABLED(5) && TIMER_INDEX_EXISTS(5)
+__DECL_TIMER16_OVF_ISR(5);
+#if TIMER_CAPTURE_ENABLED(5)
+__DECL_TIMER16_CAPT_ISR(5);
+#elif TIMER_MUX_ENABLED(5)
+__DECL_TIMER16_COMPA_ISR(5);
+#endif
+#endif
+
+#endif /* CONFIG_DRIVERS_TIMER_CAPTURE || CONFIG_DRIVERS_TIMER_PWM || ... */
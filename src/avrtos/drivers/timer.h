@@ -9,6 +9,7 @@
 
 #include <avrtos/drivers.h>
 #include <avrtos/kernel.h>
+#include <avrtos/semaphore.h>
 
 #include "timer_defs.h"
 
@@ -525,6 +526,53 @@ int8_t timer8_deinit(TIMER8_Device *dev);
 
 int8_t timer16_deinit(TIMER16_Device *dev);
 
+/* Resources registry */
+
+/* Output compare channels (OCRnx and compare match interrupts) */
+#define TIMER_RES_CHANNEL_A BIT(TIMER_CHANNEL_A)
+#define TIMER_RES_CHANNEL_B BIT(TIMER_CHANNEL_B)
+#define TIMER_RES_CHANNEL_C BIT(TIMER_CHANNEL_C)
+/* Input capture (ICRn and input capture interrupt), 16 bits timers only */
+#define TIMER_RES_CAPTURE BIT(3u)
+/* Counter: mode, prescaler, TCNTn and overflow interrupt */
+#define TIMER_RES_COUNTER BIT(4u)
+
+/**
+ * @brief Allocate resources of a timer.
+ *
+ * The drivers of this module allocate the resources they use (high level API,
+ * input capture, PWM, multiplexer) and fail with -EBUSY when another client
+ * already owns one of them. The sysclock timer (counter and channel A) and the
+ * channel of the high-resolution timers are reserved by the kernel.
+ *
+ * A client which does not own the counter of a timer (e.g. on a timer shared
+ * with timer_mux_start()) must not change its mode nor its prescaler.
+ *
+ * Safety: This function is safe to call from an ISR context.
+ *
+ * @param tim_idx Index of the timer.
+ * @param res Resources (TIMER_RES_*).
+ * @return int8_t 0 on success, -EINVAL if a resource does not exist on the timer,
+ * -EBUSY if a resource is already allocated.
+ */
+int8_t timer_alloc(uint8_t tim_idx, uint8_t res);
+
+/**
+ * @brief Release resources allocated with timer_alloc().
+ *
+ * @param tim_idx Index of the timer.
+ * @param res Resources (TIMER_RES_*).
+ */
+void timer_free(uint8_t tim_idx, uint8_t res);
+
+/**
+ * @brief Get the resources of a timer currently allocated.
+ *
+ * @param tim_idx Index of the timer.
+ * @return uint8_t Resources (TIMER_RES_*).
+ */
+uint8_t timer_alloc_get(uint8_t tim_idx);
+
 #define TIMER_API_FLAG_AUTOSTART (1 << 0)
 
 typedef void (*timer_callback_t)(void *dev, uint8_t tim_idx, void *user_data);
@@ -536,6 +584,15 @@ int8_t timer_init(uint8_t tim_idx,
 				  void *user_data,
 				  uint8_t flags);
 
+/**
+ * @brief Stop a timer initialized with timer_init() and release its resources
+ * (counter and channel A), the timer can then be used by other drivers.
+ *
+ * @param tim_idx Index of the timer.
+ * @return int8_t 0 on success, -EINVAL if the timer is not initialized.
+ */
+int8_t timer_deinit(uint8_t tim_idx);
+
 void timer_start(uint8_t tim_idx);
 
 void timer_stop(uint8_t tim_idx);
@@ -544,6 +601,502 @@ uint8_t timer_get_prescaler(uint8_t tim_idx);
 
 uint32_t timer_get_max_period_us(uint8_t tim_idx);
 
+/* Input capture API */
+
+/* Edge of the ICPn pin which triggers a capture */
+#define TIMER_CAPTURE_EDGE_FALLING 0u
+#define TIMER_CAPTURE_EDGE_RISING  1u
+/* Capture both edges, required for the duty cycle */
+#define TIMER_CAPTURE_EDGE_BOTH 2u
+
+/**
+ * @brief Input capture context of a 16 bits timer (see timer_capture_start()).
+ *
+ * The timer runs freely in normal mode, each capture of ICRn is extended to
+ * 32 bits with the count of timer overflows and stored in the ring buffer.
+ * When the buffer is full, the oldest capture is overwritten.
+ *
+ * The capture input pin must be configured as input by the application:
+ * - ATmega328P: ICP1 (PB0)
+ * - ATmega2560: ICP1 (PD4), ICP3 (PE7), ICP4 (PL0), ICP5 (PL1)
+ */
+struct timer_capture {
+	/* Ring buffer of captured timestamps, in timer ticks */
+	uint32_t *buf;
+
+	/* Number of entries of the buffer */
+	uint8_t size;
+
+	/* Captured edges (TIMER_CAPTURE_EDGE_*) */
+	uint8_t edge : 2;
+
+	/* Enable the input capture noise canceler (4 samples filter) */
+	uint8_t noise_canceler : 1;
+
+	/* Timer prescaler (timer_prescaler_t), defines the resolution and the
+	 * range of the measures */
+	uint8_t prescaler : 3;
+
+	/* Edge of the oldest capture, in TIMER_CAPTURE_EDGE_BOTH mode (internal) */
+	uint8_t Z_PRIVATE(rising) : 1;
+
+	/* Index of the oldest capture and number of captures (internal) */
+	uint8_t Z_PRIVATE(r);
+	uint8_t Z_PRIVATE(count);
+
+	/* Number of captures the waiting thread expects, 0 if none (internal) */
+	uint8_t Z_PRIVATE(threshold);
+
+	/* Upper 16 bits of the timestamps (internal) */
+	uint16_t Z_PRIVATE(ovf);
+
+	/* Number of captures overwritten before being read */
+	uint16_t overruns;
+
+	struct k_sem Z_PRIVATE(sem);
+};
+
+/**
+ * @brief Start capturing the ICPn input of a 16 bits timer.
+ *
+ * The timer is reset and dedicated to the capture until timer_capture_stop()
+ * is called. The fields buf, size, edge, noise_canceler and prescaler of the
+ * context must be set.
+ *
+ * Requires the timer in CONFIG_DRIVERS_TIMER_CAPTURE.
+ *
+ * @param tim_idx Index of the 16 bits timer (1, 3, 4 or 5).
+ * @param cap Capture context, must remain valid until the capture is stopped.
+ * @return int8_t 0 on success, -EINVAL on invalid arguments, -EBUSY if the
+ * counter or the input capture of the timer is already allocated.
+ */
+int8_t timer_capture_start(uint8_t tim_idx, struct timer_capture *cap);
+
+/**
+ * @brief Stop capturing the ICPn input of a timer.
+ *
+ * A thread waiting for captures is not woken up.
+ *
+ * @param tim_idx Index of the timer.
+ * @return int8_t 0 on success, -EINVAL if the capture is not started.
+ */
+int8_t timer_capture_stop(uint8_t tim_idx);
+
+/**
+ * @brief Wait until at least n captures are available in the buffer.
+ *
+ * A single thread can wait on a capture context at a time.
+ *
+ * @param cap Capture context.
+ * @param n Number of captures to wait for (at most the size of the buffer).
+ * @param timeout Maximum time to wait.
+ * @return int8_t 0 on success, -ETIMEDOUT if the timeout expired, -EINVAL on
+ * invalid arguments.
+ */
+int8_t timer_capture_wait(struct timer_capture *cap, uint8_t n, k_timeout_t timeout);
+
+/**
+ * @brief Get the number of captures available in the buffer.
+ *
+ * @param cap Capture context.
+ * @return uint8_t Number of captures.
+ */
+uint8_t timer_capture_count(struct timer_capture *cap);
+
+/**
+ * @brief Read and remove the oldest captures from the buffer.
+ *
+ * @param cap Capture context.
+ * @param ts Buffer receiving the timestamps, in timer ticks.
+ * @param n Maximum number of timestamps to read.
+ * @return uint8_t Number of timestamps read.
+ */
+uint8_t timer_capture_read(struct timer_capture *cap, uint32_t *ts, uint8_t n);
+
+/**
+ * @brief Discard all captures of the buffer.
+ *
+ * @param cap Capture context.
+ */
+void timer_capture_flush(struct timer_capture *cap);
+
+/**
+ * @brief Get the period of the input signal from the latest captures.
+ *
+ * The captures are not removed from the buffer.
+ *
+ * @param cap Capture context.
+ * @param period Period in timer ticks.
+ * @return int8_t 0 on success, -EAGAIN if not enough captures are available.
+ */
+int8_t timer_capture_period(struct timer_capture *cap, uint32_t *period);
+
+/**
+ * @brief Get the frequency of the input signal from the latest captures.
+ *
+ * @param cap Capture context.
+ * @param freq_mhz Frequency in millihertz.
+ * @return int8_t 0 on success, -EAGAIN if not enough captures are available.
+ */
+int8_t timer_capture_frequency(struct timer_capture *cap, uint32_t *freq_mhz);
+
+/**
+ * @brief Get the duty cycle of the input signal from the latest captures.
+ *
+ * Requires TIMER_CAPTURE_EDGE_BOTH.
+ *
+ * @param cap Capture context.
+ * @param permille Ratio of the high level time over the period, in per mille.
+ * @return int8_t 0 on success, -EAGAIN if not enough captures are available,
+ * -ENOTSUP if both edges are not captured.
+ */
+int8_t timer_capture_duty_cycle(struct timer_capture *cap, uint16_t *permille);
+
+/* PWM API */
+
+/**
+ * @brief PWM configuration of a 16 bits timer (see timer_pwm_start()).
+ */
+struct timer_pwm_config {
+	/* PWM mode: fast PWM, phase correct or phase and frequency correct */
+	timer_mode_t mode;
+
+	/* Timer prescaler (timer_prescaler_t) */
+	uint8_t prescaler;
+
+	/* TOP value, for the modes using ICRn as TOP (ignored otherwise) */
+	uint16_t top;
+
+	/* Compare output mode of each channel, TIMER_CHANNEL_COMP_MODE_NORMAL
+	 * leaves the OCnx pin disconnected */
+	timer_channel_com_t com[TIMER_CHANNELS_COUNT];
+
+	/* Initial compare values */
+	uint16_t duty[TIMER_CHANNELS_COUNT];
+};
+
+/**
+ * @brief Waveform replayed by the overflow interrupt (see
+ * timer_pwm_waveform_start()).
+ */
+struct timer_pwm_waveform {
+	/* Compare values, one per channel of the mask for each step, e.g.
+	 * {A0, B0, A1, B1, ...} for BIT(TIMER_CHANNEL_A) | BIT(TIMER_CHANNEL_B) */
+	const uint16_t *table;
+
+	/* Number of steps of the table */
+	uint16_t steps;
+
+	/* Channels driven by the table (BIT(TIMER_CHANNEL_x)) */
+	uint8_t channels;
+
+	/* Number of PWM periods per step (at least 1) */
+	uint8_t periods;
+
+	/* Replay the table endlessly */
+	uint8_t loop : 1;
+};
+
+/**
+ * @brief PWM context of a 16 bits timer (see timer_pwm_start()).
+ *
+ * In PWM modes, the OCRnx registers are double buffered and updated at TOP or
+ * BOTTOM. Duty cycles staged with timer_pwm_stage() are written to OCRnx by the
+ * overflow interrupt following timer_pwm_commit(), so that all the channels of
+ * a timer change at the same PWM period. The PWM period must be longer than
+ * the interrupt latency.
+ *
+ * In fast PWM modes, the overflow flag is set at TOP while the OCRnx buffers
+ * are latched one timer clock later at BOTTOM: the interrupt waits for the
+ * counter to leave TOP before writing OCRnx, which takes up to one timer clock
+ * (the prescaler value in CPU cycles).
+ *
+ * The overflow interrupt is only enabled while a commit is pending or a
+ * waveform is playing.
+ *
+ * The output pins must be configured as output by the application:
+ * - ATmega328P: OC1A (PB1), OC1B (PB2)
+ * - ATmega2560: OC1A-C (PB5-7), OC3A-C (PE3-5), OC4A-C (PH3-5), OC5A-C (PL3-5)
+ */
+struct timer_pwm {
+	/* Compare values staged and their channels (internal) */
+	uint16_t Z_PRIVATE(staged)[TIMER_CHANNELS_COUNT];
+	uint8_t Z_PRIVATE(staged_mask);
+
+	/* Compare values committed, written by the next overflow (internal) */
+	uint16_t Z_PRIVATE(next)[TIMER_CHANNELS_COUNT];
+	uint8_t Z_PRIVATE(next_mask);
+
+	/* Waveform playing, next entry, steps and periods left (internal) */
+	const struct timer_pwm_waveform *Z_PRIVATE(wf);
+	const uint16_t *Z_PRIVATE(entry);
+	uint16_t Z_PRIVATE(steps);
+	uint8_t Z_PRIVATE(periods);
+
+	/* Resources allocated (internal) */
+	uint8_t Z_PRIVATE(res);
+
+	/* Fast PWM mode, OCRnx latched one timer clock after the overflow (internal) */
+	uint8_t Z_PRIVATE(fast) : 1;
+
+	struct k_sem Z_PRIVATE(sem);
+};
+
+/**
+ * @brief Configure a 16 bits timer in PWM mode and start it.
+ *
+ * The counter of the timer, its connected channels and the register holding
+ * TOP (OCRnA or ICRn, depending on the mode) are allocated until
+ * timer_pwm_stop() is called. The other channels remain available to other
+ * clients with timer_alloc().
+ *
+ * Requires the timer in CONFIG_DRIVERS_TIMER_PWM.
+ *
+ * @param tim_idx Index of the 16 bits timer (1, 3, 4 or 5).
+ * @param pwm PWM context, must remain valid until the PWM is stopped.
+ * @param config PWM configuration.
+ * @return int8_t 0 on success, -EINVAL on invalid arguments, -EBUSY if a
+ * resource used by the configuration is already allocated.
+ */
+int8_t timer_pwm_start(uint8_t tim_idx,
+					   struct timer_pwm *pwm,
+					   const struct timer_pwm_config *config);
+
+/**
+ * @brief Stop a timer in PWM mode and disconnect its outputs.
+ *
+ * A thread waiting for the end of a waveform is not woken up.
+ *
+ * @param tim_idx Index of the timer.
+ * @return int8_t 0 on success, -EINVAL if the PWM is not started.
+ */
+int8_t timer_pwm_stop(uint8_t tim_idx);
+
+/**
+ * @brief Stage the compare value of a channel, applied by the next commit.
+ *
+ * @param tim_idx Index of the timer.
+ * @param channel Channel, connected or used as TOP by the PWM configuration.
+ * @param value Compare value (OCRnx).
+ * @return int8_t 0 on success, -EINVAL if the PWM is not started or the
+ * channel is not used by the PWM.
+ */
+int8_t timer_pwm_stage(uint8_t tim_idx, timer_channel_t channel, uint16_t value);
+
+/**
+ * @brief Apply the values staged on one or more timers at once.
+ *
+ * Each timer writes its values from its next overflow interrupt, the channels
+ * of a timer always change at the same period. Timers sharing the same TOP and
+ * prescaler, synchronized with timer_pwm_sync(), change at the same period as
+ * well. A pending commit is replaced by a new one, channels driven by a
+ * waveform are overridden by the waveform.
+ *
+ * Safety: This function is safe to call from an ISR context.
+ *
+ * @param timers Mask of timers (BIT(tim_idx)).
+ * @return int8_t 0 on success, -EINVAL if a PWM is not started.
+ */
+int8_t timer_pwm_commit(uint8_t timers);
+
+/**
+ * @brief Restart the counters of several timers in phase.
+ *
+ * The prescaler shared by the synchronous timers is halted and reset while the
+ * counters are reset (GTCCR.TSM, GTCCR.PSRSYNC). All the other timers clocked by
+ * this prescaler (all but timer 2) lose up to one prescaler period per call:
+ * - the sysclock timer, unless CONFIG_KERNEL_SYSLOCK_HW_TIMER is 2, each call
+ *   then adds jitter to the kernel ticks and the high-resolution timers,
+ * - the timers used by the multiplexer and input capture APIs.
+ * Select timer 2 for the sysclock if the PWM timers are synchronized often.
+ *
+ * @param timers Mask of timers (BIT(tim_idx)).
+ * @return int8_t 0 on success, -EINVAL if a PWM is not started.
+ */
+int8_t timer_pwm_sync(uint8_t timers);
+
+/**
+ * @brief Replay a waveform table from the overflow interrupt.
+ *
+ * The first step is applied at the next overflow, a waveform playing is
+ * replaced.
+ *
+ * @param tim_idx Index of the timer.
+ * @param wf Waveform, must remain valid until completed or stopped. Its
+ * channels must be used by the PWM configuration.
+ * @return int8_t 0 on success, -EINVAL on invalid arguments.
+ */
+int8_t timer_pwm_waveform_start(uint8_t tim_idx, const struct timer_pwm_waveform *wf);
+
+/**
+ * @brief Stop the waveform playing, the outputs keep the last step applied.
+ *
+ * A thread waiting with timer_pwm_waveform_wait() is woken up.
+ *
+ * @param tim_idx Index of the timer.
+ * @return int8_t 0 on success, -EINVAL if the PWM is not started.
+ */
+int8_t timer_pwm_waveform_stop(uint8_t tim_idx);
+
+/**
+ * @brief Wait for the end of the waveform playing (not looping).
+ *
+ * A single thread can wait on a timer at a time.
+ *
+ * @param tim_idx Index of the timer.
+ * @param timeout Maximum time to wait.
+ * @return int8_t 0 when the waveform is complete or stopped, -ETIMEDOUT if the
+ * timeout expired, -EINVAL if the PWM is not started.
+ */
+int8_t timer_pwm_waveform_wait(uint8_t tim_idx, k_timeout_t timeout);
+
+/* Multiplexer API */
+
+/* Convert a duration in microseconds to counts of a timer clocked with the
+ * given prescaler value (e.g. 8 for TIMER_PRESCALER_8) */
+#define TIMER_US_TO_COUNTS(us, prescaler)                                               \
+	((uint32_t)(((uint64_t)(us) * (F_CPU / 1000000lu)) / (prescaler)))
+
+struct timer_alarm;
+
+/**
+ * @brief Alarm handler, called from the compare match interrupt with interrupts
+ * disabled. The alarm can be restarted from the handler.
+ */
+typedef void (*timer_alarm_handler_t)(struct timer_alarm *alarm);
+
+/**
+ * @brief Software alarm scheduled on a multiplexed timer (see
+ * timer_alarm_start()).
+ */
+struct timer_alarm {
+	/* Next alarm of the multiplexer (internal) */
+	struct timer_alarm *Z_PRIVATE(next);
+
+	/* Absolute expiration time, in timer counts */
+	uint32_t deadline;
+
+	timer_alarm_handler_t handler;
+
+	/* Alarm is scheduled */
+	uint8_t scheduled : 1;
+};
+
+/**
+ * @brief Statically initialize an alarm.
+ */
+#define TIMER_ALARM_INIT(_handler)                                                       \
+	{                                                                                    \
+		._next = NULL, .deadline = 0u, .handler = _handler, .scheduled = 0u,             \
+	}
+
+/**
+ * @brief Multiplexer of a free running 16 bits timer (see timer_mux_start()).
+ *
+ * The timer counts continuously from 0x0000 to 0xFFFF, the counter is extended
+ * to 32 bits with the count of overflows. Any number of alarms share the
+ * compare channel A, which is programmed with the earliest deadline. Channels
+ * B and C remain available to other clients with timer_alloc(), which can use
+ * timer_mux_now() as their time base.
+ *
+ * The channel matches once per counter period: an alarm expiring N periods
+ * later causes N short interrupts before it expires.
+ */
+struct timer_mux {
+	/* Sorted list of the alarms, earliest deadline first (internal) */
+	struct timer_alarm *Z_PRIVATE(alarms);
+
+	/* Upper 16 bits of the counter (internal) */
+	uint16_t Z_PRIVATE(ovf);
+
+	uint8_t Z_PRIVATE(tim_idx);
+
+	/* Set while the expired alarms are processed (internal) */
+	uint8_t Z_PRIVATE(processing);
+};
+
+/**
+ * @brief Start a 16 bits timer as a free running multiplexed time base.
+ *
+ * The counter and the channel A of the timer are allocated until
+ * timer_mux_stop() is called.
+ *
+ * Requires the timer in CONFIG_DRIVERS_TIMER_MUX.
+ *
+ * @param tim_idx Index of the 16 bits timer (1, 3, 4 or 5).
+ * @param mux Multiplexer context, must remain valid until stopped.
+ * @param prescaler Timer prescaler (timer_prescaler_t).
+ * @return int8_t 0 on success, -EINVAL on invalid arguments, -EBUSY if the
+ * resources of the timer are already allocated.
+ */
+int8_t timer_mux_start(uint8_t tim_idx, struct timer_mux *mux, uint8_t prescaler);
+
+/**
+ * @brief Stop a multiplexer, the pending alarms are discarded.
+ *
+ * @param mux Multiplexer.
+ * @return int8_t 0 on success, -EINVAL if the multiplexer is not started.
+ */
+int8_t timer_mux_stop(struct timer_mux *mux);
+
+/**
+ * @brief Get the current time of a multiplexer.
+ *
+ * Safety: This function is safe to call from an ISR context.
+ *
+ * @param mux Multiplexer.
+ * @return uint32_t Time in timer counts.
+ */
+uint32_t timer_mux_now(struct timer_mux *mux);
+
+/**
+ * @brief Initialize an alarm.
+ *
+ * @param alarm Alarm.
+ * @param handler Function called when the alarm expires.
+ * @return int8_t 0 on success, -EINVAL on invalid arguments.
+ */
+int8_t timer_alarm_init(struct timer_alarm *alarm, timer_alarm_handler_t handler);
+
+/**
+ * @brief Start an alarm expiring in the given number of timer counts.
+ *
+ * If counts is 0, the handler is called before this function returns.
+ *
+ * Safety: This function is safe to call from an ISR context.
+ *
+ * @param mux Multiplexer.
+ * @param alarm Alarm.
+ * @param counts Delay in timer counts (less than 2^31).
+ * @return int8_t 0 on success, -EINVAL on invalid arguments, -EAGAIN if the
+ * alarm is already scheduled.
+ */
+int8_t timer_alarm_start(struct timer_mux *mux, struct timer_alarm *alarm, uint32_t counts);
+
+/**
+ * @brief Restart an expired alarm, the given number of timer counts after its
+ * previous deadline.
+ *
+ * Intended to be called from the handler for periodic alarms without drift.
+ *
+ * @param mux Multiplexer.
+ * @param alarm Alarm.
+ * @param counts Period in timer counts (less than 2^31).
+ * @return int8_t 0 on success, -EINVAL on invalid arguments, -EAGAIN if the
+ * alarm is already scheduled.
+ */
+int8_t timer_alarm_forward(struct timer_mux *mux, struct timer_alarm *alarm, uint32_t counts);
+
+/**
+ * @brief Cancel a scheduled alarm.
+ *
+ * @param mux Multiplexer.
+ * @param alarm Alarm.
+ * @return int8_t 0 on success, -EINVAL on invalid arguments, -EAGAIN if the
+ * alarm is not scheduled.
+ */
+int8_t timer_alarm_cancel(struct timer_mux *mux, struct timer_alarm *alarm);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -55,6 +55,15 @@
 #define OCIEnC OCIE1C
 #define ICIEn  ICIE1
 
+/* Interrupt flag register */
+// 8 & 16 bits timers
+#define TOVn  TOV1
+#define OCFnA OCF1A
+#define OCFnB OCF1B
+// 16 bits timers
+#define OCFnC OCF1C
+#define ICFn  ICF1
+
 #define FOCnC FOC1C
 
 #define ICNCn ICNC1
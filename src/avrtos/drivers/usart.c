@@ -6,14 +6,23 @@
 
 #include "usart.h"
 #include <stdbool.h>
+#include <string.h>
 
 #include <avr/io.h>
 #include <avr/pgmspace.h>
 
+#include <avrtos/pm.h>
+
 #define DRIVERS_UART_ASYNC                                                               \
 	((CONFIG_DRIVERS_USART0_ASYNC) || (CONFIG_DRIVERS_USART1_ASYNC) ||                   \
 	 (CONFIG_DRIVERS_USART2_ASYNC) || (CONFIG_DRIVERS_USART3_ASYNC))
 
+#define DRIVERS_UART_BUFFERED_MASK                                                       \
+	(((CONFIG_DRIVERS_USART0_BUFFERED) ? BIT(0) : 0u) |                                  \
+	 ((CONFIG_DRIVERS_USART1_BUFFERED) ? BIT(1) : 0u) |                                  \
+	 ((CONFIG_DRIVERS_USART2_BUFFERED) ? BIT(2) : 0u) |                                  \
+	 ((CONFIG_DRIVERS_USART3_BUFFERED) ? BIT(3) : 0u))
+
 /* same for all USARTs */
 #define TXENn TXEN0
 #define RXENn RXEN0
@@ -71,6 +80,27 @@ static void set_baudrate(UART_Device *dev, uint32_t baudrate, bool speed_mode)
 	dev->UBRRnL = (uint8_t)ubrr;
 }
 
+/* The receiver requires clk_IO to detect a start bit, a reference is held as
+ * long as RXENn is set */
+static void update_ucsrnb(UART_Device *dev, uint8_t clear, uint8_t set)
+{
+	const uint8_t key	 = irq_lock();
+	const uint8_t prev	 = dev->UCSRnB;
+	const uint8_t ucsrnb = (prev & ~clear) | set;
+
+#if CONFIG_KERNEL_PM
+	if (!(prev & BIT(RXENn)) && (ucsrnb & BIT(RXENn))) {
+		k_pm_require(K_PM_CAP_CLK_IO);
+	} else if ((prev & BIT(RXENn)) && !(ucsrnb & BIT(RXENn))) {
+		k_pm_release(K_PM_CAP_CLK_IO);
+	}
+#endif /* CONFIG_KERNEL_PM */
+
+	dev->UCSRnB = ucsrnb;
+
+	irq_unlock(key);
+}
+
 void ll_usart_init(UART_Device *dev, const struct usart_config *config)
 {
 	/* set baudrate */
@@ -87,7 +117,7 @@ void ll_usart_init(UART_Device *dev, const struct usart_config *config)
 	SET_BIT(ucsrnb, BIT(TXCIEn));
 #endif
 
-	dev->UCSRnB = ucsrnb;
+	update_ucsrnb(dev, 0xFFu, ucsrnb);
 
 	uint8_t ucsrc = 0u;
 	/* set USART mode asynchrone */
@@ -134,7 +164,7 @@ int8_t usart_deinit(UART_Device *dev)
 	}
 
 	dev->UCSRnA = 0U;
-	dev->UCSRnB = 0U;
+	update_ucsrnb(dev, 0xFFu, 0U);
 	dev->UCSRnC = 0U;
 
 	return 0;
@@ -159,6 +189,47 @@ uint8_t ll_usart_sync_getc(UART_Device *dev)
 	return dev->UDRn;
 }
 
+void ll_usart_tx_start(UART_Device *dev)
+{
+#if CONFIG_KERNEL_PM
+	const uint8_t key	 = irq_lock();
+	const uint8_t ucsrnb = dev->UCSRnB;
+
+	/* Otherwise the reference is already held */
+	if (!(ucsrnb & (BIT(UDRIEn) | BIT(TXCIEn)))) {
+		k_pm_require(K_PM_CAP_CLK_IO);
+	}
+
+	/* Clear a TX complete flag left by a previous transmission */
+	dev->UCSRnA = (dev->UCSRnA & (BIT(U2Xn) | BIT(MPCMn))) | BIT(TXCn);
+	dev->UCSRnB = (ucsrnb & ~BIT(TXCIEn)) | BIT(UDRIEn);
+
+	irq_unlock(key);
+#else
+	ll_usart_enable_udre_isr(dev);
+#endif /* CONFIG_KERNEL_PM */
+}
+
+void ll_usart_tx_drained(UART_Device *dev)
+{
+#if CONFIG_KERNEL_PM
+	/* The last bytes are still in the data and shift registers */
+	dev->UCSRnB = (dev->UCSRnB & ~BIT(UDRIEn)) | BIT(TXCIEn);
+#else
+	ll_usart_disable_udre_isr(dev);
+#endif /* CONFIG_KERNEL_PM */
+}
+
+void ll_usart_tx_complete(UART_Device *dev)
+{
+#if CONFIG_KERNEL_PM
+	ll_usart_disable_tx_isr(dev);
+	k_pm_release(K_PM_CAP_CLK_IO);
+#else
+	ARG_UNUSED(dev);
+#endif /* CONFIG_KERNEL_PM */
+}
+
 int8_t usart_send(UART_Device *dev, const char *buf, size_t len)
 {
 	Z_ARGS_CHECK(dev && (buf || !len)) return -EINVAL;
@@ -181,6 +252,45 @@ usart_get_async_context(UART_Device *dev)
 	return &usart_async_contexts[AVR_USARTn_INDEX(dev)];
 }
 
+static void rx_notify(UART_Device *dev, struct usart_async_context *ctx, usart_event_t evt)
+{
+	__ASSERT_FALSE(ctx->callback == NULL);
+
+	ctx->evt = evt;
+	ctx->callback(dev, ctx);
+
+	/* Keep receiving in the other buffer while the frame is processed */
+	if (ctx->rx.alt != NULL) {
+		uint8_t *const buf = ctx->rx.buf;
+		ctx->rx.buf		   = ctx->rx.alt;
+		ctx->rx.alt		   = buf;
+	}
+	ctx->rx.cur = 0U;
+}
+
+#if CONFIG_DRIVERS_USART_ASYNC_RX_IDLE
+static void rx_idle_handler(struct k_event *ev)
+{
+	struct usart_async_context *const ctx =
+		CONTAINER_OF(ev, struct usart_async_context, rx.idle_ev);
+
+	if ((ctx->rx.cur == 0U) || (ctx->rx.idle_ticks == 0U)) {
+		return;
+	}
+
+	/* Bytes received since the event was scheduled only updated last_tick,
+	 * reschedule for the remaining time.
+	 */
+	const k_ticks_t elapsed = (k_ticks_t)k_ticks_get_32() - ctx->rx.last_tick;
+	if (elapsed <= ctx->rx.idle_ticks) {
+		k_event_schedule(ev, K_TICKS(ctx->rx.idle_ticks + 1u - elapsed));
+		return;
+	}
+
+	rx_notify(AVR_USARTn_BASE(ctx - usart_async_contexts), ctx, USART_EVENT_RX_IDLE);
+}
+#endif /* CONFIG_DRIVERS_USART_ASYNC_RX_IDLE */
+
 static void rx_interrupt(UART_Device *dev)
 {
 	const char chr					= dev->UDRn;
@@ -188,12 +298,18 @@ static void rx_interrupt(UART_Device *dev)
 
 	ctx->rx.buf[ctx->rx.cur++] = chr;
 	if (ctx->rx.cur == ctx->rx.size) {
-		__ASSERT_FALSE(ctx->callback == NULL);
+		rx_notify(dev, ctx, USART_EVENT_RX_COMPLETE);
+	} else if (ctx->rx.delimiter_enabled && (chr == ctx->rx.delimiter)) {
+		rx_notify(dev, ctx, USART_EVENT_RX_DELIMITER);
+	}
+#if CONFIG_DRIVERS_USART_ASYNC_RX_IDLE
+	else if (ctx->rx.idle_ticks != 0U) {
+		ctx->rx.last_tick = (k_ticks_t)k_ticks_get_32();
 
-		ctx->evt = USART_EVENT_RX_COMPLETE;
-		ctx->callback(dev, ctx);
-		ctx->rx.cur = 0U;
+		/* Scheduled once per frame, fails with -EAGAIN if already scheduled */
+		k_event_schedule(&ctx->rx.idle_ev, K_TICKS(ctx->rx.idle_ticks + 1u));
 	}
+#endif /* CONFIG_DRIVERS_USART_ASYNC_RX_IDLE */
 }
 
 static void tx_interrupt(UART_Device *dev)
@@ -203,6 +319,13 @@ static void tx_interrupt(UART_Device *dev)
 	if (ctx->tx.cur == ctx->tx.size) {
 		__ASSERT_FALSE(ctx->callback == NULL);
 
+#if CONFIG_KERNEL_PM
+		/* The last byte is shifted out */
+		if (ctx->tx.size != 0U) {
+			k_pm_release(K_PM_CAP_CLK_IO);
+		}
+#endif
+
 		ctx->evt = USART_EVENT_TX_COMPLETE;
 		ctx->callback(dev, ctx);
 		ctx->tx.size = 0U;
@@ -305,9 +428,10 @@ int8_t usart_rx_enable(UART_Device *dev, void *buf, size_t size)
 	usart_async_contexts[AVR_USARTn_INDEX(dev)].rx.buf	= (uint8_t *)buf;
 	usart_async_contexts[AVR_USARTn_INDEX(dev)].rx.size = size;
 	usart_async_contexts[AVR_USARTn_INDEX(dev)].rx.cur	= 0U;
+	usart_async_contexts[AVR_USARTn_INDEX(dev)].rx.alt	= NULL;
 
 	/* enable receiver */
-	SET_BIT(dev->UCSRnB, BIT(RXENn));
+	update_ucsrnb(dev, 0U, BIT(RXENn));
 
 	return 0;
 }
@@ -319,15 +443,77 @@ int8_t usart_rx_disable(UART_Device *dev)
 	}
 
 	/* disable receiver */
-	CLR_BIT(dev->UCSRnB, BIT(RXENn));
+	update_ucsrnb(dev, BIT(RXENn), 0U);
+
+#if CONFIG_DRIVERS_USART_ASYNC_RX_IDLE
+	k_event_cancel(&usart_get_async_context(dev)->rx.idle_ev);
+#endif
 
 	return 0;
 }
 
+int8_t usart_rx_enable_double(UART_Device *dev, void *buf0, void *buf1, size_t size)
+{
+	Z_ARGS_CHECK(dev && buf0 && buf1 && size) return -EINVAL;
+
+	int8_t ret = usart_rx_enable(dev, buf0, size);
+	if (ret == 0) {
+		usart_get_async_context(dev)->rx.alt = (uint8_t *)buf1;
+	}
+
+	return ret;
+}
+
+int8_t usart_rx_set_delimiter(UART_Device *dev, bool enable, uint8_t delimiter)
+{
+	Z_ARGS_CHECK(dev) return -EINVAL;
+
+	struct usart_async_context *const ctx = usart_get_async_context(dev);
+
+	const uint8_t key		  = irq_lock();
+	ctx->rx.delimiter		  = delimiter;
+	ctx->rx.delimiter_enabled = enable;
+	irq_unlock(key);
+
+	return 0;
+}
+
+int8_t usart_rx_set_idle_timeout(UART_Device *dev, k_timeout_t timeout)
+{
+	Z_ARGS_CHECK(dev) return -EINVAL;
+
+#if CONFIG_DRIVERS_USART_ASYNC_RX_IDLE
+	struct usart_async_context *const ctx = usart_get_async_context(dev);
+
+	/* Excludes K_FOREVER, the event is scheduled with one more tick */
+	Z_ARGS_CHECK(K_TIMEOUT_TICKS(timeout) < (k_ticks_t)-2) return -EINVAL;
+
+	const uint8_t key = irq_lock();
+	k_event_cancel(&ctx->rx.idle_ev);
+	k_event_init(&ctx->rx.idle_ev, rx_idle_handler);
+	ctx->rx.idle_ticks = K_TIMEOUT_TICKS(timeout);
+	irq_unlock(key);
+
+	return 0;
+#else
+	ARG_UNUSED(timeout);
+
+	return -ENOTSUP;
+#endif
+}
+
 int8_t usart_tx(UART_Device *dev, const void *buf, size_t size)
 {
 	Z_ARGS_CHECK(dev) return -EINVAL;
 
+#if CONFIG_KERNEL_PM
+	/* Keep clk_IO running until the TX complete interrupt, unless a
+	 * transmission is already in progress */
+	if ((usart_async_contexts[AVR_USARTn_INDEX(dev)].tx.size == 0U) && (size != 0U)) {
+		k_pm_require(K_PM_CAP_CLK_IO);
+	}
+#endif
+
 	usart_async_contexts[AVR_USARTn_INDEX(dev)].tx.buf	= (const uint8_t *)buf;
 	usart_async_contexts[AVR_USARTn_INDEX(dev)].tx.size = size;
 	usart_async_contexts[AVR_USARTn_INDEX(dev)].tx.cur	= 0U;
@@ -338,4 +524,288 @@ int8_t usart_tx(UART_Device *dev, const void *buf, size_t size)
 	return 0;
 }
 
-#endif /* DRIVERS_UART_ASYNC */
\ No newline at end of file
+#endif /* DRIVERS_UART_ASYNC */
+#if DRIVERS_UART_BUFFERED_MASK
+
+/* Contexts are only allocated for the ports with buffering enabled */
+#if CONFIG_DRIVERS_USART0_BUFFERED
+static struct usart_buffered_context usart0_buffered_context;
+#endif
+#if CONFIG_DRIVERS_USART1_BUFFERED
+static struct usart_buffered_context usart1_buffered_context;
+#endif
+#if CONFIG_DRIVERS_USART2_BUFFERED
+static struct usart_buffered_context usart2_buffered_context;
+#endif
+#if CONFIG_DRIVERS_USART3_BUFFERED
+static struct usart_buffered_context usart3_buffered_context;
+#endif
+
+__always_inline static struct usart_buffered_context *
+usart_get_buffered_context(UART_Device *dev)
+{
+	switch (AVR_USARTn_INDEX(dev)) {
+#if CONFIG_DRIVERS_USART0_BUFFERED
+	case 0:
+		return &usart0_buffered_context;
+#endif
+#if CONFIG_DRIVERS_USART1_BUFFERED
+	case 1:
+		return &usart1_buffered_context;
+#endif
+#if CONFIG_DRIVERS_USART2_BUFFERED
+	case 2:
+		return &usart2_buffered_context;
+#endif
+#if CONFIG_DRIVERS_USART3_BUFFERED
+	case 3:
+		return &usart3_buffered_context;
+#endif
+	default:
+		return NULL;
+	}
+}
+
+static void buffered_rx_interrupt(UART_Device *dev)
+{
+	struct usart_buffered_context *const ctx = usart_get_buffered_context(dev);
+
+	/* Error flags must be read before UDRn */
+	const uint8_t status = dev->UCSRnA;
+	const char chr		 = dev->UDRn;
+
+	if (status & BIT(DORn)) {
+		ctx->stats.hw_overruns++;
+	}
+
+	if (status & (BIT(FEn) | BIT(UPEn))) {
+		ctx->stats.errors++;
+		return;
+	}
+
+	if (k_ring_push(&ctx->rx, chr) != 0) {
+		ctx->stats.rx_overruns++;
+		return;
+	}
+
+	struct k_thread *const thread = k_sem_give(&ctx->rx_sem);
+	k_yield_from_isr_cond(thread);
+}
+
+static void buffered_udre_interrupt(UART_Device *dev)
+{
+	struct usart_buffered_context *const ctx = usart_get_buffered_context(dev);
+	char chr;
+
+	if (k_ring_pop(&ctx->tx, &chr) == 0) {
+		dev->UDRn = chr;
+
+		struct k_thread *const thread = k_sem_give(&ctx->tx_sem);
+		k_yield_from_isr_cond(thread);
+	} else {
+		/* nothing more to send */
+		ll_usart_tx_drained(dev);
+	}
+}
+
+#if CONFIG_DRIVERS_USART0_BUFFERED
+ISR(USART0_RX_vect)
+{
+	buffered_rx_interrupt(USART0_DEVICE);
+}
+
+ISR(USART0_UDRE_vect)
+{
+	buffered_udre_interrupt(USART0_DEVICE);
+}
+
+#if CONFIG_KERNEL_PM
+ISR(USART0_TX_vect)
+{
+	ll_usart_tx_complete(USART0_DEVICE);
+}
+#endif
+#endif /* CONFIG_DRIVERS_USART0_BUFFERED */
+
+#if CONFIG_DRIVERS_USART1_BUFFERED
+ISR(USART1_RX_vect)
+{
+	buffered_rx_interrupt(USART1_DEVICE);
+}
+
+ISR(USART1_UDRE_vect)
+{
+	buffered_udre_interrupt(USART1_DEVICE);
+}
+
+#if CONFIG_KERNEL_PM
+ISR(USART1_TX_vect)
+{
+	ll_usart_tx_complete(USART1_DEVICE);
+}
+#endif
+#endif /* CONFIG_DRIVERS_USART1_BUFFERED */
+
+#if CONFIG_DRIVERS_USART2_BUFFERED
+ISR(USART2_RX_vect)
+{
+	buffered_rx_interrupt(USART2_DEVICE);
+}
+
+ISR(USART2_UDRE_vect)
+{
+	buffered_udre_interrupt(USART2_DEVICE);
+}
+
+#if CONFIG_KERNEL_PM
+ISR(USART2_TX_vect)
+{
+	ll_usart_tx_complete(USART2_DEVICE);
+}
+#endif
+#endif /* CONFIG_DRIVERS_USART2_BUFFERED */
+
+#if CONFIG_DRIVERS_USART3_BUFFERED
+ISR(USART3_RX_vect)
+{
+	buffered_rx_interrupt(USART3_DEVICE);
+}
+
+ISR(USART3_UDRE_vect)
+{
+	buffered_udre_interrupt(USART3_DEVICE);
+}
+
+#if CONFIG_KERNEL_PM
+ISR(USART3_TX_vect)
+{
+	ll_usart_tx_complete(USART3_DEVICE);
+}
+#endif
+#endif /* CONFIG_DRIVERS_USART3_BUFFERED */
+
+int8_t usart_buffered_init(UART_Device *dev,
+						   const struct usart_config *config,
+						   uint8_t *rx_buf,
+						   uint8_t rx_size,
+						   uint8_t *tx_buf,
+						   uint8_t tx_size)
+{
+	int8_t ret;
+
+	Z_ARGS_CHECK(dev && config) return -EINVAL;
+	Z_ARGS_CHECK(!config->receiver || (rx_buf && rx_size >= 2u)) return -EINVAL;
+	Z_ARGS_CHECK(!config->transmitter || (tx_buf && tx_size >= 2u)) return -EINVAL;
+
+	struct usart_buffered_context *const ctx = usart_get_buffered_context(dev);
+	if (ctx == NULL) {
+		return -ENOTSUP;
+	}
+
+	/* The ring of a disabled direction is left without buffer, which
+	 * usart_read() and usart_write() check */
+	memset(ctx, 0x00u, sizeof(*ctx));
+	if (config->receiver) k_ring_init(&ctx->rx, rx_buf, rx_size);
+	if (config->transmitter) k_ring_init(&ctx->tx, tx_buf, tx_size);
+	k_sem_init(&ctx->rx_sem, 0u, 1u);
+	k_sem_init(&ctx->tx_sem, 0u, 1u);
+
+	ret = usart_init(dev, config);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Only RX and UDRE interrupts are used in buffered mode */
+	uint8_t ucsrnb = dev->UCSRnB;
+	CLR_BIT(ucsrnb, BIT(TXCIEn) | BIT(UDRIEn));
+	if (config->receiver) SET_BIT(ucsrnb, BIT(RXCIEn));
+	dev->UCSRnB = ucsrnb;
+
+	return 0;
+}
+
+int usart_read(UART_Device *dev, void *buf, size_t len, k_timeout_t timeout)
+{
+	Z_ARGS_CHECK(dev && (buf || !len)) return -EINVAL;
+
+	struct usart_buffered_context *const ctx = usart_get_buffered_context(dev);
+	if (ctx == NULL) {
+		return -ENOTSUP;
+	} else if (ctx->rx.buffer == NULL) {
+		/* Not initialized with usart_buffered_init() or receiver disabled */
+		return -EINVAL;
+	}
+
+	char *const p = buf;
+	size_t n	  = 0u;
+
+	while (n < len) {
+		if (k_ring_pop(&ctx->rx, &p[n]) == 0) {
+			n++;
+		} else if (k_sem_take(&ctx->rx_sem, timeout) != 0) {
+			/* No byte received within the timeout */
+			break;
+		}
+	}
+
+	return n;
+}
+
+int usart_write(UART_Device *dev, const void *buf, size_t len, k_timeout_t timeout)
+{
+	Z_ARGS_CHECK(dev && (buf || !len)) return -EINVAL;
+
+	struct usart_buffered_context *const ctx = usart_get_buffered_context(dev);
+	if (ctx == NULL) {
+		return -ENOTSUP;
+	} else if (ctx->tx.buffer == NULL) {
+		/* Not initialized with usart_buffered_init() or transmitter disabled */
+		return -EINVAL;
+	}
+
+	const char *const p = buf;
+	size_t n			= 0u;
+
+	while (n < len) {
+		if (k_ring_push(&ctx->tx, p[n]) == 0) {
+			n++;
+			continue;
+		}
+
+		/* TX ring full, make sure the UDRE interrupt is draining it */
+		ll_usart_tx_start(dev);
+
+		if (k_sem_take(&ctx->tx_sem, timeout) != 0) {
+			break;
+		}
+	}
+
+	if (n != 0u) {
+		ll_usart_tx_start(dev);
+	}
+
+	return n;
+}
+
+int8_t usart_buffered_get_stats(UART_Device *dev,
+								struct usart_buffered_stats *stats,
+								bool reset)
+{
+	Z_ARGS_CHECK(dev && stats) return -EINVAL;
+
+	struct usart_buffered_context *const ctx = usart_get_buffered_context(dev);
+	if (ctx == NULL) {
+		return -ENOTSUP;
+	}
+
+	const uint8_t key = irq_lock();
+	*stats			  = ctx->stats;
+	if (reset) {
+		memset(&ctx->stats, 0x00u, sizeof(ctx->stats));
+	}
+	irq_unlock(key);
+
+	return 0;
+}
+
+#endif /* DRIVERS_UART_BUFFERED_MASK */
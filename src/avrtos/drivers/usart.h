@@ -10,7 +10,10 @@
 #include <stddef.h>
 
 #include <avrtos/drivers.h>
+#include <avrtos/event.h>
 #include <avrtos/kernel.h>
+#include <avrtos/ring.h>
+#include <avrtos/semaphore.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -207,6 +210,35 @@ __always_inline void ll_usart_disable_udre_isr(UART_Device *dev)
 	CLR_BIT(dev->UCSRnB, BIT(UDRIEn));
 }
 
+/**
+ * @brief Start sending a TX buffer from the UDRE interrupt.
+ *
+ * If CONFIG_KERNEL_PM is enabled, clk_IO is kept running until the last byte is
+ * shifted out (see ll_usart_tx_drained() and ll_usart_tx_complete()).
+ *
+ * @param dev USART device.
+ */
+void ll_usart_tx_start(UART_Device *dev);
+
+/**
+ * @brief Stop the UDRE interrupt once the TX buffer is empty, called from the
+ * UDRE interrupt handler.
+ *
+ * If CONFIG_KERNEL_PM is enabled, the TX complete interrupt is enabled and must
+ * call ll_usart_tx_complete().
+ *
+ * @param dev USART device.
+ */
+void ll_usart_tx_drained(UART_Device *dev);
+
+/**
+ * @brief Release clk_IO once the last byte is shifted out, called from the TX
+ * complete interrupt handler (CONFIG_KERNEL_PM only).
+ *
+ * @param dev USART device.
+ */
+void ll_usart_tx_complete(UART_Device *dev);
+
 __kernel int8_t usart_send(UART_Device *dev, const char *buf, size_t len);
 
 // ASYNC API
@@ -214,9 +246,13 @@ __kernel int8_t usart_send(UART_Device *dev, const char *buf, size_t len);
 struct usart_async_context;
 
 typedef enum {
-	USART_EVENT_RX_COMPLETE = 0,
-	USART_EVENT_TX_COMPLETE = 1,
-	USART_EVENT_ERROR		= 2,
+	USART_EVENT_RX_COMPLETE	 = 0,
+	USART_EVENT_TX_COMPLETE	 = 1,
+	USART_EVENT_ERROR		 = 2,
+	/* The delimiter byte has been received, it is the last byte of the buffer */
+	USART_EVENT_RX_DELIMITER = 3,
+	/* The line has been idle for the configured timeout after some bytes */
+	USART_EVENT_RX_IDLE		 = 4,
 } usart_event_t;
 
 typedef void (*usart_async_callback_t)(UART_Device *dev, struct usart_async_context *ctx);
@@ -227,9 +263,26 @@ struct usart_async_context {
 	usart_async_callback_t callback;
 
 	struct {
+		/* Buffer being filled, on RX events it contains the received frame
+		 * and cur is the number of bytes received.
+		 */
 		uint8_t *buf;
 		size_t size;
 		size_t cur;
+
+		/* Second buffer for double-buffered reception (or NULL), buffers are
+		 * swapped after each RX event.
+		 */
+		uint8_t *alt;
+
+		uint8_t delimiter;
+		uint8_t delimiter_enabled : 1;
+
+#if CONFIG_DRIVERS_USART_ASYNC_RX_IDLE
+		struct k_event idle_ev;
+		k_ticks_t idle_ticks; /* 0 if disabled */
+		k_ticks_t last_tick;
+#endif
 	} rx;
 
 	struct {
@@ -248,6 +301,146 @@ __kernel int8_t usart_rx_enable(UART_Device *dev, void *buf, size_t size);
 
 __kernel int8_t usart_tx(UART_Device *dev, const void *buf, size_t size);
 
+/**
+ * @brief Enable double-buffered reception.
+ *
+ * Reception goes on in buf1 while the callback (and the thread it notifies)
+ * processes the frame received in buf0, buffers are swapped after each RX
+ * event. The frame must be consumed before the other buffer raises an event.
+ *
+ * @param dev USART device
+ * @param buf0 First buffer
+ * @param buf1 Second buffer
+ * @param size Size of each buffer
+ * @return int8_t 0 on success, negative error code otherwise
+ */
+__kernel int8_t usart_rx_enable_double(UART_Device *dev, void *buf0, void *buf1, size_t size);
+
+/**
+ * @brief Raise an USART_EVENT_RX_DELIMITER event when the delimiter byte is received.
+ *
+ * @param dev USART device
+ * @param enable Enable or disable delimiter detection
+ * @param delimiter Delimiter byte (e.g. '\n')
+ * @return int8_t 0 on success, negative error code otherwise
+ */
+__kernel int8_t usart_rx_set_delimiter(UART_Device *dev, bool enable, uint8_t delimiter);
+
+/**
+ * @brief Raise an USART_EVENT_RX_IDLE event when no byte has been received during
+ * the timeout after the last received byte.
+ *
+ * The line is checked with a kernel event scheduled once per frame, the event
+ * is raised between timeout and timeout + 1 tick after the last byte.
+ *
+ * Requires CONFIG_DRIVERS_USART_ASYNC_RX_IDLE.
+ *
+ * @param dev USART device
+ * @param timeout Idle timeout, K_NO_WAIT disables idle detection
+ * @return int8_t 0 on success, negative error code otherwise
+ */
+__kernel int8_t usart_rx_set_idle_timeout(UART_Device *dev, k_timeout_t timeout);
+
+// BUFFERED API
+
+/**
+ * @brief USART buffered statistics
+ */
+struct usart_buffered_stats {
+	/* Bytes dropped because the RX ring buffer was full */
+	uint16_t rx_overruns;
+	/* Bytes lost in hardware (DORn), the RX interrupt was serviced too late */
+	uint16_t hw_overruns;
+	/* Frames received with a framing (FEn) or parity (UPEn) error */
+	uint16_t errors;
+};
+
+struct usart_buffered_context {
+	struct k_ring rx;
+	struct k_ring tx;
+
+	/* Signaled by the RX interrupt when a byte is received */
+	struct k_sem rx_sem;
+	/* Signaled by the UDRE interrupt when room is available in the TX ring */
+	struct k_sem tx_sem;
+
+	struct usart_buffered_stats stats;
+};
+
+/**
+ * @brief Initialize a USART in interrupt-driven buffered mode.
+ *
+ * Received bytes are stored in the RX ring buffer by the RX interrupt, bytes
+ * written with `usart_write()` are queued in the TX ring buffer and sent by the
+ * UDRE interrupt. Buffers are provided by the application, the usable capacity
+ * of each buffer is (size - 1) bytes.
+ *
+ * CONFIG_DRIVERS_USARTn_BUFFERED must be enabled for the given device.
+ *
+ * @param dev USART device
+ * @param config USART configuration
+ * @param rx_buf RX buffer (can be NULL if the receiver is disabled)
+ * @param rx_size RX buffer size
+ * @param tx_buf TX buffer (can be NULL if the transmitter is disabled)
+ * @param tx_size TX buffer size
+ * @return int8_t 0 on success, negative error code otherwise
+ */
+__kernel int8_t usart_buffered_init(UART_Device *dev,
+									const struct usart_config *config,
+									uint8_t *rx_buf,
+									uint8_t rx_size,
+									uint8_t *tx_buf,
+									uint8_t tx_size);
+
+/**
+ * @brief Read up to len bytes from a buffered USART.
+ *
+ * Returns as soon as len bytes have been read, or when no byte has been received
+ * within the timeout. The timeout applies to each wait for a new byte (inter-byte
+ * timeout), use K_NO_WAIT to only read the bytes already buffered.
+ *
+ * @param dev USART device
+ * @param buf Buffer to store the received bytes
+ * @param len Number of bytes to read
+ * @param timeout Maximum time to wait for each byte
+ * @return int Number of bytes read (can be less than len), -ENOTSUP if buffering is
+ * not enabled for the device, -EINVAL if the device has not been initialized with
+ * usart_buffered_init() with the receiver enabled
+ */
+__kernel int usart_read(UART_Device *dev, void *buf, size_t len, k_timeout_t timeout);
+
+/**
+ * @brief Write len bytes to a buffered USART.
+ *
+ * Bytes are queued in the TX ring buffer, the function blocks while the buffer
+ * is full. Returns when all bytes are queued, or when no room has been made in
+ * the buffer within the timeout.
+ *
+ * @param dev USART device
+ * @param buf Bytes to send
+ * @param len Number of bytes to send
+ * @param timeout Maximum time to wait for room in the TX buffer
+ * @return int Number of bytes queued (can be less than len), -ENOTSUP if buffering
+ * is not enabled for the device, -EINVAL if the device has not been initialized
+ * with usart_buffered_init() with the transmitter enabled
+ */
+__kernel int usart_write(UART_Device *dev,
+						 const void *buf,
+						 size_t len,
+						 k_timeout_t timeout);
+
+/**
+ * @brief Get and optionally reset the statistics of a buffered USART.
+ *
+ * @param dev USART device
+ * @param stats Structure to copy the statistics to
+ * @param reset Reset the counters after copying them
+ * @return int8_t 0 on success, negative error code otherwise
+ */
+__kernel int8_t usart_buffered_get_stats(UART_Device *dev,
+										 struct usart_buffered_stats *stats,
+										 bool reset);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,6 +9,7 @@
 #include <util/atomic.h>
 
 #include "assert.h"
+#include "workqueue.h"
 
 #define K_MODULE K_MODULE_EVENT
 
@@ -49,6 +50,71 @@ struct k_event_q {
  */
 K_EVENT_Q_DEFINE(z_event_q);
 
+#if CONFIG_KERNEL_EVENTS_DEFERRED
+static void z_event_work_handler(struct k_work *work);
+
+/* Expired events waiting for their handler to be called, in expiration order */
+static struct titem *z_event_pending	   = NULL;
+static struct titem **z_event_pending_tail = &z_event_pending;
+
+static K_WORK_DEFINE(z_event_work, z_event_work_handler);
+
+/**
+ * @brief Remove an event from the pending list.
+ *
+ * This function requires interrupts to be disabled.
+ *
+ * @param tie Queue item of the event to remove.
+ * @return true if the event was found and removed, false otherwise.
+ */
+static bool z_event_pending_remove(struct titem *tie)
+{
+	for (struct titem **prev = &z_event_pending; *prev != NULL; prev = &(*prev)->next) {
+		if (*prev == tie) {
+			*prev = tie->next;
+			if (z_event_pending_tail == &tie->next) {
+				z_event_pending_tail = prev;
+			}
+			tie->next = NULL;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void z_event_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	struct titem *tie;
+
+	do {
+		const uint8_t key = irq_lock();
+
+		tie = z_event_pending;
+		if (tie != NULL) {
+			struct k_event *event = CONTAINER_OF(tie, struct k_event, tie);
+
+			z_event_pending = tie->next;
+			if (z_event_pending == NULL) {
+				z_event_pending_tail = &z_event_pending;
+			}
+
+			/* Clear the scheduled flag to allow rescheduling from the handler */
+			event->scheduled = 0;
+
+			/* Handlers expect interrupts to be disabled, but are not
+			 * executed in a row, interrupts are served in between.
+			 */
+			event->handler(event);
+		}
+
+		irq_unlock(key);
+	} while (tie != NULL);
+}
+#endif /* CONFIG_KERNEL_EVENTS_DEFERRED */
+
 int8_t k_event_init(struct k_event *event, k_event_handler_t handler)
 {
 	Z_ARGS_CHECK(event && handler) return -EINVAL;
@@ -118,7 +184,13 @@ int8_t k_event_cancel(struct k_event *event)
 		goto exit;
 	}
 
-	tqueue_remove(&z_event_q.first, &event->tie);
+#if CONFIG_KERNEL_EVENTS_DEFERRED
+	/* The event may have expired but its handler not been called yet */
+	if (!z_event_pending_remove(&event->tie))
+#endif
+	{
+		tqueue_remove(&z_event_q.first, &event->tie);
+	}
 	event->scheduled = 0;
 
 exit:
@@ -126,6 +198,11 @@ exit:
 	return ret;
 }
 
+bool z_event_q_scheduled(void)
+{
+	return z_event_q.first != NULL;
+}
+
 bool k_event_pending(struct k_event *event)
 {
 	Z_ARGS_CHECK(event) return false;
@@ -135,13 +212,34 @@ bool k_event_pending(struct k_event *event)
 
 void z_event_q_process(void)
 {
-	struct titem *tie;
-
 	__ASSERT_NOINTERRUPT();
 
 	/* Shift the event queue forward by the configured time slice */
 	tqueue_shift(&z_event_q.first, Z_EVENTS_PERIOD_TICKS);
 
+#if CONFIG_KERNEL_EVENTS_DEFERRED
+	/* Find the end of the expired events, up to the configured limit */
+	struct titem **last = &z_event_q.first;
+	uint8_t count		= 0u;
+
+	while ((*last != NULL) && ((*last)->delay_shift == 0) &&
+		   (count < CONFIG_KERNEL_EVENTS_DEFERRED_MAX_PER_TICK)) {
+		last = &(*last)->next;
+		count++;
+	}
+
+	/* Move them to the pending list in one batch */
+	if (count != 0u) {
+		*z_event_pending_tail = z_event_q.first;
+		z_event_q.first		  = *last;
+		*last				  = NULL;
+		z_event_pending_tail  = last;
+
+		k_system_workqueue_submit(&z_event_work);
+	}
+#else
+	struct titem *tie;
+
 	/* Process all expired events in the queue */
 	while ((tie = tqueue_pop(&z_event_q.first)) != NULL) {
 		struct k_event *event = CONTAINER_OF(tie, struct k_event, tie);
@@ -152,6 +250,7 @@ void z_event_q_process(void)
 		/* Execute the event handler */
 		event->handler(event);
 	}
+#endif /* CONFIG_KERNEL_EVENTS_DEFERRED */
 }
 
 #endif /* CONFIG_KERNEL_EVENTS */
@@ -30,12 +30,18 @@
  * - Like software timers (timer.h), the main limitation is that the events are processed
  *   within the tick interrupt handler (kernel code), the code executed in the handler
  * must then be compliant with the constraints of the interrupt context.
+ * - With CONFIG_KERNEL_EVENTS_DEFERRED, the handlers are called from the system
+ *   workqueue thread instead, still with interrupts disabled. Their execution is
+ *   delayed by the work items queued before.
  *
  * Related configuration options:
  *  - CONFIG_KERNEL_EVENTS: Enables the event handling system.
  *  - CONFIG_KERNEL_TIME_SLICE_US: Defines the time slice used for event processing.
  *  - CONFIG_KERNEL_EVENTS_ALLOW_NO_WAIT: Allows events to be executed immediately without
  * delay.
+ *  - CONFIG_KERNEL_EVENTS_DEFERRED: Executes the handlers from the system workqueue.
+ *  - CONFIG_KERNEL_EVENTS_DEFERRED_MAX_PER_TICK: Maximum number of events moved to the
+ * pending list per tick.
  */
 
 #ifndef _AVRTOS_EVENT_H_
@@ -156,9 +162,19 @@ __kernel bool k_event_pending(struct k_event *event);
  * This internal function processes the event queue, executing the handlers for
  * any events whose timeouts have expired. It is called periodically with a frequency
  * defined by `CONFIG_KERNEL_TIME_SLICE_US`.
+ *
+ * If CONFIG_KERNEL_EVENTS_DEFERRED is enabled, the expired events are only moved to
+ * the pending list and the handlers are executed from the system workqueue.
  */
 __kernel void z_event_q_process(void);
 
+/**
+ * @brief Check whether an event is scheduled, i.e. the tick is required.
+ *
+ * @return true if an event is scheduled, false otherwise.
+ */
+__kernel bool z_event_q_scheduled(void);
+
 #ifdef __cplusplus
 }
 #endif
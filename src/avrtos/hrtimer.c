@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "hrtimer.h"
+
+#include <avr/interrupt.h>
+
+#include "assert.h"
+#include "kernel_private.h"
+#include "sysclock_private.h"
+#include "systime.h"
+
+#define K_MODULE K_MODULE_HRTIMER
+
+#if CONFIG_KERNEL_HRTIMER
+
+#define HRTIMER_DEV ((TIMER16_Device *)timer_get_device(CONFIG_KERNEL_SYSLOCK_HW_TIMER))
+
+#if CONFIG_KERNEL_HRTIMER_CHANNEL == 1
+#define HRTIMER_OCFn  OCFnB
+#define HRTIMER_OCIEn OCIEnB
+#else
+#define HRTIMER_OCFn  OCFnC
+#define HRTIMER_OCIEn OCIEnC
+#endif
+
+/* Sorted list of running timers, earliest deadline first */
+static struct k_hrtimer *z_hrtimers;
+
+/* Set while the expired timers are being processed, a timer (re)started from a
+ * handler is only inserted in the list, the compare channel is reprogrammed once
+ * all handlers have been called.
+ */
+static uint8_t z_hrtimers_processing;
+
+/**
+ * @brief Read the current high-resolution time.
+ *
+ * If the sysclock compare match is pending (i.e. the counter wrapped but the tick
+ * interrupt did not run yet), the tick counter is compensated.
+ *
+ * Assumptions:
+ * - The interrupt flag is cleared when this function is called.
+ *
+ * @param now Pointer to the time point to set.
+ */
+static void z_hrtime_now(struct z_hrtime *now)
+{
+	now->ticks = k_ticks_get_32();
+	now->cnt   = z_sysclock_get_counter();
+
+	if (z_sysclock_tick_pending()) {
+		now->ticks++;
+		now->cnt = z_sysclock_get_counter();
+	}
+}
+
+/**
+ * @brief Add a duration in microseconds to a time point.
+ *
+ * Durations shorter than a tick are converted without any 32-bit division.
+ *
+ * @param time Pointer to the time point to update.
+ * @param us Duration in microseconds.
+ */
+static void z_hrtime_add_us(struct z_hrtime *time, uint32_t us)
+{
+	if (us >= CONFIG_KERNEL_SYSCLOCK_PERIOD_US) {
+		time->ticks += us / CONFIG_KERNEL_SYSCLOCK_PERIOD_US;
+		us %= CONFIG_KERNEL_SYSCLOCK_PERIOD_US;
+	}
+
+	uint32_t cnt = (uint32_t)time->cnt + Z_SYSCLOCK_US_TO_COUNTS(us);
+	if (cnt >= Z_SYSCLOCK_COUNTS_PER_TICK) {
+		cnt -= Z_SYSCLOCK_COUNTS_PER_TICK;
+		time->ticks++;
+	}
+
+	time->cnt = (uint16_t)cnt;
+}
+
+/**
+ * @brief Check whether time point `a` is strictly before time point `b`.
+ *
+ * Tick counter wrap-around is handled as long as both time points are less than
+ * 2^31 ticks apart.
+ */
+static bool z_hrtime_before(const struct z_hrtime *a, const struct z_hrtime *b)
+{
+	const int32_t diff = (int32_t)(a->ticks - b->ticks);
+
+	return (diff < 0) || ((diff == 0) && (a->cnt < b->cnt));
+}
+
+static void z_hrtimer_insert(struct k_hrtimer *timer)
+{
+	struct k_hrtimer **prev = &z_hrtimers;
+
+	/* Timers with the same deadline expire in the order they were started */
+	while ((*prev != NULL) && !z_hrtime_before(&timer->deadline, &(*prev)->deadline)) {
+		prev = &(*prev)->next;
+	}
+
+	timer->next		 = *prev;
+	timer->scheduled = 1u;
+	*prev			 = timer;
+}
+
+/**
+ * @brief Call the handlers of the expired timers and program the compare
+ * channel for the earliest remaining deadline.
+ *
+ * Assumptions:
+ * - The interrupt flag is cleared when this function is called.
+ */
+static void z_hrtimer_update(void)
+{
+	struct z_hrtime now;
+	struct k_hrtimer *timer;
+
+	__ASSERT_NOINTERRUPT();
+
+	if (z_hrtimers_processing) {
+		return;
+	}
+
+	z_hrtimers_processing = 1u;
+
+	for (;;) {
+		z_hrtime_now(&now);
+
+		/* Expire all timers whose deadline is reached */
+		while (((timer = z_hrtimers) != NULL) &&
+			   !z_hrtime_before(&now, &timer->deadline)) {
+			z_hrtimers		 = timer->next;
+			timer->scheduled = 0u;
+			timer->handler(timer);
+		}
+
+		if (timer == NULL) {
+			ll_timer16_disable_interrupt(CONFIG_KERNEL_SYSLOCK_HW_TIMER,
+										 HRTIMER_OCIEn);
+			break;
+		}
+
+		/* The compare channel matches once per tick, the interrupt is a no-op
+		 * until the tick of the deadline is reached.
+		 */
+		ll_timer16_write_reg16(&HRTIMER_DEV->OCRnx[CONFIG_KERNEL_HRTIMER_CHANNEL],
+							   timer->deadline.cnt);
+		TIFRn[CONFIG_KERNEL_SYSLOCK_HW_TIMER] = BIT(HRTIMER_OCFn);
+		ll_timer16_enable_interrupt(CONFIG_KERNEL_SYSLOCK_HW_TIMER, HRTIMER_OCIEn);
+
+		/* If the counter went past the deadline while programming the
+		 * channel, the match is missed: process the timer right away.
+		 */
+		z_hrtime_now(&now);
+		if (z_hrtime_before(&now, &timer->deadline)) {
+			break;
+		}
+	}
+
+	z_hrtimers_processing = 0u;
+}
+
+int8_t k_hrtimer_init(struct k_hrtimer *timer, k_hrtimer_handler_t handler)
+{
+	Z_ARGS_CHECK(timer && handler) return -EINVAL;
+
+	timer->next		 = NULL;
+	timer->handler	 = handler;
+	timer->scheduled = 0u;
+
+	return 0;
+}
+
+static int8_t z_hrtimer_schedule(struct k_hrtimer *timer, uint32_t us, bool forward)
+{
+	int8_t ret		   = 0;
+	const uint8_t lock = irq_lock();
+
+	if (timer->scheduled) {
+		ret = -EAGAIN;
+		goto exit;
+	}
+
+	if (!forward) {
+		z_hrtime_now(&timer->deadline);
+	}
+	z_hrtime_add_us(&timer->deadline, us);
+
+	z_hrtimer_insert(timer);
+	z_hrtimer_update();
+
+exit:
+	irq_unlock(lock);
+	return ret;
+}
+
+int8_t k_hrtimer_start(struct k_hrtimer *timer, uint32_t us)
+{
+	Z_ARGS_CHECK(timer && timer->handler) return -EINVAL;
+
+	return z_hrtimer_schedule(timer, us, false);
+}
+
+int8_t k_hrtimer_forward(struct k_hrtimer *timer, uint32_t us)
+{
+	Z_ARGS_CHECK(timer && timer->handler) return -EINVAL;
+
+	return z_hrtimer_schedule(timer, us, true);
+}
+
+int8_t k_hrtimer_cancel(struct k_hrtimer *timer)
+{
+	Z_ARGS_CHECK(timer) return -EINVAL;
+
+	int8_t ret		   = -EAGAIN;
+	const uint8_t lock = irq_lock();
+
+	for (struct k_hrtimer **prev = &z_hrtimers; *prev != NULL; prev = &(*prev)->next) {
+		if (*prev == timer) {
+			*prev			 = timer->next;
+			timer->scheduled = 0u;
+			ret				 = 0;
+
+			/* Reprogram the channel if the earliest timer was removed */
+			z_hrtimer_update();
+			break;
+		}
+	}
+
+	irq_unlock(lock);
+	return ret;
+}
+
+bool k_hrtimer_pending(struct k_hrtimer *timer)
+{
+	Z_ARGS_CHECK(timer) return false;
+
+	return timer->scheduled == 1u;
+}
+
+bool z_hrtimers_scheduled(void)
+{
+	return z_hrtimers != NULL;
+}
+
+struct z_hrtimer_sleep {
+	struct k_hrtimer timer;
+	struct k_thread *thread;
+};
+
+static void z_hrtimer_sleep_handler(struct k_hrtimer *timer)
+{
+	struct z_hrtimer_sleep *const sleep =
+		CONTAINER_OF(timer, struct z_hrtimer_sleep, timer);
+
+	/* The timer may expire before the thread is actually suspended */
+	if (z_get_thread_state(sleep->thread) == Z_THREAD_STATE_PENDING) {
+		z_wake_up(sleep->thread);
+	}
+}
+
+void k_hrtimer_sleep_us(uint32_t us)
+{
+	struct z_hrtimer_sleep sleep = {
+		.timer	= Z_HRTIMER_INIT(z_hrtimer_sleep_handler),
+		.thread = z_ker.current,
+	};
+
+	const uint8_t lock = irq_lock();
+
+	z_hrtimer_schedule(&sleep.timer, us, false);
+
+	if (sleep.timer.scheduled) {
+		z_pend_current(K_FOREVER);
+
+		/* The thread may have been resumed otherwise (k_wakeup(), k_stop(), ...),
+		 * the timer must not be left in the list with this stack frame */
+		if (sleep.timer.scheduled) {
+			k_hrtimer_cancel(&sleep.timer);
+		}
+	}
+
+	irq_unlock(lock);
+}
+
+#if CONFIG_KERNEL_SYSLOCK_HW_TIMER == 1
+#define HRTIMER_COMPB_vect TIMER1_COMPB_vect
+#define HRTIMER_COMPC_vect TIMER1_COMPC_vect
+#elif CONFIG_KERNEL_SYSLOCK_HW_TIMER == 3
+#define HRTIMER_COMPB_vect TIMER3_COMPB_vect
+#define HRTIMER_COMPC_vect TIMER3_COMPC_vect
+#elif CONFIG_KERNEL_SYSLOCK_HW_TIMER == 4
+#define HRTIMER_COMPB_vect TIMER4_COMPB_vect
+#define HRTIMER_COMPC_vect TIMER4_COMPC_vect
+#elif CONFIG_KERNEL_SYSLOCK_HW_TIMER == 5
+#define HRTIMER_COMPB_vect TIMER5_COMPB_vect
+#define HRTIMER_COMPC_vect TIMER5_COMPC_vect
+#endif
+
+#if CONFIG_KERNEL_HRTIMER_CHANNEL == 1
+ISR(HRTIMER_COMPB_vect)
+#else
+ISR(HRTIMER_COMPC_vect)
+#endif
+{
+	const uint8_t ready_count = z_ker.ready_count;
+
+	z_hrtimer_update();
+
+	/* Switch to the thread(s) woken up by the handlers */
+	if (z_ker.ready_count != ready_count) {
+		k_yield_from_isr();
+	}
+}
+
+#endif /* CONFIG_KERNEL_HRTIMER */
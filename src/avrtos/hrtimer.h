@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _AVRTOS_HRTIMER_H_
+#define _AVRTOS_HRTIMER_H_
+
+/*
+ * High-Resolution Timers (hrtimer.h)
+ *
+ * One-shot timers with a microsecond resolution, expiring independently of the
+ * sysclock tick.
+ *
+ * Key Concepts:
+ * - **Time base**: The deadline of a timer is expressed as a (ticks, counter) pair,
+ *   where the counter is the value of the sysclock hardware timer (TCNTn) within the
+ *   tick. The resolution is therefore one timer count (62.5ns at 16MHz with the
+ *   default 1ms sysclock).
+ * - **Expiration**: The earliest deadline is programmed on a spare output compare
+ *   channel of the sysclock timer (CONFIG_KERNEL_HRTIMER_CHANNEL), the handler is
+ *   called from the compare match interrupt.
+ * - **Drift-free periodic timers**: `k_hrtimer_forward()` schedules the next
+ *   expiration relative to the previous deadline, not to the current time.
+ *
+ * Limitations:
+ * - Handlers are executed in interrupt context with interrupts disabled and must be
+ *   kept short. A thread woken up from a handler is switched to at the end of the
+ *   interrupt.
+ * - The compare channel matches once per tick, so a timer expiring N ticks later
+ *   causes N short interrupts before it expires.
+ * - The TIMERn_COMPB_vect (or TIMERn_COMPC_vect) vector of the sysclock timer is
+ *   reserved by this module.
+ *
+ * Requires CONFIG_KERNEL_HRTIMER, CONFIG_KERNEL_UPTIME and a 16-bit sysclock timer.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "kernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct k_hrtimer;
+
+/**
+ * @brief High-resolution timer handler function prototype.
+ *
+ * Called from interrupt context when the timer expires, the timer can be
+ * restarted from the handler (e.g. with `k_hrtimer_forward()`).
+ *
+ * @param timer Pointer to the expired timer.
+ */
+typedef void (*k_hrtimer_handler_t)(struct k_hrtimer *timer);
+
+/**
+ * @brief High-resolution time point.
+ */
+struct z_hrtime {
+	uint32_t ticks; /**< Sysclock ticks */
+	uint16_t cnt;	/**< Sysclock timer counter within the tick */
+};
+
+/**
+ * @brief High-resolution timer structure.
+ */
+struct k_hrtimer {
+	struct k_hrtimer *next;		 /**< Next timer in the expiration list */
+	struct z_hrtime deadline;	 /**< Absolute expiration time */
+	k_hrtimer_handler_t handler; /**< Function to call when the timer expires */
+	uint8_t scheduled : 1;		 /**< Timer is in the expiration list */
+};
+
+/**
+ * @brief Statically initialize a high-resolution timer.
+ *
+ * @param _handler Function to call when the timer expires.
+ */
+#define Z_HRTIMER_INIT(_handler)                                                         \
+	{                                                                                    \
+		.next = NULL, .deadline = {0u, 0u}, .handler = _handler, .scheduled = 0u,        \
+	}
+
+/**
+ * @brief Define and initialize a high-resolution timer.
+ *
+ * @param _name Name of the timer variable.
+ * @param _handler Function to call when the timer expires.
+ */
+#define K_HRTIMER_DEFINE(_name, _handler)                                                \
+	struct k_hrtimer _name = Z_HRTIMER_INIT(_handler)
+
+/**
+ * @brief Initialize a high-resolution timer.
+ *
+ * @param timer Pointer to the timer.
+ * @param handler Function to call when the timer expires.
+ * @return 0 on success, -EINVAL on invalid arguments.
+ */
+__kernel int8_t k_hrtimer_init(struct k_hrtimer *timer, k_hrtimer_handler_t handler);
+
+/**
+ * @brief Start a high-resolution timer, expiring in `us` microseconds from now.
+ *
+ * If `us` is 0, the handler is called before this function returns.
+ *
+ * @param timer Pointer to the timer.
+ * @param us Delay in microseconds.
+ * @return 0 on success, -EINVAL on invalid arguments, -EAGAIN if the timer is
+ *         already running.
+ */
+__kernel int8_t k_hrtimer_start(struct k_hrtimer *timer, uint32_t us);
+
+/**
+ * @brief Restart an expired high-resolution timer, `us` microseconds after its
+ * previous deadline.
+ *
+ * Intended to be called from the handler to generate periodic expirations
+ * without accumulating the interrupt latency. If the new deadline is already
+ * in the past, the timer expires immediately.
+ *
+ * @param timer Pointer to the timer.
+ * @param us Period in microseconds.
+ * @return 0 on success, -EINVAL on invalid arguments, -EAGAIN if the timer is
+ *         already running.
+ */
+__kernel int8_t k_hrtimer_forward(struct k_hrtimer *timer, uint32_t us);
+
+/**
+ * @brief Stop a running high-resolution timer.
+ *
+ * @param timer Pointer to the timer.
+ * @return 0 on success, -EINVAL on invalid arguments, -EAGAIN if the timer is
+ *         not running.
+ */
+__kernel int8_t k_hrtimer_cancel(struct k_hrtimer *timer);
+
+/**
+ * @brief Check whether a high-resolution timer is running.
+ *
+ * @param timer Pointer to the timer.
+ * @return true if the timer is running, false otherwise.
+ */
+__kernel bool k_hrtimer_pending(struct k_hrtimer *timer);
+
+/**
+ * @brief Put the current thread to sleep for `us` microseconds.
+ *
+ * Contrary to `k_sleep()`, the thread is woken up with the resolution of the
+ * sysclock timer counter instead of the tick.
+ *
+ * Must be called from a thread.
+ *
+ * @param us Duration in microseconds.
+ */
+__kernel void k_hrtimer_sleep_us(uint32_t us);
+
+/**
+ * @brief Check whether a high-resolution timer is running, i.e. the sysclock is
+ * required.
+ *
+ * @return true if a timer is running, false otherwise.
+ */
+__kernel bool z_hrtimers_scheduled(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AVRTOS_HRTIMER_H_ */
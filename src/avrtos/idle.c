@@ -9,6 +9,7 @@
 #include <avr/sleep.h>
 
 #include "kernel_private.h"
+#include "pm.h"
 
 #define K_MODULE K_MODULE_IDLE
 
@@ -89,7 +90,9 @@ static void z_thread_idle_entry(void *context)
 		/* Enter sleep mode if no other threads are ready to run.
 		 * This is typically used in non-cooperative idle threads.
 		 */
-#if !defined(__QEMU__) && (CONFIG_THREAD_IDLE_COOPERATIVE == 0)
+#if CONFIG_KERNEL_PM && (CONFIG_THREAD_IDLE_COOPERATIVE == 0)
+		z_pm_idle(K_PM_MODE_POWER_DOWN);
+#elif !defined(__QEMU__) && (CONFIG_THREAD_IDLE_COOPERATIVE == 0)
 		sleep_cpu();
 #endif /* __QEMU__ */
 	}
@@ -112,7 +115,10 @@ void k_idle(void)
 	if (z_ker.ready_count != 0u) {
 		k_yield();
 	} else {
-#ifndef __QEMU__
+#if CONFIG_KERNEL_PM
+		/* The caller may poll the uptime (e.g. k_wait()), keep the tick */
+		z_pm_idle(K_PM_MODE_IDLE);
+#elif !defined(__QEMU__)
 		/* A bit buggy on QEMU but normally works fine */
 		sleep_cpu();
 #endif /* __QEMU__ */
@@ -34,6 +34,7 @@
  * mode.
  * - CONFIG_KERNEL_THREAD_IDLE_ADD_STACK: Adjusts the stack size for the idle thread.
  * - CONFIG_IDLE_HOOK: Enables a custom idle hook function.
+ * - CONFIG_KERNEL_PM: Selects the deepest sleep mode allowed (see pm.h).
  */
 
 #ifndef _IDLE_H_
@@ -14,6 +14,7 @@
 #include "stack_sentinel.h"
 #include "stdio.h"
 #include "timer.h"
+#include "watchdog.h"
 
 extern void z_init_sysclock(void);
 extern void z_init_threads(void);
@@ -122,6 +123,11 @@ void z_avrtos_init(void)
 	/* Initialize system clock */
 	z_init_sysclock();
 
+#if CONFIG_KERNEL_WATCHDOG
+	/* Enable the hardware watchdog, reset from the tick handler */
+	z_watchdog_init();
+#endif
+
 #if (CONFIG_INTERRUPT_POLICY == 2) && (CONFIG_THREAD_MAIN_COOPERATIVE == 0)
 	/* Lock the scheduler if required by configuration */
 	k_sched_lock();
@@ -20,6 +20,8 @@
 #include "stack_sentinel.h"
 #include "systime.h"
 #include "timer.h"
+#include "watchdog.h"
+#include "pm.h"
 
 #define K_MODULE K_MODULE_KERNEL
 
@@ -241,6 +243,12 @@ __kernel static void z_schedule(struct k_thread *thread)
 		dlist_prepend(z_ker.run_queue, &thread->tie.runqueue);
 	}
 
+#if CONFIG_KERNEL_THREAD_TIME_SLICE
+	/* Preempt the current thread at the next systick rather than when its
+	 * budget is consumed */
+	z_ker.current->slice_remaining = 1u;
+#endif /* CONFIG_KERNEL_THREAD_TIME_SLICE */
+
 	z_ker.ready_count++;
 }
 
@@ -429,6 +437,14 @@ void z_sched_enter(void)
 	z_event_q_process();
 #endif /* CONFIG_KERNEL_EVENTS */
 
+#if CONFIG_KERNEL_WATCHDOG
+	z_watchdog_process();
+#endif /* CONFIG_KERNEL_WATCHDOG */
+
+#if CONFIG_KERNEL_PM && CONFIG_KERNEL_STATS
+	z_pm_process();
+#endif /* CONFIG_KERNEL_PM && CONFIG_KERNEL_STATS */
+
 #if CONFIG_KERNEL_ASSERT
 	z_ker.kernel_mode = 0u;
 #endif
@@ -436,6 +452,30 @@ void z_sched_enter(void)
 	__Z_DBG_SYSTICK_EXIT();
 }
 
+#if CONFIG_KERNEL_THREAD_TIME_SLICE
+/**
+ * @brief Consume one kernel time slice of the current thread budget.
+ *
+ * Called from the systick interrupt after `z_sched_enter()`, the current thread
+ * is only preempted once its budget is consumed.
+ *
+ * Assumptions: The interrupt flag is cleared when called.
+ *
+ * @return true if the current thread budget is consumed, false otherwise.
+ */
+bool z_sched_time_slice_expired(void)
+{
+	struct k_thread *const thread = z_ker.current;
+
+	if (thread->slice_remaining > 1u) {
+		thread->slice_remaining--;
+		return false;
+	}
+
+	return true;
+}
+#endif /* CONFIG_KERNEL_THREAD_TIME_SLICE */
+
 /**
  * @brief Choose the next thread to be executed.
  * This function is called during any thread switch to determine which
@@ -458,6 +498,12 @@ struct k_thread *z_scheduler(void)
 	/* Reset flags */
 	prev->flags &= ~(Z_THREAD_TIMER_EXPIRED_MSK | Z_THREAD_PEND_CANCELED_MSK);
 
+#if CONFIG_KERNEL_PM
+	/* The thread may be switched out right after waking up from a deep sleep
+	 * mode selected by z_pm_idle(), before it disables the sleep */
+	sleep_disable();
+#endif /* CONFIG_KERNEL_PM */
+
 	/* If the previous thread put itself in a pending state,
 	 * it already removed itself from the runqueue, so we don't need
 	 * to do it here
@@ -470,6 +516,11 @@ struct k_thread *z_scheduler(void)
 	/* Fetch the next thread to execute */
 	z_ker.current = CONTAINER_OF(z_ker.run_queue, struct k_thread, tie.runqueue);
 
+#if CONFIG_KERNEL_THREAD_TIME_SLICE
+	/* Give the thread its full time slice budget */
+	z_ker.current->slice_remaining = z_ker.current->time_slice;
+#endif /* CONFIG_KERNEL_THREAD_TIME_SLICE */
+
 	__Z_DBG_SCHED_NEXT_THREAD();
 	__Z_DBG_SCHED_NEXT(z_ker.current);
 
@@ -732,8 +783,31 @@ int8_t k_thread_create(struct k_thread *thread,
 	thread->symbol	  = symbol;
 	thread->swap_data = NULL;
 
+#if CONFIG_KERNEL_THREAD_TIME_SLICE
+	/* Default to a single kernel time slice, see k_thread_set_time_slice() */
+	thread->time_slice		= 1u;
+	thread->slice_remaining = 1u;
+#endif /* CONFIG_KERNEL_THREAD_TIME_SLICE */
+
+	return 0;
+}
+
+#if CONFIG_KERNEL_THREAD_TIME_SLICE
+int8_t k_thread_set_time_slice(struct k_thread *thread, k_timeout_t slice)
+{
+	Z_ARGS_CHECK(thread) return -EINVAL;
+
+	k_ticks_t slices = K_TIMEOUT_TICKS(slice) / Z_KERNEL_TIME_SLICE_TICKS;
+
+	if (slices > 255u) {
+		return -ERANGE;
+	}
+
+	thread->time_slice = MAX(slices, 1u);
+
 	return 0;
 }
+#endif /* CONFIG_KERNEL_THREAD_TIME_SLICE */
 
 int8_t k_thread_start(struct k_thread *thread)
 {
@@ -895,6 +969,91 @@ void k_wait(k_timeout_t delay, uint8_t mode)
 
 	if (unlock_sched) k_sched_unlock();
 }
+
+/**
+ * @brief Suspend the current thread until the tick counter reaches `abs_ticks`.
+ *
+ * Relative timeouts are limited by the size of k_delta_t, longer sleeps are split.
+ *
+ * Assumptions:
+ * - The interrupt flag is cleared when this function is called.
+ *
+ * @param abs_ticks Absolute wake-up time in ticks.
+ * @return 0 on success, -ETIMEDOUT if the time point is already in the past.
+ */
+static int8_t z_sleep_until(uint32_t abs_ticks)
+{
+	uint32_t remaining = abs_ticks - k_ticks_get_32();
+
+	if ((int32_t)remaining < 0) {
+		return -ETIMEDOUT;
+	}
+
+	while ((int32_t)remaining > 0) {
+		/* Largest timeout which is not K_FOREVER */
+		const k_ticks_t max = (k_ticks_t)-2;
+
+		z_pend_current(K_TICKS(MIN(remaining, max)));
+
+		remaining = abs_ticks - k_ticks_get_32();
+	}
+
+	return 0;
+}
+
+int8_t k_sleep_until(uint32_t abs_ticks)
+{
+	const uint8_t key = irq_lock();
+
+	const int8_t ret = z_sleep_until(abs_ticks);
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+int8_t k_periodic_init(struct k_periodic *periodic, k_timeout_t period)
+{
+	Z_ARGS_CHECK(periodic) return -EINVAL;
+	Z_ARGS_CHECK(!K_TIMEOUT_EQ(period, K_NO_WAIT) && !K_TIMEOUT_EQ(period, K_FOREVER))
+	{
+		return -EINVAL;
+	}
+
+	periodic->period   = K_TIMEOUT_TICKS(period);
+	periodic->overruns = 0u;
+	periodic->next	   = k_ticks_get_32() + periodic->period;
+
+	return 0;
+}
+
+int8_t k_periodic_wait(struct k_periodic *periodic)
+{
+	Z_ARGS_CHECK(periodic) return -EINVAL;
+
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	const uint32_t late = k_ticks_get_32() - periodic->next;
+
+	if ((int32_t)late > 0) {
+		/* The current release is late, skip the releases which are
+		 * already in the past to keep the loop in phase.
+		 */
+		const uint32_t missed = late / periodic->period + 1u;
+
+		periodic->overruns += missed;
+		periodic->next += missed * periodic->period;
+		ret = -ETIMEDOUT;
+	} else {
+		z_sleep_until(periodic->next);
+		periodic->next += periodic->period;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
 #endif /* CONFIG_KERNEL_UPTIME */
 
 void z_cpu_block_us(uint32_t delay_us)
@@ -63,6 +63,27 @@ __kernel int8_t k_thread_start(struct k_thread *thread);
  */
 __kernel int8_t k_thread_stop(struct k_thread *thread);
 
+/**
+ * @brief Set the time slice budget of a thread.
+ *
+ * The thread is preempted by the systick only after it has consumed its budget,
+ * expressed as a number of kernel time slices (CONFIG_KERNEL_TIME_SLICE_US), or
+ * at the next systick when another thread becomes ready. The new budget applies
+ * from the next time the thread is scheduled.
+ *
+ * Threads created with k_thread_create() get a budget of 1 kernel time slice,
+ * this function can be called before k_thread_start() to change it.
+ *
+ * Note: Requires `CONFIG_KERNEL_THREAD_TIME_SLICE` to be enabled.
+ *
+ * @param thread Pointer to the thread.
+ * @param slice Time slice budget, rounded down to a multiple of the kernel time
+ *        slice (minimum 1 slice).
+ * @return 0 on success, -EINVAL if the thread is NULL, -ERANGE if the budget exceeds
+ *         255 kernel time slices.
+ */
+__kernel int8_t k_thread_set_time_slice(struct k_thread *thread, k_timeout_t slice);
+
 /**
  * @brief Stop the execution of the current thread.
  *
@@ -323,6 +344,70 @@ __always_inline void k_msleep(uint32_t ms)
  */
 __kernel void k_wait(k_timeout_t timeout, uint8_t mode);
 
+/**
+ * @brief Suspend the current thread until the kernel tick counter reaches an absolute
+ * value.
+ *
+ * Unlike `k_sleep()`, the wake-up time does not depend on the time at which the
+ * function is called, which allows to build periodic loops that do not drift.
+ *
+ * The tick counter comparison is wrap-around safe as long as `abs_ticks` is less than
+ * 2^31 ticks away from the current time. The wake-up granularity is the time slice
+ * (CONFIG_KERNEL_TIME_SLICE_US).
+ *
+ * Note: Requires `KERNEL_UPTIME` to be enabled.
+ *
+ * @param abs_ticks The absolute time to wake up at, in ticks (see `k_ticks_get_32()`).
+ * @return 0 on success, -ETIMEDOUT if the time point is already in the past.
+ */
+__kernel int8_t k_sleep_until(uint32_t abs_ticks);
+
+/**
+ * @brief Periodic release helper.
+ *
+ * Keeps the absolute time of the next release of a periodic thread, releases are
+ * aligned on multiples of the period from the initialization time.
+ */
+struct k_periodic {
+	uint32_t next;	   /**< Next release time, in ticks */
+	uint32_t period;   /**< Period, in ticks */
+	uint16_t overruns; /**< Number of missed releases (wraps around) */
+};
+
+/**
+ * @brief Initialize a periodic release helper, the first release occurs one period
+ * after this call.
+ *
+ * Note: Requires `KERNEL_UPTIME` to be enabled.
+ *
+ * @param periodic Pointer to the periodic helper.
+ * @param period The period, must be neither K_NO_WAIT nor K_FOREVER.
+ * @return 0 on success, -EINVAL on invalid arguments.
+ */
+__kernel int8_t k_periodic_init(struct k_periodic *periodic, k_timeout_t period);
+
+/**
+ * @brief Suspend the current thread until the next release of the periodic helper.
+ *
+ * If the release time has already passed (the work took longer than the period),
+ * the function returns immediately. The missed releases are added to the
+ * `overruns` counter and the next release is moved to the next period boundary in
+ * the future, so that the phase of the loop is preserved.
+ *
+ * @example
+ * struct k_periodic periodic;
+ * k_periodic_init(&periodic, K_MSEC(10));
+ * for (;;) {
+ *     k_periodic_wait(&periodic);
+ *     control_loop();
+ * }
+ *
+ * @param periodic Pointer to the periodic helper.
+ * @return 0 if the thread was released on time, -ETIMEDOUT if at least one release
+ *         was missed, -EINVAL on invalid arguments.
+ */
+__kernel int8_t k_periodic_wait(struct k_periodic *periodic);
+
 /**
  * @brief Block the RTOS (scheduler + SYSCLOCK) for a specified amount of time in
  * microseconds.
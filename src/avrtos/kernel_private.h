@@ -101,6 +101,17 @@ __always_inline uint8_t z_get_thread_state(struct k_thread *thread)
  */
 extern void z_thread_switch(struct k_thread *from, struct k_thread *to);
 
+/**
+ * @brief Suspend the current thread until the timeout expires or the thread is
+ * woken up with `z_wake_up()`.
+ *
+ * Assumptions:
+ * - The interrupt flag is cleared when this function is called.
+ *
+ * @param timeout The timeout value for the sleep.
+ */
+__kernel void z_pend_current(k_timeout_t timeout);
+
 /**
  * @brief Suspend the current thread and wait for an object to become available.
  *
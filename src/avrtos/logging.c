@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "logging.h"
+
+#include <stdarg.h>
+
+#include "semaphore.h"
+#include "systime.h"
+
+#if CONFIG_LOGGING_SUBSYSTEM && CONFIG_LOGGING_DEFERRED
+
+/* sync, len, flags and fmt */
+#define Z_LOG_HEADER_SIZE 5u
+
+#if CONFIG_KERNEL_TICKS_COUNTER
+#define Z_LOG_TICKS_SIZE 4u
+#else
+#define Z_LOG_TICKS_SIZE 0u
+#endif
+
+#define Z_LOG_RECORD_MAX_SIZE (2u + 0xFFu)
+
+/* Records are stored in the wire format, one free byte distinguishes full from empty */
+static uint8_t z_log_buf[CONFIG_LOGGING_DEFERRED_BUFFER_SIZE];
+static uint16_t z_log_r		  = 0u;
+static uint16_t z_log_w		  = 0u;
+static uint16_t z_log_dropped = 0u;
+
+/* Signaled when a record is stored */
+static K_SEM_DEFINE(z_log_sem, 0u, 1u);
+
+static uint16_t z_log_free(void)
+{
+	if (z_log_w >= z_log_r) {
+		return CONFIG_LOGGING_DEFERRED_BUFFER_SIZE - 1u - (z_log_w - z_log_r);
+	} else {
+		return z_log_r - z_log_w - 1u;
+	}
+}
+
+static void z_log_put(const void *data, uint8_t len)
+{
+	const uint8_t *p = data;
+
+	while (len--) {
+		z_log_buf[z_log_w++] = *p++;
+		if (z_log_w == CONFIG_LOGGING_DEFERRED_BUFFER_SIZE) {
+			z_log_w = 0u;
+		}
+	}
+}
+
+/**
+ * @brief Reserve room for a record and write its header.
+ *
+ * Requires interrupts to be disabled.
+ *
+ * @return true if the payload can be written, false if the record is dropped
+ */
+static bool z_log_begin(uint8_t flags, const char *fmt, uint8_t payload_len)
+{
+	const uint16_t size = Z_LOG_HEADER_SIZE + Z_LOG_TICKS_SIZE + payload_len;
+
+	if (size > z_log_free()) {
+		z_log_dropped++;
+		return false;
+	}
+
+	const uint8_t header[Z_LOG_HEADER_SIZE] = {
+		Z_LOG_SYNC,
+		(uint8_t)(size - 2u),
+#if CONFIG_KERNEL_TICKS_COUNTER
+		flags | Z_LOG_FLAGS_TICKS,
+#else
+		flags,
+#endif
+		(uint8_t)(uint16_t)fmt,
+		(uint8_t)((uint16_t)fmt >> 8u),
+	};
+	z_log_put(header, sizeof(header));
+
+#if CONFIG_KERNEL_TICKS_COUNTER
+	const uint32_t ticks = k_ticks_get_32();
+	z_log_put(&ticks, sizeof(ticks));
+#endif
+
+	return true;
+}
+
+void z_log_deferred(uint8_t level, const char *fmt, uint16_t sig, ...)
+{
+	uint8_t payload_len = 0u;
+
+	/* 2, 4 or 8 bytes per argument */
+	for (uint16_t s = sig; s != 0u; s >>= 2u) {
+		payload_len += 1u << (s & 3u);
+	}
+
+	va_list ap;
+	va_start(ap, sig);
+
+	const uint8_t key = irq_lock();
+
+	if (z_log_begin(Z_LOG_FLAGS_TYPE_MSG | level, fmt, payload_len)) {
+		for (; sig != 0u; sig >>= 2u) {
+			switch (sig & 3u) {
+			case 1u: {
+				const unsigned int v = va_arg(ap, unsigned int);
+				z_log_put(&v, sizeof(v));
+				break;
+			}
+			case 2u: {
+				const uint32_t v = va_arg(ap, uint32_t);
+				z_log_put(&v, sizeof(v));
+				break;
+			}
+			default: {
+				const uint64_t v = va_arg(ap, uint64_t);
+				z_log_put(&v, sizeof(v));
+				break;
+			}
+			}
+		}
+	}
+
+	irq_unlock(key);
+
+	va_end(ap);
+
+	k_sem_give(&z_log_sem);
+}
+
+void z_log_deferred_hexdump(uint8_t level, const void *data, size_t len)
+{
+	const size_t max = Z_LOG_RECORD_MAX_SIZE - Z_LOG_HEADER_SIZE - Z_LOG_TICKS_SIZE;
+
+	if (len > max) {
+		len = max;
+	}
+
+	const uint8_t key = irq_lock();
+
+	if (z_log_begin(Z_LOG_FLAGS_TYPE_HEXDUMP | level, NULL, len)) {
+		z_log_put(data, len);
+	}
+
+	irq_unlock(key);
+
+	k_sem_give(&z_log_sem);
+}
+
+static void z_log_thread_entry(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	for (;;) {
+		k_sem_take(&z_log_sem, K_FOREVER);
+
+		for (;;) {
+			uint8_t key = irq_lock();
+
+			/* Report dropped records first */
+			const uint16_t dropped = z_log_dropped;
+			if ((dropped != 0u) &&
+				z_log_begin(Z_LOG_FLAGS_TYPE_DROPPED, NULL, sizeof(dropped))) {
+				z_log_put(&dropped, sizeof(dropped));
+				z_log_dropped = 0u;
+			}
+
+			const uint16_t w = z_log_w;
+			uint16_t r		 = z_log_r;
+			irq_unlock(key);
+
+			if (r == w) {
+				break;
+			}
+
+			/* Producers do not write before z_log_r, the record can be sent
+			 * without locking interrupts. */
+			uint16_t size = 2u + z_log_buf[(r + 1u) % CONFIG_LOGGING_DEFERRED_BUFFER_SIZE];
+			while (size--) {
+				putchar(z_log_buf[r++]);
+				if (r == CONFIG_LOGGING_DEFERRED_BUFFER_SIZE) {
+					r = 0u;
+				}
+			}
+
+			key		= irq_lock();
+			z_log_r = r;
+			irq_unlock(key);
+		}
+	}
+}
+
+K_THREAD_DEFINE(z_log_thread,
+				z_log_thread_entry,
+				CONFIG_LOGGING_DEFERRED_THREAD_STACK_SIZE,
+				K_PREEMPTIVE,
+				NULL,
+				'L');
+
+#endif /* CONFIG_LOGGING_SUBSYSTEM && CONFIG_LOGGING_DEFERRED */
@@ -24,7 +24,92 @@
 #define LOG_LEVEL_INF LOG_LEVEL_INFO
 #define LOG_LEVEL_DBG LOG_LEVEL_DEBUG
 
-#if CONFIG_LOGGING_SUBSYSTEM
+#if CONFIG_LOGGING_SUBSYSTEM && CONFIG_LOGGING_DEFERRED
+
+/*
+ * Deferred logging record format (little endian), decoded by scripts/log_decoder.py:
+ *
+ *   Z_LOG_SYNC | len | flags | fmt (2) | [ticks (4)] | payload
+ *
+ * - len: number of bytes following the len byte
+ * - flags: bits 0-2 level, bit 3 ticks present, bits 4-5 record type
+ * - fmt: address of the format string in flash (0 if not a message)
+ * - payload: raw arguments (default promotions applied), hexdump data or
+ *   number of dropped records (2 bytes)
+ */
+#define Z_LOG_SYNC				0xA5u
+#define Z_LOG_FLAGS_LEVEL_MSK	0x07u
+#define Z_LOG_FLAGS_TICKS		0x08u
+#define Z_LOG_FLAGS_TYPE_MSG	0x00u
+#define Z_LOG_FLAGS_TYPE_HEXDUMP 0x10u
+#define Z_LOG_FLAGS_TYPE_DROPPED 0x20u
+
+/* Size code of an argument after default promotions: 1: 2 bytes, 2: 4 bytes, 3: 8 bytes */
+#define Z_LOG_ARG_CODE(_x)                                                               \
+	(sizeof((_x) + 0) == 8u ? 3u : (sizeof((_x) + 0) == 4u ? 2u : 1u))
+
+#define Z_LOG_SIG_0(...)		0u
+#define Z_LOG_SIG_1(_a)			Z_LOG_ARG_CODE(_a)
+#define Z_LOG_SIG_2(_a, ...)	(Z_LOG_ARG_CODE(_a) | (Z_LOG_SIG_1(__VA_ARGS__) << 2u))
+#define Z_LOG_SIG_3(_a, ...)	(Z_LOG_ARG_CODE(_a) | (Z_LOG_SIG_2(__VA_ARGS__) << 2u))
+#define Z_LOG_SIG_4(_a, ...)	(Z_LOG_ARG_CODE(_a) | (Z_LOG_SIG_3(__VA_ARGS__) << 2u))
+#define Z_LOG_SIG_5(_a, ...)	(Z_LOG_ARG_CODE(_a) | (Z_LOG_SIG_4(__VA_ARGS__) << 2u))
+#define Z_LOG_SIG_6(_a, ...)	(Z_LOG_ARG_CODE(_a) | (Z_LOG_SIG_5(__VA_ARGS__) << 2u))
+#define Z_LOG_SIG_7(_a, ...)	(Z_LOG_ARG_CODE(_a) | (Z_LOG_SIG_6(__VA_ARGS__) << 2u))
+#define Z_LOG_SIG_8(_a, ...)	(Z_LOG_ARG_CODE(_a) | (Z_LOG_SIG_7(__VA_ARGS__) << 2u))
+#define Z_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define Z_LOG_NARGS(...)		Z_LOG_NARGS_(_0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define Z_LOG_SIG__(n, ...)		Z_LOG_SIG_##n(__VA_ARGS__)
+#define Z_LOG_SIG_(n, ...)		Z_LOG_SIG__(n, ##__VA_ARGS__)
+
+/* Sizes of up to 8 arguments, 2 bits per argument, first argument in the LSBs */
+#define Z_LOG_SIG(...)			Z_LOG_SIG_(Z_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Store a deferred log record, called by the LOG_* macros.
+ *
+ * Can be called from interrupt context, the record is dropped if the buffer is full.
+ *
+ * @param level Log level
+ * @param fmt Format string in flash
+ * @param sig Sizes of the arguments (see Z_LOG_SIG)
+ * @param ... Arguments
+ */
+__kernel void z_log_deferred(uint8_t level, const char *fmt, uint16_t sig, ...);
+
+/**
+ * @brief Store a deferred hexdump record, data is truncated to fit a record.
+ *
+ * @param level Log level
+ * @param data Data to dump
+ * @param len Length of the data
+ */
+__kernel void z_log_deferred_hexdump(uint8_t level, const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define _LOG(level, fmt, ...)                                                            \
+	do {                                                                                 \
+		if ((level) <= (LOG_LEVEL)) {                                                    \
+			z_log_deferred((level), (const char *)PSTR(fmt), Z_LOG_SIG(__VA_ARGS__),     \
+						   ##__VA_ARGS__);                                               \
+		}                                                                                \
+	} while (0)
+
+#define _LOG_HEXDUMP(level, data, len)                                                   \
+	do {                                                                                 \
+		if ((level) <= (LOG_LEVEL)) {                                                    \
+			z_log_deferred_hexdump((level), (data), (len));                              \
+		}                                                                                \
+	} while (0)
+
+#elif CONFIG_LOGGING_SUBSYSTEM
 
 #define _LOG(level, fmt, ...)                                                            \
 	do {                                                                                 \
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "pm.h"
+
+#include <string.h>
+
+#include <avr/sleep.h>
+
+#include "event.h"
+#include "hrtimer.h"
+#include "kernel_private.h"
+#include "timer.h"
+
+#define K_MODULE K_MODULE_PM
+
+#if CONFIG_KERNEL_PM
+
+#define Z_PM_CK_TO_US(_ck) ((uint16_t)(((_ck) * 1000000llu + F_CPU - 1u) / F_CPU))
+
+/* Wake-up from the modes stopping the main oscillator */
+#define Z_PM_STARTUP_US Z_PM_CK_TO_US(CONFIG_KERNEL_PM_OSC_STARTUP_CK)
+
+/* Wake-up from the standby modes */
+#define Z_PM_STANDBY_US Z_PM_CK_TO_US(6u)
+
+#define Z_PM_CAPS_ALL (BIT(K_PM_CAPS_COUNT) - 1u)
+
+struct z_pm_mode {
+	uint8_t smcr;			  /* SM2:0 bits */
+	uint8_t caps;			  /* Capabilities kept in the mode */
+	uint16_t exit_latency_us; /* Time before the first interrupt is served */
+};
+
+static const struct z_pm_mode z_pm_modes[K_PM_MODES_COUNT] = {
+	[K_PM_MODE_IDLE] = {SLEEP_MODE_IDLE, Z_PM_CAPS_ALL, 0u},
+	[K_PM_MODE_ADC_NOISE_REDUCTION] =
+		{SLEEP_MODE_ADC,
+		 K_PM_CAP_ADC | K_PM_CAP_EEPROM | K_PM_CAP_TIMER2_ASYNC | K_PM_CAP_OSC, 0u},
+	[K_PM_MODE_EXTENDED_STANDBY] = {SLEEP_MODE_EXT_STANDBY,
+									K_PM_CAP_TIMER2_ASYNC | K_PM_CAP_OSC,
+									Z_PM_STANDBY_US},
+	[K_PM_MODE_STANDBY]			 = {SLEEP_MODE_STANDBY, K_PM_CAP_OSC, Z_PM_STANDBY_US},
+	[K_PM_MODE_POWER_SAVE] = {SLEEP_MODE_PWR_SAVE, K_PM_CAP_TIMER2_ASYNC, Z_PM_STARTUP_US},
+	[K_PM_MODE_POWER_DOWN] = {SLEEP_MODE_PWR_DOWN, 0u, Z_PM_STARTUP_US},
+};
+
+/* Number of references held on each capability */
+static uint8_t z_pm_refs[K_PM_CAPS_COUNT];
+
+#if CONFIG_KERNEL_STATS
+static struct k_pm_stats z_pm_stats;
+
+/* Thread sleeping in IDLE mode, sampled by the tick handler */
+static struct k_thread *z_pm_sleeper = NULL;
+#endif /* CONFIG_KERNEL_STATS */
+
+void k_pm_require(uint8_t caps)
+{
+	const uint8_t key = irq_lock();
+
+	for (uint8_t i = 0u; caps != 0u; i++, caps >>= 1u) {
+		if (caps & 1u) {
+			z_pm_refs[i]++;
+		}
+	}
+
+	irq_unlock(key);
+}
+
+void k_pm_release(uint8_t caps)
+{
+	const uint8_t key = irq_lock();
+
+	for (uint8_t i = 0u; caps != 0u; i++, caps >>= 1u) {
+		if ((caps & 1u) && (z_pm_refs[i] != 0u)) {
+			z_pm_refs[i]--;
+		}
+	}
+
+	irq_unlock(key);
+}
+
+/**
+ * @brief Check whether the tick is required by a pending kernel deadline.
+ *
+ * Requires interrupts to be disabled.
+ */
+static bool z_pm_deadline_pending(void)
+{
+#if CONFIG_KERNEL_WATCHDOG
+	/* The hardware watchdog is reset from the tick handler */
+	return true;
+#else
+	return (z_ker.timeouts_queue != NULL)
+#if CONFIG_KERNEL_TIMERS
+		   || z_timers_scheduled()
+#endif
+#if CONFIG_KERNEL_EVENTS
+		   || z_event_q_scheduled()
+#endif
+#if CONFIG_KERNEL_HRTIMER
+		   || z_hrtimers_scheduled()
+#endif
+		;
+#endif /* CONFIG_KERNEL_WATCHDOG */
+}
+
+/**
+ * @brief Select the deepest sleep mode allowed, no deeper than the given mode.
+ *
+ * Requires interrupts to be disabled.
+ */
+static k_pm_mode_t z_pm_select(k_pm_mode_t max)
+{
+	uint8_t caps = 0u;
+
+	for (uint8_t i = 0u; i < K_PM_CAPS_COUNT; i++) {
+		if (z_pm_refs[i] != 0u) {
+			caps |= BIT(i);
+		}
+	}
+
+	if (z_pm_deadline_pending()) {
+		caps |= K_PM_CAP_CLK_IO;
+	}
+
+	/* IDLE keeps every capability */
+	k_pm_mode_t mode;
+	for (mode = max; mode != K_PM_MODE_IDLE; mode--) {
+		const struct z_pm_mode *const m = &z_pm_modes[mode];
+
+		if ((CONFIG_KERNEL_PM_MODES & BIT(mode)) && ((m->caps & caps) == caps) &&
+			(m->exit_latency_us <= CONFIG_KERNEL_PM_MAX_LATENCY_US)) {
+			break;
+		}
+	}
+
+	return mode;
+}
+
+k_pm_mode_t k_pm_mode_get(void)
+{
+	const uint8_t key		= irq_lock();
+	const k_pm_mode_t mode = z_pm_select(K_PM_MODE_POWER_DOWN);
+	irq_unlock(key);
+
+	return mode;
+}
+
+void z_pm_idle(k_pm_mode_t max)
+{
+	cli();
+
+	/* A thread may have been woken up by an interrupt without yielding */
+	if (z_ker.ready_count == 0u) {
+		const k_pm_mode_t mode = z_pm_select(max);
+
+		set_sleep_mode(z_pm_modes[mode].smcr);
+
+#if CONFIG_KERNEL_STATS
+		z_pm_stats.entries[mode]++;
+		if (mode == K_PM_MODE_IDLE) {
+			z_pm_sleeper = z_ker.current;
+		}
+#endif
+
+#if !defined(__QEMU__)
+		/* Interrupts are enabled after the SLEEP instruction, an interrupt
+		 * which occurred since the mode was selected wakes up the CPU at once */
+		sleep_enable();
+		sei();
+		sleep_cpu();
+		sleep_disable();
+#endif /* __QEMU__ */
+
+#if CONFIG_KERNEL_STATS
+		cli();
+		z_pm_sleeper = NULL;
+#endif
+	}
+
+	sei();
+}
+
+void z_pm_process(void)
+{
+#if CONFIG_KERNEL_STATS
+	/* The CPU was sleeping if the interrupted thread is the sleeping one, the
+	 * tick only runs in IDLE mode */
+	if (z_pm_sleeper == z_ker.current) {
+		z_pm_stats.idle_ticks += Z_KERNEL_TIME_SLICE_TICKS;
+	}
+#endif /* CONFIG_KERNEL_STATS */
+}
+
+void k_pm_stats_get(struct k_pm_stats *stats, bool reset)
+{
+#if CONFIG_KERNEL_STATS
+	const uint8_t key = irq_lock();
+
+	*stats = z_pm_stats;
+	if (reset) {
+		memset(&z_pm_stats, 0x00u, sizeof(z_pm_stats));
+	}
+
+	irq_unlock(key);
+#else
+	ARG_UNUSED(reset);
+
+	memset(stats, 0x00u, sizeof(*stats));
+#endif /* CONFIG_KERNEL_STATS */
+}
+
+#endif /* CONFIG_KERNEL_PM */
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Power Management
+ *
+ * When no thread is ready, the idle thread enters the deepest sleep mode which
+ * keeps running everything still needed:
+ * - Peripherals (and the application) hold a reference on the capabilities they
+ *   require while they are active with k_pm_require()/k_pm_release(), e.g. the
+ *   USART, SPI and I2C drivers hold K_PM_CAP_CLK_IO while a transfer is in
+ *   progress, a USART while its receiver is enabled and the timers while they
+ *   are running. Polled transmissions (e.g. printf() without
+ *   CONFIG_STDIO_USART_TX_BUFFER_SIZE) do not hold any reference, the last
+ *   bytes may be cut when a deep sleep mode is entered.
+ * - As long as a kernel deadline is pending (sleeping thread, timer, event,
+ *   high-resolution timer), the sysclock must keep ticking, which requires
+ *   K_PM_CAP_CLK_IO as well, only the IDLE mode is then allowed.
+ * - Modes whose exit latency (oscillator start-up) exceeds
+ *   CONFIG_KERNEL_PM_MAX_LATENCY_US are not used.
+ *
+ * The sysclock is stopped in the modes deeper than IDLE, the uptime does not
+ * advance while the MCU sleeps in these modes. The MCU is then woken up by an
+ * external interrupt (level interrupt on INTn, pin change interrupt), a TWI
+ * address match, the watchdog or the asynchronous timer 2.
+ *
+ * If CONFIG_KERNEL_STATS is enabled, the number of times each mode is entered
+ * and the number of ticks spent in IDLE mode are accounted (see k_pm_stats_get()).
+ *
+ * Related configuration options:
+ *  - CONFIG_KERNEL_PM: Enables the power management.
+ *  - CONFIG_KERNEL_PM_MODES: Sleep modes allowed.
+ *  - CONFIG_KERNEL_PM_OSC_STARTUP_CK: Oscillator start-up time (fuses).
+ *  - CONFIG_KERNEL_PM_MAX_LATENCY_US: Maximum exit latency tolerated.
+ *  - CONFIG_KERNEL_STATS: Enables the sleep residency statistics.
+ */
+
+#ifndef _AVRTOS_PM_H_
+#define _AVRTOS_PM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "kernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sleep modes, from the shallowest to the deepest.
+ */
+typedef enum {
+	K_PM_MODE_IDLE				  = 0u, ///< CPU stopped, all peripherals running.
+	K_PM_MODE_ADC_NOISE_REDUCTION = 1u, ///< clk_IO stopped, ADC and timer 2 running.
+	K_PM_MODE_EXTENDED_STANDBY	  = 2u, ///< Oscillator and asynchronous timer 2 running.
+	K_PM_MODE_STANDBY			  = 3u, ///< Oscillator running (fast wake-up).
+	K_PM_MODE_POWER_SAVE		  = 4u, ///< Asynchronous timer 2 running.
+	K_PM_MODE_POWER_DOWN		  = 5u, ///< Everything stopped but the wake-up sources.
+} k_pm_mode_t;
+
+#define K_PM_MODES_COUNT 6u
+
+/* Capabilities which must be kept by the sleep mode, each one is reference
+ * counted (see k_pm_require()) */
+
+/* clk_IO: USART, SPI, TWI master, timers (but asynchronous timer 2), sysclock */
+#define K_PM_CAP_CLK_IO BIT(0u)
+/* ADC conversion complete interrupt */
+#define K_PM_CAP_ADC BIT(1u)
+/* EEPROM ready interrupt */
+#define K_PM_CAP_EEPROM BIT(2u)
+/* Timer 2 clocked from the 32kHz crystal (AS2) */
+#define K_PM_CAP_TIMER2_ASYNC BIT(3u)
+/* Main oscillator, for a wake-up within 6 clock cycles */
+#define K_PM_CAP_OSC BIT(4u)
+
+#define K_PM_CAPS_COUNT 5u
+
+/**
+ * @brief Sleep statistics.
+ *
+ * The residency is only accounted in IDLE mode, the sysclock being stopped in
+ * the deeper modes.
+ */
+struct k_pm_stats {
+	uint32_t entries[K_PM_MODES_COUNT]; ///< Number of times each mode was entered.
+	uint32_t idle_ticks;				///< Ticks spent in IDLE mode.
+};
+
+/**
+ * @brief Take a reference on capabilities which must be kept while sleeping.
+ *
+ * Safety: This function is safe to call from an ISR context.
+ *
+ * @param caps Capabilities (K_PM_CAP_*).
+ */
+__kernel void k_pm_require(uint8_t caps);
+
+/**
+ * @brief Release a reference taken with `k_pm_require()`.
+ *
+ * Safety: This function is safe to call from an ISR context.
+ *
+ * @param caps Capabilities (K_PM_CAP_*).
+ */
+__kernel void k_pm_release(uint8_t caps);
+
+/**
+ * @brief Get the deepest sleep mode currently allowed.
+ *
+ * @return k_pm_mode_t Sleep mode.
+ */
+__kernel k_pm_mode_t k_pm_mode_get(void);
+
+/**
+ * @brief Get the sleep statistics.
+ *
+ * Note: Requires `CONFIG_KERNEL_STATS` to be enabled.
+ *
+ * @param stats Statistics to fill.
+ * @param reset Reset the statistics once read.
+ */
+__kernel void k_pm_stats_get(struct k_pm_stats *stats, bool reset);
+
+/**
+ * @brief Sleep until the next interrupt, in the deepest mode allowed but no
+ * deeper than the given mode.
+ *
+ * The MCU does not sleep if a thread is ready.
+ *
+ * @param max Deepest sleep mode, K_PM_MODE_IDLE if the caller polls the uptime.
+ */
+__kernel void z_pm_idle(k_pm_mode_t max);
+
+/**
+ * @brief Account the ticks spent sleeping, called from the tick handler.
+ *
+ * Assumptions: The interrupt flag is cleared when called.
+ */
+__kernel void z_pm_process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AVRTOS_PM_H_ */
@@ -16,9 +16,13 @@ int8_t k_ring_push(struct k_ring *ring, char data)
 {
 	Z_ARGS_CHECK(ring) return -EINVAL;
 
-	const uint8_t r	  = ring->r;
-	uint8_t w		  = ring->w;
-	const uint8_t rem = ring->size - (w - r) - 1u;
+	const uint8_t r = ring->r;
+	uint8_t w		= ring->w;
+
+	/* Bytes in use, modulo the size of the buffer (the write cursor may have
+	 * wrapped around) */
+	const uint8_t used = (w >= r) ? (w - r) : (ring->size - r + w);
+	const uint8_t rem  = ring->size - used - 1u;
 
 	if (!rem) {
 		return -ENOMEM;
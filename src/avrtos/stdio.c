@@ -6,9 +6,147 @@
 
 #include "stdio.h"
 
-#include "misc/serial.h"
+#include "drivers/usart.h"
+#include "ring.h"
+#include "semaphore.h"
+
+#if CONFIG_STDIO_PRINTF_TO_USART >= 0
+
+#if CONFIG_STDIO_PRINTF_TO_USART >= ARCH_USART_COUNT
+#error "CONFIG_STDIO_PRINTF_TO_USART: USART not available on this MCU"
+#endif
+
+#define Z_STDIO_USART_DEVICE AVR_USARTn_BASE(CONFIG_STDIO_PRINTF_TO_USART)
+
+#if CONFIG_STDIO_USART_TX_BUFFER_SIZE
+
+#define Z_STDIO_POLICY_BLOCK	 0
+#define Z_STDIO_POLICY_DROP		 1
+#define Z_STDIO_POLICY_OVERWRITE 2
+
+static uint8_t z_stdio_tx_buf[CONFIG_STDIO_USART_TX_BUFFER_SIZE];
+static struct k_ring z_stdio_tx =
+	Z_RING_INIT(z_stdio_tx_buf, CONFIG_STDIO_USART_TX_BUFFER_SIZE);
+
+#if CONFIG_STDIO_USART_TX_FULL_POLICY == Z_STDIO_POLICY_BLOCK
+/* Signaled by the UDRE interrupt when room is available in the buffer */
+static K_SEM_DEFINE(z_stdio_tx_sem, 0u, 1u);
+#else
+/* Number of characters lost because the buffer was full */
+static uint16_t z_stdio_dropped = 0u;
+#endif
 
 #if CONFIG_STDIO_PRINTF_TO_USART == 0
+ISR(USART0_UDRE_vect)
+#elif CONFIG_STDIO_PRINTF_TO_USART == 1
+ISR(USART1_UDRE_vect)
+#elif CONFIG_STDIO_PRINTF_TO_USART == 2
+ISR(USART2_UDRE_vect)
+#elif CONFIG_STDIO_PRINTF_TO_USART == 3
+ISR(USART3_UDRE_vect)
+#else
+#error "CONFIG_STDIO_USART_TX_BUFFER_SIZE: unsupported USART"
+#endif
+{
+	char c;
+
+	if (k_ring_pop(&z_stdio_tx, &c) == 0) {
+		Z_STDIO_USART_DEVICE->UDRn = c;
+
+#if CONFIG_STDIO_USART_TX_FULL_POLICY == Z_STDIO_POLICY_BLOCK
+		struct k_thread *const thread = k_sem_give(&z_stdio_tx_sem);
+		k_yield_from_isr_cond(thread);
+#endif
+	} else {
+		ll_usart_tx_drained(Z_STDIO_USART_DEVICE);
+	}
+}
+
+#if CONFIG_KERNEL_PM
+#if CONFIG_STDIO_PRINTF_TO_USART == 0
+ISR(USART0_TX_vect)
+#elif CONFIG_STDIO_PRINTF_TO_USART == 1
+ISR(USART1_TX_vect)
+#elif CONFIG_STDIO_PRINTF_TO_USART == 2
+ISR(USART2_TX_vect)
+#else
+ISR(USART3_TX_vect)
+#endif
+{
+	ll_usart_tx_complete(Z_STDIO_USART_DEVICE);
+}
+#endif /* CONFIG_KERNEL_PM */
+
+/**
+ * @brief Custom character output function for USART.
+ *
+ * The character is queued in the TX ring buffer and sent by the UDRE interrupt,
+ * the policy CONFIG_STDIO_USART_TX_FULL_POLICY applies when the buffer is full.
+ *
+ * @param c The character to be transmitted.
+ * @param stream The stream to which the character is written (not used).
+ * @return 0 on success.
+ */
+static int uart_putchar(char c, FILE *stream)
+{
+	(void)stream;
+
+	for (;;) {
+		/* Several threads may print concurrently */
+		const uint8_t key = irq_lock();
+		int8_t ret		  = k_ring_push(&z_stdio_tx, c);
+
+#if CONFIG_STDIO_USART_TX_FULL_POLICY == Z_STDIO_POLICY_OVERWRITE
+		if (ret != 0) {
+			char oldest;
+			k_ring_pop(&z_stdio_tx, &oldest);
+			ret = k_ring_push(&z_stdio_tx, c);
+			z_stdio_dropped++;
+		}
+#endif
+
+		if (ret == 0) {
+			ll_usart_tx_start(Z_STDIO_USART_DEVICE);
+		}
+		irq_unlock(key);
+
+		if (ret == 0) {
+			return 0;
+		}
+
+#if CONFIG_STDIO_USART_TX_FULL_POLICY == Z_STDIO_POLICY_DROP
+		z_stdio_dropped++;
+		return 0;
+#elif CONFIG_STDIO_USART_TX_FULL_POLICY == Z_STDIO_POLICY_BLOCK
+		if (key & BIT(SREG_I)) {
+			k_sem_take(&z_stdio_tx_sem, K_FOREVER);
+		} else {
+			/* Interrupts are disabled (e.g. ISR), make room by sending
+			 * the oldest character by polling.
+			 */
+			char oldest;
+			k_ring_pop(&z_stdio_tx, &oldest);
+			ll_usart_sync_putc(Z_STDIO_USART_DEVICE, oldest);
+		}
+#endif
+	}
+}
+
+uint16_t k_stdio_dropped_get(void)
+{
+#if CONFIG_STDIO_USART_TX_FULL_POLICY != Z_STDIO_POLICY_BLOCK
+	const uint8_t key	   = irq_lock();
+	const uint16_t dropped = z_stdio_dropped;
+	irq_unlock(key);
+
+	return dropped;
+#else
+	/* Characters are never dropped */
+	return 0u;
+#endif
+}
+
+#else
 
 /**
  * @brief Custom character output function for USART.
@@ -20,32 +158,55 @@
 static int uart_putchar(char c, FILE *stream)
 {
 	(void)stream;
-	serial_transmit(c);
+	ll_usart_sync_putc(Z_STDIO_USART_DEVICE, c);
 	return 0;
 }
 
+uint16_t k_stdio_dropped_get(void)
+{
+	/* Characters are sent by polling, never dropped */
+	return 0u;
+}
+
+#endif /* CONFIG_STDIO_USART_TX_BUFFER_SIZE */
+
 /**
- * @brief File stream for USART0 output.
+ * @brief File stream for USART output.
  *
- * This file stream is used to direct standard output (`stdout`) to USART0.
+ * This file stream is used to direct standard output (`stdout`) to the USART
+ * selected by CONFIG_STDIO_PRINTF_TO_USART.
  * It is initialized with `uart_putchar` as the output function.
  */
 static FILE z_stdout_usart = FDEV_SETUP_STREAM(uart_putchar, NULL, _FDEV_SETUP_WRITE);
 
 /**
- * @brief Set standard I/O to use USART0.
+ * @brief Set standard I/O to use the USART selected by CONFIG_STDIO_PRINTF_TO_USART.
  *
- * This function configures the standard I/O library to use USART0 for
- * output operations. It sets `stdout` to the `z_stdout_usart` file stream
- * which directs output to USART0.
+ * This function configures the standard I/O library to use the USART for
+ * output operations. It sets `stdout` to the `z_stdout_usart` file stream.
+ * USART0 is initialized by serial_init(), other USARTs are initialized here.
  */
 void k_set_stdio_usart0(void)
 {
-	stdout = &z_stdout_usart;
-}
+#if CONFIG_STDIO_PRINTF_TO_USART > 0
+	const struct usart_config config = {
+		.baudrate	 = CONFIG_SERIAL_USART_BAUDRATE,
+		.receiver	 = 0u,
+		.transmitter = 1u,
+		.mode		 = USART_MODE_ASYNCHRONOUS,
+		.parity		 = USART_PARITY_NONE,
+		.stopbits	 = USART_STOP_BITS_1,
+		.databits	 = USART_DATA_BITS_8,
+		.speed_mode	 = USART_SPEED_MODE_NORMAL,
+	};
+	ll_usart_init(Z_STDIO_USART_DEVICE, &config);
 
-#elif CONFIG_STDIO_PRINTF_TO_USART > 0
+	/* No handler for RX and TX complete interrupts on this USART */
+	ll_usart_disable_rx_isr(Z_STDIO_USART_DEVICE);
+	ll_usart_disable_tx_isr(Z_STDIO_USART_DEVICE);
+#endif
 
-#warning "CONFIG_STDIO_PRINTF_TO_USART > 0 not supported"
+	stdout = &z_stdout_usart;
+}
 
 #endif /* CONFIG_STDIO_PRINTF_TO_USART */
@@ -22,10 +22,24 @@ extern "C" {
  * the function `printf`, to use USART0 for input and output.
  *
  * The configuration option `CONFIG_STDIO_PRINTF_TO_USART` automatically selects the
- * USART to use for standard I/O.
+ * USART to use for standard I/O, USARTs other than USART0 are initialized by this
+ * function with `CONFIG_SERIAL_USART_BAUDRATE`.
+ *
+ * If `CONFIG_STDIO_USART_TX_BUFFER_SIZE` is set, characters are queued in a ring
+ * buffer drained by the UDRE interrupt and `printf` does not wait for the wire.
  */
 __kernel void k_set_stdio_usart0(void);
 
+/**
+ * @brief Get the number of characters lost because the stdio TX buffer was full.
+ *
+ * Characters are only lost if `CONFIG_STDIO_USART_TX_FULL_POLICY` is set to drop
+ * (1) or overwrite (2), 0 is returned otherwise.
+ *
+ * @return Number of dropped characters.
+ */
+__kernel uint16_t k_stdio_dropped_get(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Sysclock hardware timer parameters, computed at compile time from
+ * CONFIG_KERNEL_SYSLOCK_HW_TIMER and CONFIG_KERNEL_SYSCLOCK_PERIOD_US.
+ *
+ * All values are preprocessor constants, they can be used in #if tests and
+ * static initializers (e.g. K_CYCLES_PER_SEC).
+ */
+
+#ifndef _AVRTOS_SYSCLOCK_H_
+#define _AVRTOS_SYSCLOCK_H_
+
+#include "defines.h"
+
+/* Timers 0 and 2 are 8-bit timers, the others are 16-bit timers */
+#if (CONFIG_KERNEL_SYSLOCK_HW_TIMER == 0) || (CONFIG_KERNEL_SYSLOCK_HW_TIMER == 2)
+#define Z_SYSCLOCK_TIMER_MAX_COUNTER 0xFFLU
+#else
+#define Z_SYSCLOCK_TIMER_MAX_COUNTER 0xFFFFLU
+#endif
+
+#define Z_SYSCLOCK_CALC_COUNTER_VALUE(prescaler)                                         \
+	(((F_CPU / 1000000LU) * CONFIG_KERNEL_SYSCLOCK_PERIOD_US) / (prescaler) - 1LU)
+#define Z_SYSCLOCK_PRESCALER_FIT(prescaler)                                              \
+	(Z_SYSCLOCK_CALC_COUNTER_VALUE(prescaler) <= Z_SYSCLOCK_TIMER_MAX_COUNTER)
+
+/* Prescalers 32 and 128 are only available on timer 2 */
+#if Z_SYSCLOCK_PRESCALER_FIT(1LU)
+#define Z_SYSCLOCK_PRESCALER_VALUE 1
+#elif Z_SYSCLOCK_PRESCALER_FIT(8LU)
+#define Z_SYSCLOCK_PRESCALER_VALUE 8
+#elif Z_SYSCLOCK_PRESCALER_FIT(32LU) && (CONFIG_KERNEL_SYSLOCK_HW_TIMER == 2)
+#define Z_SYSCLOCK_PRESCALER_VALUE 32
+#elif Z_SYSCLOCK_PRESCALER_FIT(64LU)
+#define Z_SYSCLOCK_PRESCALER_VALUE 64
+#elif Z_SYSCLOCK_PRESCALER_FIT(128LU) && (CONFIG_KERNEL_SYSLOCK_HW_TIMER == 2)
+#define Z_SYSCLOCK_PRESCALER_VALUE 128
+#elif Z_SYSCLOCK_PRESCALER_FIT(256LU)
+#define Z_SYSCLOCK_PRESCALER_VALUE 256
+#elif Z_SYSCLOCK_PRESCALER_FIT(1024LU)
+#define Z_SYSCLOCK_PRESCALER_VALUE 1024
+#else
+#error "CONFIG_KERNEL_SYSCLOCK_PERIOD_US is too big for the selected timer"
+#endif
+
+/**
+ * @brief Value written to OCRnA, the timer counts from 0 to this value (included)
+ * during one sysclock period.
+ */
+#define Z_SYSCLOCK_COUNTER_VALUE Z_SYSCLOCK_CALC_COUNTER_VALUE(Z_SYSCLOCK_PRESCALER_VALUE)
+
+/**
+ * @brief Number of timer counts in one sysclock period.
+ */
+#define Z_SYSCLOCK_COUNTS_PER_TICK (Z_SYSCLOCK_COUNTER_VALUE + 1LU)
+
+/**
+ * @brief Convert a duration in microseconds to sysclock timer counts.
+ *
+ * All operands are constants, divisions by powers of two are resolved to shifts.
+ */
+#define Z_SYSCLOCK_US_TO_COUNTS(us)                                                      \
+	(((uint32_t)(us) * (F_CPU / 1000000LU)) / Z_SYSCLOCK_PRESCALER_VALUE)
+
+#endif /* _AVRTOS_SYSCLOCK_H_ */
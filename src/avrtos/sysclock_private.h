@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Sysclock hardware timer configuration and counter access, the timer
+ * parameters are computed in sysclock.h.
+ *
+ * Reserved to kernel code which needs to interpret the sysclock timer counter
+ * (e.g. sysclock initialization, high-resolution timers).
+ */
+
+#ifndef _AVRTOS_SYSCLOCK_PRIVATE_H_
+#define _AVRTOS_SYSCLOCK_PRIVATE_H_
+
+#include "defines.h"
+#include "drivers/timer.h"
+#include "sysclock.h"
+
+#if CONFIG_KERNEL_SYSLOCK_HW_TIMER >= TIMERS_COUNT
+#error "invalid CONFIG_KERNEL_SYSLOCK_HW_TIMER"
+#endif
+
+#if CONFIG_KERNEL_SYSLOCK_HW_TIMER == 2
+
+#if Z_SYSCLOCK_PRESCALER_VALUE == 1
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER2_PRESCALER_1
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 8
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER2_PRESCALER_8
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 32
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER2_PRESCALER_32
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 64
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER2_PRESCALER_64
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 128
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER2_PRESCALER_128
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 256
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER2_PRESCALER_256
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 1024
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER2_PRESCALER_1024
+#else
+#error "invalid Z_SYSCLOCK_PRESCALER_VALUE (timer 2)"
+#endif
+
+#else
+
+#if Z_SYSCLOCK_PRESCALER_VALUE == 1
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER_PRESCALER_1
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 8
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER_PRESCALER_8
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 64
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER_PRESCALER_64
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 256
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER_PRESCALER_256
+#elif Z_SYSCLOCK_PRESCALER_VALUE == 1024
+#define Z_SYSCLOCK_PRESCALER_CONFIG TIMER_PRESCALER_1024
+#else
+#error "invalid Z_SYSCLOCK_PRESCALER_VALUE (timers 1, 3, 4, 5)"
+#endif
+
+#endif /* CONFIG_KERNEL_SYSLOCK_HW_TIMER == 2 */
+
+#if !defined(__ASSEMBLER__)
+
+/**
+ * @brief Read the current value of the sysclock timer counter (TCNTn).
+ *
+ * @return Counter value, between 0 and Z_SYSCLOCK_COUNTER_VALUE.
+ */
+__always_inline uint16_t z_sysclock_get_counter(void)
+{
+#if TIMER_INDEX_IS_16BIT(CONFIG_KERNEL_SYSLOCK_HW_TIMER)
+	return ll_timer16_get_tcnt(timer_get_device(CONFIG_KERNEL_SYSLOCK_HW_TIMER));
+#else
+	return ((TIMER8_Device *)timer_get_device(CONFIG_KERNEL_SYSLOCK_HW_TIMER))->TCNTn;
+#endif
+}
+
+/**
+ * @brief Check whether the sysclock compare match occurred but the tick has not
+ * been accounted yet (i.e. interrupts are disabled).
+ */
+__always_inline bool z_sysclock_tick_pending(void)
+{
+	return (ll_timer_get_irq_flags(CONFIG_KERNEL_SYSLOCK_HW_TIMER) & BIT(OCFnA)) != 0u;
+}
+
+#endif /* !__ASSEMBLER__ */
+
+#endif /* _AVRTOS_SYSCLOCK_PRIVATE_H_ */
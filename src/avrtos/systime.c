@@ -9,36 +9,103 @@
 #include <avr/pgmspace.h>
 
 #include "mutex.h"
+#include "sysclock_private.h"
 
 #if CONFIG_KERNEL_UPTIME
 
-uint32_t k_uptime_get(void)
+/**
+ * @brief Divide a 64-bit value by a 16-bit value.
+ *
+ * Long division in base 2^16 where each step is a 32-bit division, avoids pulling
+ * the 64-bit division routine (__udivdi3) which is very slow on AVR.
+ *
+ * @param n Dividend.
+ * @param d Divisor, must not be 0.
+ * @param rem Pointer to store the remainder (can be NULL).
+ * @return Quotient.
+ */
+static uint64_t z_udiv64_u16(uint64_t n, uint16_t d, uint16_t *rem)
 {
-#if CONFIG_CONFIG_KERNEL_TICKS_COUNTER_40BITS
-	return k_ticks_get_64() / K_TICKS_PER_SECOND;
+	union {
+		uint64_t u64;
+		uint16_t u16[4u];
+	} v = {.u64 = n};
+	uint32_t r = 0u;
+
+	for (int8_t i = 3; i >= 0; i--) {
+		const uint32_t cur = (r << 16u) | v.u16[i];
+
+		v.u16[i] = cur / d;
+		r		 = cur % d;
+	}
+
+	if (rem != NULL) {
+		*rem = r;
+	}
+
+	return v.u64;
+}
+
+uint32_t k_ticks_to_ms_32(uint32_t ticks)
+{
+#if CONFIG_KERNEL_SYSCLOCK_PERIOD_US % USEC_PER_MSEC == 0
+	return ticks * (CONFIG_KERNEL_SYSCLOCK_PERIOD_US / USEC_PER_MSEC);
+#elif USEC_PER_MSEC % CONFIG_KERNEL_SYSCLOCK_PERIOD_US == 0
+	/* Power of two divisors are resolved to shifts */
+	return ticks / (USEC_PER_MSEC / CONFIG_KERNEL_SYSCLOCK_PERIOD_US);
 #else
-	return k_ticks_get_32() / K_TICKS_PER_SECOND;
-#endif /* CONFIG_KERNEL_UPTIME */
+	return (uint32_t)k_ticks_to_ms_64(ticks);
+#endif
 }
 
-uint32_t k_uptime_get_ms32(void)
+uint64_t k_ticks_to_ms_64(uint64_t ticks)
 {
-#if CONFIG_KERNEL_TICKS_COUNTER
-	return k_ticks_get_32() / K_TICKS_PER_MS;
+#if CONFIG_KERNEL_SYSCLOCK_PERIOD_US % USEC_PER_MSEC == 0
+	return ticks * (CONFIG_KERNEL_SYSCLOCK_PERIOD_US / USEC_PER_MSEC);
+#elif USEC_PER_MSEC % CONFIG_KERNEL_SYSCLOCK_PERIOD_US == 0
+	return z_udiv64_u16(ticks, USEC_PER_MSEC / CONFIG_KERNEL_SYSCLOCK_PERIOD_US, NULL);
 #else
-	return 0;
-#endif /* CONFIG_KERNEL_UPTIME */
+	return z_udiv64_u16(ticks * CONFIG_KERNEL_SYSCLOCK_PERIOD_US, USEC_PER_MSEC, NULL);
+#endif
+}
+
+uint32_t k_cycle_get_32(void)
+{
+	uint32_t ticks;
+	uint16_t cnt;
+
+	/* Retry if the tick interrupt occurred while reading the counter */
+	do {
+		ticks = k_ticks_get_32();
+		cnt	  = z_sysclock_get_counter();
+	} while (ticks != k_ticks_get_32());
+
+	/* Interrupts are disabled and the counter wrapped */
+	if (z_sysclock_tick_pending()) {
+		ticks++;
+		cnt = z_sysclock_get_counter();
+	}
+
+	return ticks * Z_SYSCLOCK_COUNTS_PER_TICK + cnt;
+}
+
+uint32_t k_uptime_get(void)
+{
+	return (uint32_t)z_udiv64_u16(k_uptime_get_ms64(), MSEC_PER_SEC, NULL);
+}
+
+uint32_t k_uptime_get_ms32(void)
+{
+	return k_ticks_to_ms_32(k_ticks_get_32());
 }
 
 uint64_t k_uptime_get_ms64(void)
 {
 #if CONFIG_CONFIG_KERNEL_TICKS_COUNTER_40BITS
-	return k_ticks_get_64() / K_TICKS_PER_MS;
-#elif CONFIG_KERNEL_TICKS_COUNTER
-	return k_ticks_get_32() / K_TICKS_PER_MS;
+	return k_ticks_to_ms_64(k_ticks_get_64());
 #else
-	return 0;
-#endif /* CONFIG_KERNEL_UPTIME */
+	return k_ticks_to_ms_64(k_ticks_get_32());
+#endif /* CONFIG_CONFIG_KERNEL_TICKS_COUNTER_40BITS */
 }
 
 void k_uptime_as_timespec_get(struct timespec *ts)
@@ -47,10 +114,7 @@ void k_uptime_as_timespec_get(struct timespec *ts)
 		return;
 	}
 
-	const uint64_t ms = k_uptime_get_ms64();
-
-	ts->tv_sec	= ms / 1000;
-	ts->tv_msec = ms % 1000;
+	ts->tv_sec = (uint32_t)z_udiv64_u16(k_uptime_get_ms64(), MSEC_PER_SEC, &ts->tv_msec);
 }
 
 void k_show_uptime(void)
@@ -119,7 +183,7 @@ void k_time_set(uint32_t sec)
 #if CONFIG_KERNEL_TIME_API_MS_PRECISION
 uint32_t k_time_get(void)
 {
-	return (uint32_t)(k_time_get_ms() / MSEC_PER_SEC);
+	return (uint32_t)z_udiv64_u16(k_time_get_ms(), MSEC_PER_SEC, NULL);
 }
 
 uint64_t k_time_get_ms(void)
@@ -24,6 +24,7 @@
 #define _AVRTOS_TIME_H_
 
 #include "kernel.h"
+#include "sysclock.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,7 +38,7 @@ extern "C" {
  * @brief Get the current system uptime in 32-bit ticks.
  *
  * This function returns the uptime in kernel ticks, represented as a 32-bit
- * value.
+ * value. The counter is read without masking interrupts.
  *
  * @return Kernel ticks value (32-bit).
  */
@@ -69,6 +70,64 @@ __always_inline uint32_t k_ticks_get(void)
  */
 __kernel uint64_t k_ticks_get_64(void);
 
+/**
+ * @brief Frequency of the cycle counter returned by `k_cycle_get_32()`, in Hz.
+ *
+ * The cycle counter runs at the frequency of the sysclock hardware timer
+ * (F_CPU divided by the sysclock timer prescaler).
+ */
+#define K_CYCLES_PER_SEC (F_CPU / Z_SYSCLOCK_PRESCALER_VALUE)
+
+/**
+ * @brief Number of cycles in one kernel tick.
+ */
+#define K_CYCLES_PER_TICK Z_SYSCLOCK_COUNTS_PER_TICK
+
+/**
+ * @brief Get a 32-bit cycle counter with sub-tick resolution.
+ *
+ * The value combines the tick counter with the counter of the sysclock hardware
+ * timer (TCNTn), it increments at `K_CYCLES_PER_SEC` and wraps around after
+ * 2^32 cycles. Meant for timestamping and measuring short durations.
+ *
+ * Can be called with interrupts disabled, a pending tick is accounted.
+ *
+ * @return Cycle counter value.
+ */
+__kernel uint32_t k_cycle_get_32(void);
+
+/**
+ * @brief Convert a number of ticks to milliseconds (32-bit).
+ *
+ * The conversion is resolved at compile time to a multiplication, a division by a
+ * constant or a 64-bit multiplication followed by a 16-bit long division, the
+ * 64-bit division routine of the compiler is never used.
+ *
+ * @param ticks Number of ticks.
+ * @return Duration in milliseconds.
+ */
+__kernel uint32_t k_ticks_to_ms_32(uint32_t ticks);
+
+/**
+ * @brief Convert a number of ticks to milliseconds (64-bit).
+ *
+ * @see k_ticks_to_ms_32
+ * @param ticks Number of ticks.
+ * @return Duration in milliseconds.
+ */
+__kernel uint64_t k_ticks_to_ms_64(uint64_t ticks);
+
+/**
+ * @brief Convert a number of ticks to microseconds (64-bit).
+ *
+ * @param ticks Number of ticks.
+ * @return Duration in microseconds.
+ */
+__always_inline uint64_t k_ticks_to_us_64(uint64_t ticks)
+{
+	return ticks * CONFIG_KERNEL_SYSCLOCK_PERIOD_US;
+}
+
 /**
  * @brief Get the current system uptime in milliseconds (32-bit).
  *
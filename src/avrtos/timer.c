@@ -119,6 +119,11 @@ bool k_timer_started(struct k_timer *timer)
 	return ret;
 }
 
+bool z_timers_scheduled(void)
+{
+	return z_timers_runqueue != NULL;
+}
+
 int8_t k_timer_stop(struct k_timer *timer)
 {
 	Z_ARGS_CHECK(timer) return -EINVAL;
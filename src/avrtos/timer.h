@@ -107,6 +107,13 @@ __kernel void z_timer_init_module(void);
  */
 __kernel void z_timers_process(void);
 
+/**
+ * @brief Check whether a timer is running, i.e. the tick is required.
+ *
+ * @return true if a timer is running, false otherwise.
+ */
+__kernel bool z_timers_scheduled(void);
+
 /**
  * @brief Start a timer.
  *
@@ -85,6 +85,20 @@ struct k_thread {
 	 */
 	uint8_t sched_lock_cnt;
 #endif /* CONFIG_KERNEL_REENTRANCY */
+
+#if CONFIG_KERNEL_THREAD_TIME_SLICE
+	/**
+	 * @brief Time slice budget of the thread, in number of kernel time slices
+	 * (CONFIG_KERNEL_TIME_SLICE_US), 0 is equivalent to 1.
+	 */
+	uint8_t time_slice;
+
+	/**
+	 * @brief Number of kernel time slices remaining before the thread can be
+	 * preempted, reloaded with `time_slice` when the thread is scheduled.
+	 */
+	uint8_t slice_remaining;
+#endif /* CONFIG_KERNEL_THREAD_TIME_SLICE */
 };
 
 /**
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "watchdog.h"
+
+#include <avr/wdt.h>
+
+#include "kernel_private.h"
+
+#define K_MODULE K_MODULE_WATCHDOG
+
+#if CONFIG_KERNEL_WATCHDOG
+
+/* Distinguish a valid record from random RAM content after a power-on */
+#define Z_WATCHDOG_RECORD_MAGIC 0xD06Bu
+
+struct z_watchdog_noinit {
+	uint16_t magic;
+	struct k_watchdog_record record;
+};
+
+__noinit struct z_watchdog_noinit z_wdt_noinit;
+
+static struct k_watchdog_channel *z_wdt_channels = NULL;
+
+/* Set once a channel expired, the hardware watchdog is then never reset again */
+static bool z_wdt_expired = false;
+
+void z_watchdog_init(void)
+{
+	wdt_enable(CONFIG_KERNEL_WATCHDOG_TIMEOUT);
+}
+
+void z_watchdog_process(void)
+{
+	if (z_wdt_expired) {
+		return;
+	}
+
+	for (struct k_watchdog_channel *ch = z_wdt_channels; ch != NULL; ch = ch->next) {
+		if (ch->remaining > Z_KERNEL_TIME_SLICE_TICKS) {
+			ch->remaining -= Z_KERNEL_TIME_SLICE_TICKS;
+		} else {
+			z_wdt_noinit.magic		   = Z_WATCHDOG_RECORD_MAGIC;
+			z_wdt_noinit.record.thread = ch->thread;
+			z_wdt_noinit.record.symbol = ch->thread->symbol;
+			z_wdt_expired			   = true;
+			return;
+		}
+	}
+
+	wdt_reset();
+}
+
+int8_t k_watchdog_register(struct k_watchdog_channel *channel, k_timeout_t timeout)
+{
+	Z_ARGS_CHECK(channel && K_TIMEOUT_TICKS(timeout)) return -EINVAL;
+	Z_ARGS_CHECK(!K_TIMEOUT_EQ(timeout, K_FOREVER)) return -EINVAL;
+
+	int8_t ret		  = 0;
+	const uint8_t key = irq_lock();
+
+	/* Linking the channel twice would loop the list */
+	for (struct k_watchdog_channel *ch = z_wdt_channels; ch != NULL; ch = ch->next) {
+		if (ch == channel) {
+			ret = -EALREADY;
+			goto exit;
+		}
+	}
+
+	channel->thread	   = z_ker.current;
+	channel->timeout   = K_TIMEOUT_TICKS(timeout);
+	channel->remaining = channel->timeout;
+	channel->next	   = z_wdt_channels;
+	z_wdt_channels	   = channel;
+
+exit:
+	irq_unlock(key);
+
+	return ret;
+}
+
+int8_t k_watchdog_unregister(struct k_watchdog_channel *channel)
+{
+	int8_t ret		  = -ENOENT;
+	const uint8_t key = irq_lock();
+
+	struct k_watchdog_channel **pp = &z_wdt_channels;
+	while (*pp != NULL) {
+		if (*pp == channel) {
+			*pp = channel->next;
+			ret = 0;
+			break;
+		}
+		pp = &(*pp)->next;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+void k_watchdog_feed(struct k_watchdog_channel *channel)
+{
+	const uint8_t key  = irq_lock();
+	channel->remaining = channel->timeout;
+	irq_unlock(key);
+}
+
+bool k_watchdog_last_expired(struct k_watchdog_record *record)
+{
+	const bool valid = z_wdt_noinit.magic == Z_WATCHDOG_RECORD_MAGIC;
+
+	if (valid && (record != NULL)) {
+		*record = z_wdt_noinit.record;
+	}
+
+	z_wdt_noinit.magic = 0u;
+
+	return valid;
+}
+
+#endif /* CONFIG_KERNEL_WATCHDOG */
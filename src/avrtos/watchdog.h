@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024 Lucas Dietrich <ld.adecy@gmail.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Watchdog Service
+ *
+ * Threads register a watchdog channel with their own timeout and check in
+ * periodically with k_watchdog_feed(). The hardware watchdog (WDT) is enabled at
+ * kernel initialization and reset from the tick handler only while every
+ * registered channel has been fed within its timeout, a thread which hangs
+ * (or is starved) is then detected even if the other threads keep running.
+ *
+ * When a channel expires, the hardware watchdog is no longer reset and the
+ * channel is recorded in the .noinit section, which survives the watchdog reset.
+ * The application can retrieve it after the reset with k_watchdog_last_expired().
+ *
+ * A hang with interrupts disabled stops the tick handler, the hardware watchdog
+ * resets the MCU as well (without record).
+ *
+ * Related configuration options:
+ *  - CONFIG_KERNEL_WATCHDOG: Enables the watchdog service.
+ *  - CONFIG_KERNEL_WATCHDOG_TIMEOUT: Timeout of the hardware watchdog.
+ */
+
+#ifndef _AVRTOS_WATCHDOG_H_
+#define _AVRTOS_WATCHDOG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "kernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Watchdog channel structure.
+ */
+struct k_watchdog_channel {
+	struct k_watchdog_channel *next; ///< Next registered channel.
+	struct k_thread *thread;		 ///< Thread which registered the channel.
+	k_ticks_t timeout;				 ///< Maximum time between two check-ins.
+	k_ticks_t remaining;			 ///< Ticks remaining before the channel expires.
+};
+
+/**
+ * @brief Record of the channel which expired before the last watchdog reset.
+ */
+struct k_watchdog_record {
+	struct k_thread *thread; ///< Thread of the expired channel.
+	char symbol;			 ///< Symbol of the thread.
+};
+
+/**
+ * @brief Register a watchdog channel for the current thread.
+ *
+ * The channel is fed on registration.
+ *
+ * @param channel Channel to register, must remain valid until unregistered.
+ * @param timeout Maximum time between two calls to `k_watchdog_feed()`.
+ * @return 0 on success, -EALREADY if the channel is already registered, -EINVAL
+ * on invalid arguments.
+ */
+__kernel int8_t k_watchdog_register(struct k_watchdog_channel *channel,
+									k_timeout_t timeout);
+
+/**
+ * @brief Unregister a watchdog channel.
+ *
+ * @param channel Channel to unregister.
+ * @return 0 on success, -ENOENT if the channel is not registered.
+ */
+__kernel int8_t k_watchdog_unregister(struct k_watchdog_channel *channel);
+
+/**
+ * @brief Check in a watchdog channel, restarting its timeout.
+ *
+ * Safety: This function is safe to call from an ISR context.
+ *
+ * @param channel Registered channel.
+ */
+__kernel void k_watchdog_feed(struct k_watchdog_channel *channel);
+
+/**
+ * @brief Get the channel which expired before the last reset, if any.
+ *
+ * The record is cleared, it should be retrieved once after each reset.
+ *
+ * @param record Record of the expired channel.
+ * @return true if a channel expired before the last reset, false otherwise.
+ */
+__kernel bool k_watchdog_last_expired(struct k_watchdog_record *record);
+
+/**
+ * @brief Enable the hardware watchdog, called at kernel initialization.
+ */
+void z_watchdog_init(void);
+
+/**
+ * @brief Check the registered channels and reset the hardware watchdog if none
+ * expired, called from the tick handler.
+ *
+ * Assumptions: The interrupt flag is cleared when called.
+ */
+__kernel void z_watchdog_process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AVRTOS_WATCHDOG_H_ */